@@ -0,0 +1,116 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+
+#include "mathtools/mathtools.h"
+
+// This .cpp file benchmarks a Gaussian stimulus update, output = amplitude * circularGauss + input, once
+// composed from vectors as mathtools did before expression templates and once as a single expression.
+// The vector composition allocates 4 temporaries and makes 5 passes, the expression allocates nothing
+// and makes 1 pass. Allocations are counted by replacing the global operator new.
+
+namespace
+{
+	std::atomic<long long> allocations = 0;
+
+	// the previous mathtools::circularGauss, one temporary per intermediate
+	std::vector<double> circularGaussWithTemporaries(uint32_t size, double sigma, double position)
+	{
+		const uint32_t l = size;
+		const double positionShifted = std::fmod(position - 1.0, static_cast<double>(l)) + 1.0;
+
+		std::vector<double> g(size);
+		std::vector<double> xRange(size);
+		std::iota(xRange.begin(), xRange.end(), 1.0);
+		std::vector<double> d(size);
+		std::vector<double> lMinusd(size);
+		std::transform(xRange.begin(), xRange.end(), d.begin(), [&](double element) { return std::abs(element - positionShifted); });
+		std::transform(d.begin(), d.end(), lMinusd.begin(), [&](double element) { return -1 * (element - l); });
+		for (uint32_t i = 0; i < size; i++)
+			g[i] = std::exp(-0.5 * std::pow(std::min(d[i], lMinusd[i]), 2) / std::pow(sigma, 2));
+		return g;
+	}
+
+	struct Result
+	{
+		double nanoseconds;
+		double allocationsPerUpdate;
+	};
+
+	template<typename Update>
+	Result measure(int steps, Update update)
+	{
+		update(0);
+		const long long allocationsBefore = allocations.load();
+		const auto start = std::chrono::steady_clock::now();
+		for (int i = 0; i < steps; i++)
+			update(i);
+		const auto end = std::chrono::steady_clock::now();
+		return { std::chrono::duration<double, std::nano>(end - start).count() / steps,
+			static_cast<double>(allocations.load() - allocationsBefore) / steps };
+	}
+}
+
+void* operator new(std::size_t size)
+{
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	if (void* pointer = std::malloc(size))
+		return pointer;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept
+{
+	std::free(pointer);
+}
+
+void operator delete(void* pointer, std::size_t) noexcept
+{
+	std::free(pointer);
+}
+
+int main(int argc, char* argv[])
+{
+	using namespace dnf_composer::mathtools;
+	constexpr double amplitude = 8.0, sigma = 5.0;
+
+	std::cout << std::setw(10) << "size" << std::setw(16) << "vectors [us]" << std::setw(19) << "expression [us]"
+		<< std::setw(10) << "speedup" << std::setw(20) << "allocations/update" << std::endl;
+
+	for (int size = 1 << 8; size <= 1 << 20; size <<= 2)
+	{
+		const int steps = std::max(20, (1 << 24) / size);
+		const std::vector<double> input(size, 0.5);
+		std::vector<double> output(size);
+
+		const Result vectors = measure(steps, [&](int i)
+			{
+				const std::vector<double> g = circularGaussWithTemporaries(size, sigma, i % size);
+				for (int j = 0; j < size; j++)
+					output[j] = amplitude * g[j];
+				for (int j = 0; j < size; j++)
+					output[j] += input[j];
+			});
+		const Result expression = measure(steps, [&](int i)
+			{
+				using namespace expressions;
+				evaluate(amplitude * circularGaussExpression<double>(size, sigma, i % size) + view(input), output);
+			});
+
+		std::cout << std::setw(10) << size
+			<< std::setw(16) << std::fixed << std::setprecision(1) << vectors.nanoseconds / 1e3
+			<< std::setw(19) << expression.nanoseconds / 1e3
+			<< std::setw(10) << std::setprecision(2) << vectors.nanoseconds / expression.nanoseconds
+			<< std::setw(11) << std::setprecision(0) << vectors.allocationsPerUpdate << " -> " << expression.allocationsPerUpdate << std::endl;
+	}
+
+	std::cout << "Passes over the field per update: 5 with vectors, 1 with the expression." << std::endl;
+	return 0;
+}
@@ -1,31 +1,110 @@
 #pragma once
 
 #include <vector>
+#include <deque>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <set>
 #include <memory>
+#include <mutex>
+#include <atomic>
 #include <ranges>
 #include <algorithm>
+#include <cstdint>
 
 #include "exceptions/exception.h"
 #include "element_parameters.h"
 #include "logging/logger.h"
+#include "utilities/utilities.h"
 
 namespace dnf_composer
 {
 
 	namespace element
 	{
+		class Element;
+
+		// A component of another element summed into the input of an element, scaled by gain.
+		// With a delay of d > 0 the component is read as it was at the end of the step d steps back.
+		struct InputConnection
+		{
+			std::shared_ptr<Element> element;
+			std::string component;
+			double gain = 1.0;
+			int delay = 0;
+		};
+
+		// Past values of a component, kept for its delayed input connections. frames[d - 1] holds the values of
+		// d steps back. Recording rotates the frames and overwrites the oldest, so no frame is allocated after
+		// the line is reserved and every frame keeps its address: resolved inputs point at them for good.
+		class DelayLine
+		{
+		private:
+			std::deque<std::vector<double>> frames;
+			// Delays of the connections reading the line, the longest one sets its length.
+			std::multiset<int> readers;
+		public:
+			// Registers a reader of delay and grows the line to hold its frames, new frames start at the current values.
+			void reserve(int delay, const std::vector<double>& current);
+			// Unregisters a reader of delay and drops the frames only it read. Returns whether readers remain.
+			bool release(int delay);
+			// Keeps the frames but forgets the readers, for the copy of an element that has no consumers yet.
+			void forgetReaders();
+			void record(const std::vector<double>& current);
+			// Fills every frame with the current values, as if the component had been constant.
+			void reset(const std::vector<double>& current);
+			const std::vector<double>& frame(int delay) const;
+			int getMaxDelay() const;
+		};
+
+		// An input connection resolved to the buffer it reads.
+		struct ResolvedInput
+		{
+			const std::vector<double>* values = nullptr;
+			double gain = 1.0;
+		};
+
+		// Shared by a simulation and its elements, so that edits made directly on the elements reach the simulation
+		// without it polling every element each step.
+		struct ArchitectureRevisions
+		{
+			// connections added or removed and kernel data replaced: kernel batches and plan are rebuilt
+			std::atomic<uint64_t> structure = 0;
+			// input gains changed: the gains are copied into the plan
+			std::atomic<uint64_t> gains = 0;
+		};
+
 		class Element
 		{
 		protected:
 			ElementCommonParameters commonParameters;
 			std::unordered_map<std::string, std::vector<double>> components;
-			std::unordered_map<std::shared_ptr<Element>, std::string> inputs;
+			// In the order they were added, which is the order they are summed in.
+			std::vector<InputConnection> inputs;
+			// Reverse adjacency of inputs: elements that currently have this element as input.
+			// Kept as raw pointers, a consumer holds a shared_ptr to this element and unregisters on destruction.
+			std::unordered_set<Element*> consumers;
+			// Guards consumers and the reservation of delayLines by consumers. Clones connected in other
+			// threads may share this element as input when it was not cloned with them.
+			mutable std::mutex wiringMutex;
+			// Incremented whenever an input is added, removed or changes its gain, so resolved inputs know when to be rebuilt.
+			uint64_t inputsRevision = 0;
+			// Of the simulation the element belongs to, nullptr outside of one.
+			std::shared_ptr<ArchitectureRevisions> architectureRevisions;
+			// Time of the simulation the element is initialized at: tZero, or the current time for elements added later.
+			double initTime = 0.0;
+			// Components read by delayed input connections of consumers, sized by the longest delay.
+			std::unordered_map<std::string, DelayLine> delayLines;
+		private:
+			std::vector<ResolvedInput> resolvedInputs;
+			uint64_t resolvedInputsRevision = UINT64_MAX;
+
+			void addConsumer(Element* consumer, const std::string& component, int delay);
+			void removeConsumer(Element* consumer, const std::string& component, int delay);
 		public:
 			Element(const ElementCommonParameters& parameters);
 
-			Element(const Element&) = delete;
 			Element& operator=(const Element&) = delete;
 			Element(Element&&) = delete;
 			Element& operator=(Element&&) = delete;
@@ -35,12 +114,31 @@ namespace dnf_composer
 			virtual void close() = 0;
 			virtual void printParameters() = 0;
 
-			void addInput(const std::shared_ptr<Element>& inputElement, const std::string& inputComponent = "output");
-			void removeInput(const std::string& inputElementId);
-			void removeInput(int uniqueId);
+			// Deep copy of the parameters and components, without inputs.
+			// Elements that do not override it cannot be cloned and return nullptr.
+			virtual std::shared_ptr<Element> clone() const;
+			void copyInputs(const Element& original, const std::unordered_map<const Element*, std::shared_ptr<Element>>& clones);
+
+			// Binary state used by Simulation checkpoints. Derived elements write their
+			// parameters and internal state before calling the base implementation.
+			virtual void writeState(std::ostream& stream) const;
+			virtual void readState(std::istream& stream);
+
+			void addInput(const std::shared_ptr<Element>& inputElement, const std::string& inputComponent = "output", double gain = 1.0, int delay = 0);
+			// false if there is no input from that element
+			bool removeInput(const std::string& inputElementId);
+			bool removeInput(int uniqueId);
 			bool hasInput(const std::string& inputElementName, const std::string& inputComponent);
 			bool hasInput(int inputElementId, const std::string& inputComponent);
+			// Changes the gain of an existing input in place, false if there is no input of that name.
+			bool setInputGain(const std::string& inputElementName, double gain);
 			void updateInput();
+			// Delay lines advance once per step, after every element of the simulation stepped (see Simulation::step).
+			void recordDelayLines();
+			void resetDelayLines();
+			bool hasDelayLines() const;
+			// nullptr if no consumer reads the component delayed.
+			const DelayLine* getDelayLine(const std::string& componentName) const;
 
 			int getMaxSpatialDimension() const;
 			int getSize() const;
@@ -50,16 +148,30 @@ namespace dnf_composer
 			std::string getUniqueName() const;
 			ElementLabel getLabel() const;
 
-			std::vector<double> getComponent(const std::string& componentName);
-			std::vector<double>* getComponentPtr(const std::string& componentName);
+			virtual std::vector<double> getComponent(const std::string& componentName);
+			virtual std::vector<double>* getComponentPtr(const std::string& componentName);
 			std::vector<std::string> getComponentList() const;
 
 			std::vector < std::shared_ptr<Element>> getInputs();
+			// Input elements with the component of each that is read and its gain, in summation order.
+			const std::vector<InputConnection>& getInputConnections() const;
+			std::vector<Element*> getConsumers() const;
+			// Set by the simulation the element is added to, which then notices edits made directly on the element.
+			void setArchitectureRevisions(std::shared_ptr<ArchitectureRevisions> revisions);
+			// Set by the simulation before it calls init().
+			void setInitTime(double t);
 
-			virtual ~Element() = default;
+			virtual ~Element();
 
 		protected:
+			Element(const Element& other);
+
 			void printCommonParameters() const;
+			void markStructureChanged() const;
+			void markGainsChanged() const;
+			// Components read from the inputs, in the order updateInput sums them. Only rebuilt after the inputs
+			// change, so elements stepping without updateInput avoid the component lookups of every step.
+			const std::vector<ResolvedInput>& getResolvedInputs();
 		};
 	}
 }
\ No newline at end of file
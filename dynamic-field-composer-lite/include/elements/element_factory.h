@@ -10,6 +10,9 @@
 #include "normal_noise.h"
 #include "gauss_field_coupling.h"
 #include "field_coupling.h"
+#include "memory_trace.h"
+#include "moving_gauss_stimulus.h"
+#include "external_input.h"
 
 namespace dnf_composer
 {
@@ -24,6 +27,9 @@ namespace dnf_composer
 	        NormalNoiseParameters nnp;
 	        GaussFieldCouplingParameters gfcp;
 			FieldCouplingParameters fcp;
+			MemoryTraceParameters mtp;
+			MovingGaussStimulusParameters mgsp;
+			ExternalInputParameters eip;
 
 			CompoundElementParameters() = default;
 	    };
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <map>
+#include <atomic>
 #include <string>
 #include <format>
 
@@ -19,7 +20,10 @@ namespace dnf_composer
 			MEXICAN_HAT_KERNEL,
 			NORMAL_NOISE,
 			FIELD_COUPLING,
-			GAUSS_FIELD_COUPLING
+			GAUSS_FIELD_COUPLING,
+			MEMORY_TRACE,
+			MOVING_GAUSS_STIMULUS,
+			EXTERNAL_INPUT
 		};
 
 		inline const std::map<ElementLabel, std::string> ElementLabelToString = {
@@ -30,6 +34,9 @@ namespace dnf_composer
 			{GAUSS_KERNEL, "gauss kernel" },
 			{MEXICAN_HAT_KERNEL, "mexican hat kernel" },
 			{NORMAL_NOISE, "normal noise" },
+			{MEMORY_TRACE, "memory trace" },
+			{MOVING_GAUSS_STIMULUS, "moving gauss stimulus" },
+			{EXTERNAL_INPUT, "external input" },
 		};
 
 		struct ElementSpatialDimensionParameters
@@ -43,7 +50,7 @@ namespace dnf_composer
 
 		struct ElementIdentifiers
 		{
-			static inline int uniqueIdentifierCounter = 0;
+			static inline std::atomic<int> uniqueIdentifierCounter = 0;
 			int uniqueIdentifier;
 			std::string uniqueName;
 			ElementLabel label;
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <limits>
+#include <span>
+
+#include "element.h"
+
+
+namespace dnf_composer
+{
+	namespace element
+	{
+		enum class ExternalInputPolicy : int
+		{
+			LATEST,      // newest frame available at the step, older ones are dropped
+			HOLD,        // one frame per step in the order they were published, none dropped
+			INTERPOLATE  // linear interpolation at the step time between the two frames around it
+		};
+
+		struct ExternalInputParameters
+		{
+			ExternalInputPolicy policy = ExternalInputPolicy::LATEST;
+			// frames the producer can publish ahead of the simulation
+			int capacity = 4;
+
+			bool operator==(const ExternalInputParameters& other) const
+			{
+				return policy == other.policy && capacity == other.capacity;
+			}
+		};
+
+		// Per-step view of how fresh the output is, read from the simulation thread.
+		struct ExternalInputStatistics
+		{
+			uint64_t framesReceived = 0;
+			// skipped because a newer frame was taken in the same step
+			uint64_t framesDropped = 0;
+			// publishing attempts that found every frame of the queue taken
+			uint64_t framesRejected = 0;
+			// consecutive steps up to the last one that took no frame
+			uint64_t stepsWithoutFrame = 0;
+			// step time minus the timestamp of the newest frame taken, infinite before the first frame
+			double age = std::numeric_limits<double>::infinity();
+			// frames waiting for the next step
+			int queuedFrames = 0;
+		};
+
+		// Output written by a producer thread, e.g. camera or proprioceptive data of a robot. Frames go through
+		// a lock-free single-producer single-consumer queue of preallocated buffers: the producer writes into a
+		// buffer in place (acquireFrame/commitFrame) and the step swaps the buffers it takes with the output,
+		// so no values are copied on either side. Timestamps are in simulation time.
+		// Only one thread may publish, elements fed by several producers are summed by their consumers.
+		class ExternalInput : public Element
+		{
+		private:
+			struct Frame
+			{
+				std::vector<double> values;
+				double timestamp = 0.0;
+			};
+
+			ExternalInputParameters parameters;
+			std::vector<Frame> queue;
+			// Frames published and taken since construction, a frame sits at index % capacity. The producer
+			// only writes writeIndex and the simulation only writes readIndex.
+			alignas(64) std::atomic<uint64_t> writeIndex = 0;
+			alignas(64) std::atomic<uint64_t> readIndex = 0;
+			alignas(64) std::atomic<uint64_t> framesRejected = 0;
+			// frames bracketing the step time, for INTERPOLATE
+			Frame previousFrame, nextFrame;
+			bool hasPreviousFrame = false, hasNextFrame = false;
+			double newestTimestamp = 0.0;
+			ExternalInputStatistics statistics;
+		public:
+			ExternalInput(const ElementCommonParameters& elementCommonParameters, const ExternalInputParameters& parameters = {});
+			// The copy holds the current output, but has an empty queue of its own.
+			ExternalInput(const ExternalInput& other);
+
+			void init() override;
+			void step(double t, double deltaT) override;
+			void close() override {}
+
+			void printParameters() override;
+
+			std::shared_ptr<Element> clone() const override;
+			void writeState(std::ostream& stream) const override;
+			void readState(std::istream& stream) override;
+
+			// Producer side. Buffer of size getSize() to fill for the next frame, nullptr if the queue is full.
+			// Call again after each commit, the buffer of a frame changes once the simulation took it.
+			double* acquireFrame();
+			void commitFrame(double timestamp);
+			// Copies the values into the next frame, false if the queue is full or the size does not match.
+			bool publish(std::span<const double> values, double timestamp);
+
+			ExternalInputParameters getParameters() const;
+			ExternalInputStatistics getStatistics() const;
+
+			~ExternalInput() override = default;
+		private:
+			// Swaps the buffer of the queued frame with the destination, which hands the old buffer back to the producer.
+			double takeFrame(uint64_t index, std::vector<double>& destination);
+			void interpolate(double t);
+		};
+	}
+}
@@ -16,6 +16,13 @@ namespace dnf_composer
 		DELTA_KROGH_HERTZ
 	};
 
+	enum class WeightStorage
+	{
+		DENSE = 0,
+		SPARSE,
+		LOW_RANK
+	};
+
 	namespace element
 	{
 		struct FieldCouplingParameters
@@ -24,6 +31,23 @@ namespace dnf_composer
 			double scalar;
 			double learningRate;
 			LearningRule learningRule;
+			WeightStorage weightStorage = WeightStorage::DENSE;
+			double pruningThreshold = 0.0;
+			int maxWeightsPerOutput = 0;
+			int maxRank = 8;
+		};
+
+		struct SparsityStatistics
+		{
+			int numberOfNonZeros = 0;
+			double density = 1.0;
+			double relativeError = 0.0; // ||W - W_sparse||_F / ||W||_F
+		};
+
+		struct LowRankStatistics
+		{
+			int rank = 0;
+			double relativeError = 0.0; // ||W - W_r||_F / ||W||_F of the last truncation
 		};
 
 		class FieldCoupling : public Element
@@ -31,7 +55,13 @@ namespace dnf_composer
 		protected:
 			FieldCouplingParameters parameters;
 			std::vector<std::vector<double>> weights;
+			mathtools::SparseMatrix<double> sparseWeights;
+			SparsityStatistics sparsityStatistics;
+			mathtools::LowRankMatrix<double> lowRankWeights;
+			LowRankStatistics lowRankStatistics;
 			bool trained;
+			// updated since the weights were last saved or read
+			bool unsavedWeights;
 			bool updateAllWeights;
 			std::string weightsFilePath;
 		public:
@@ -43,16 +73,31 @@ namespace dnf_composer
 
 			void printParameters() override;
 
+			std::shared_ptr<Element> clone() const override;
+			void writeState(std::ostream& stream) const override;
+			void readState(std::istream& stream) override;
+
 			void setWeightsFilePath(const std::string& filePath);
 			bool readWeights();
 			void resetWeights();
-			void saveWeights() const;
+			void saveWeights();
+			// Updates the weights in memory only, call saveWeights() once learning is done. The first update
+			// after the weights were saved or read is logged.
 			virtual void updateWeights(const std::vector<double>& input, const std::vector<double>& output);
 
 			void setLearningRate(double learningRate);
 			void setUpdateAllWeights(bool updateAllWeights);
+			void setWeightStorage(WeightStorage weightStorage, double pruningThreshold = 0.0, int maxWeightsPerOutput = 0);
+			void setMaxRank(int maxRank);
 
+			// The dense matrix, only kept with dense storage (empty otherwise).
 			const std::vector<std::vector<double>>& getWeights() const;
+			// Dense copy of the weights in any storage, built from the sparse matrix or the factors if needed.
+			std::vector<std::vector<double>> reconstructWeights() const;
+			const mathtools::SparseMatrix<double>& getSparseWeights() const;
+			SparsityStatistics getSparsityStatistics() const;
+			const mathtools::LowRankMatrix<double>& getLowRankWeights() const;
+			LowRankStatistics getLowRankStatistics() const;
 
 			~FieldCoupling() override = default;
 
@@ -60,6 +105,13 @@ namespace dnf_composer
 			void getInputFunction();
 			void computeOutput();
 			void scaleOutput();
+			void updateWeightStorage();
+			// Prunes the dense matrix into the sparse one, which replaces it as the master copy.
+			void pruneWeights();
+			void updateSparseWeights(const std::vector<double>& input, const std::vector<double>& output);
+			void factorizeWeights();
+			void updateLowRankWeights(const std::vector<double>& input, const std::vector<double>& output);
+			int getEffectiveMaxRank() const;
 
 			void writeWeights() const;
 		};
@@ -39,6 +39,10 @@ namespace dnf_composer
 			void close() override;
 			void printParameters() override;
 
+			std::shared_ptr<Element> clone() const override;
+			void writeState(std::ostream& stream) const override;
+			void readState(std::istream& stream) override;
+
 			GaussFieldCouplingParameters getParameters() const;
 
 			~GaussFieldCoupling() override = default;
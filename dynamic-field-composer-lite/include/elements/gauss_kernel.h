@@ -30,6 +30,8 @@ namespace dnf_composer
 		{
 		private:
 			GaussKernelParameters parameters;
+		protected:
+			void writeOutput(const std::vector<double>& convolution) override;
 		public:
 			GaussKernel(const ElementCommonParameters& elementCommonParameters, const GaussKernelParameters& parameters);
 
@@ -39,6 +41,10 @@ namespace dnf_composer
 
 			void printParameters() override;
 
+			std::shared_ptr<Element> clone() const override;
+			void writeState(std::ostream& stream) const override;
+			void readState(std::istream& stream) override;
+
 			void setParameters(const GaussKernelParameters& gk_parameters);
 			GaussKernelParameters getParameters() const;
 
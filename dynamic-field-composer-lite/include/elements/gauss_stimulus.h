@@ -44,9 +44,17 @@ namespace dnf_composer
 
 			void printParameters() override;
 
+			std::shared_ptr<Element> clone() const override;
+			void writeState(std::ostream& stream) const override;
+			void readState(std::istream& stream) override;
+
 			void setParameters(const GaussStimulusParameters& parameters);
 			GaussStimulusParameters getParameters() const;
+			void setPosition(double position);
+			void setAmplitude(double amplitude);
 			~GaussStimulus() override = default;
+		private:
+			void updateOutput();
 		};
 	}
 }
@@ -1,29 +1,97 @@
 #pragma once
 
 #include "element.h"
+#include "mathtools/mathtools.h"
+#include "kernel_cache.h"
 #include <array>
+#include <span>
 
 namespace dnf_composer
 {
 	namespace element
 	{
+		enum class ConvolutionMethod
+		{
+			DIRECT,		// truncated kernel, cost grows with sigma
+			RECURSIVE	// cascade of running-sum box filters, constant cost per bin (circular kernels only)
+		};
+
+		struct KernelBatch;
+
 		class Kernel : public Element
 		{
 		protected:
+			ConvolutionMethod convolutionMethod = ConvolutionMethod::DIRECT;
 			bool circular;
-			bool normalized;
+			bool borderCompensation;
 			std::array<int, 2> kernelRange;
-			std::vector<int> extIndex;
+			// range and weights, shared with every kernel of equal parameters
+			std::shared_ptr<const KernelData> kernelData;
+			// the "kernel" component only holds a copy of the shared weights once it has been requested
+			bool kernelComponentRequested = false;
 			double fullSum = 0.0;
 			int cutOfFactor = 5;
 		public:
 			Kernel(const ElementCommonParameters& elementCommonParameters);
 			~Kernel() override = default;
 
+			std::vector<double> getComponent(const std::string& componentName) override;
+			std::vector<double>* getComponentPtr(const std::string& componentName) override;
+			void readState(std::istream& stream) override;
+
 			std::array<int, 2> getKernelRange() const;
-			std::vector<int> getExtIndex() const;
+			std::shared_ptr<const KernelData> getKernelData() const;
+			// For comparisons, without the reference counting of a shared_ptr copy.
+			const KernelData* getKernelDataPtr() const;
 			bool getCircular() const;
-			bool getNormalized() const;
+			bool getBorderCompensation() const;
+			// Both re-initialize the kernel. Non-circular kernels treat the field as zero padded, with border compensation
+			// they divide the result at each position by the share of the kernel weights that lies inside the field.
+			// Circular kernels have no borders, the compensation has no effect on them.
+			void setCircular(bool circular);
+			void setBorderCompensation(bool borderCompensation);
+
+			void setConvolutionMethod(ConvolutionMethod method);
+			ConvolutionMethod getConvolutionMethod() const;
+
+			// True if the kernel uses the direct convolution, the only kind stepBatch can run.
+			bool isBatchable() const;
+			// Steps kernels that share the same KernelData with one direct convolution vectorized across them.
+			// The outputs are identical to stepping each kernel on its own.
+			static void stepBatch(KernelBatch& batch);
+			// Direct convolution step with the inputs resolved ahead of time, see ExecutionPlan. Each entry of
+			// inputValues holds getSize() values. Returns false without a step if the kernel is not batchable.
+			bool stepResolved(std::vector<double>& input, std::span<const ResolvedInput> inputValues);
+		protected:
+			// Gathers the input of the kernel and its sum.
+			void updateKernelInput();
+			void sumResolvedInputs(std::vector<double>& input, std::span<const ResolvedInput> inputValues);
+			// Turns the convolved input into the output of the kernel.
+			virtual void writeOutput(const std::vector<double>& convolution) = 0;
+			// Looks the kernel data up in the KernelCache, building it from the given Gaussians if needed.
+			// Each Gaussian is {sigma, amplitude}, the weights are the amplitude weighted sum of the normalized Gaussians.
+			void acquireKernelData(double rangeSigma, const std::vector<std::array<double, 2>>& gaussians);
+			bool usesRecursiveConvolution() const;
+			// Copies the shared weights into the "kernel" component if it was requested, empties it otherwise.
+			void updateKernelComponent();
+			// Direct convolution of the input with the kernel weights for the boundary mode of the kernel.
+			std::vector<double> directConvolution(const std::vector<double>& input) const;
+			// amplitude * normalized Gaussian convolved circularly with the input
+			std::vector<double> recursiveGaussConvolution(double sigma, double amplitude);
+		};
+
+		// Kernels stepped together, with the buffers reused across steps.
+		struct KernelBatch
+		{
+			std::shared_ptr<const KernelData> data;
+			std::vector<Kernel*> kernels;
+			std::vector<double> input;			// one row per field position and one column per kernel
+			std::vector<double> convolution;	// same layout as the input
+			std::vector<double> column;
+			// Input buffers and sources of each kernel, resolved by an ExecutionPlan. Empty if the inputs are gathered
+			// through Element::updateInput.
+			std::vector<std::vector<double>*> resolvedInput;
+			std::vector<std::vector<ResolvedInput>> resolvedInputValues;
 		};
 	}
 
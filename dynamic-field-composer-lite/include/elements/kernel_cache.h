@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <functional>
+#include <unordered_map>
+
+#include "element_parameters.h"
+
+namespace dnf_composer
+{
+	namespace element
+	{
+		// Immutable data of an initialized kernel, shared by every kernel with the same key.
+		struct KernelData
+		{
+			std::array<int, 2> kernelRange = { 0, 0 };
+			std::vector<double> weights;
+			// per position factor of non-circular kernels with border compensation, empty otherwise
+			std::vector<double> borderScale;
+		};
+
+		struct KernelCacheKey
+		{
+			ElementLabel label = UNINITIALIZED;
+			std::vector<double> parameters;	// sigmas and amplitudes that shape the weights
+			int size = 0;
+			bool circular = true;
+			bool borderCompensation = false;
+			int cutOfFactor = 0;
+
+			bool operator==(const KernelCacheKey& other) const = default;
+		};
+
+		// Process-wide repository of kernel data. Entries are held weakly, so the data lives as long as a kernel
+		// uses it and re-initializing a kernel with unchanged parameters is a lookup. Thread-safe.
+		class KernelCache
+		{
+		private:
+			struct KeyHash
+			{
+				size_t operator()(const KernelCacheKey& key) const;
+			};
+
+			inline static std::mutex mutex;
+			inline static std::unordered_map<KernelCacheKey, std::weak_ptr<const KernelData>, KeyHash> entries;
+			static constexpr size_t minimumSweepThreshold = 64;
+			inline static size_t sweepThreshold = minimumSweepThreshold;
+		public:
+			// Returns the cached data for the key, calling build() only if no kernel currently shares it.
+			// build() runs without holding the cache, so concurrent misses on one key may build twice; the first stored wins.
+			static std::shared_ptr<const KernelData> get(const KernelCacheKey& key, const std::function<KernelData()>& build);
+			// Number of entries still in use.
+			static size_t getNumberOfEntries();
+		};
+	}
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cmath>
+
+#include "element.h"
+
+
+namespace dnf_composer
+{
+	namespace element
+	{
+		struct MemoryTraceParameters
+		{
+			double tauBuild = 100.0;
+			double tauDecay = 1000.0;
+			double threshold = 0.5;
+
+			bool operator==(const MemoryTraceParameters& other) const
+			{
+				constexpr double epsilon = 1e-6;
+
+				return std::abs(tauBuild - other.tauBuild) < epsilon &&
+					std::abs(tauDecay - other.tauDecay) < epsilon &&
+					std::abs(threshold - other.threshold) < epsilon;
+			}
+		};
+
+		// Long-term memory trace (preshape) of the field outputs it has as input. Bins where the input is above
+		// threshold build up towards 1 with tauBuild, the rest of the trace decays towards 0 with tauDecay.
+		// As in COSIVINA, nothing changes in steps without any active bin. Only the active bins and those with
+		// a trace are updated: a bin leaves the trace once it decayed below negligibleTrace and is set to 0.
+		// A step is still O(N) in the size: the dense input is thresholded in every bin, and the decay is applied
+		// eagerly to every trace bin rather than lazily from timestamps, since consumers read the output directly.
+		class MemoryTrace : public Element
+		{
+		private:
+			static constexpr double negligibleTrace = 1e-9;
+
+			MemoryTraceParameters parameters;
+			// bins with a nonzero trace, in no particular order
+			std::vector<int> traceBins;
+			std::vector<uint8_t> inTrace;
+			std::vector<int> activeBins;
+			// a bin is active in the current step if its stamp equals the step count, so no flags are cleared
+			std::vector<uint64_t> activeStamps;
+			uint64_t stepCount = 0;
+		public:
+			MemoryTrace(const ElementCommonParameters& elementCommonParameters, const MemoryTraceParameters& parameters);
+
+			void init() override;
+			void step(double t, double deltaT) override;
+			void close() override {}
+
+			void printParameters() override;
+
+			std::shared_ptr<Element> clone() const override;
+			void writeState(std::ostream& stream) const override;
+			void readState(std::istream& stream) override;
+
+			void setParameters(const MemoryTraceParameters& parameters);
+			MemoryTraceParameters getParameters() const;
+			// Bins with a nonzero trace, which a step updates besides the active ones.
+			int getNumberOfTraceBins() const;
+
+			~MemoryTrace() override = default;
+		private:
+			void addToTrace(int bin);
+			// Rebuilds the sparse bookkeeping from the output, after it was written as a whole.
+			void rebuildTraceBins();
+		};
+	}
+}
@@ -35,6 +35,8 @@ namespace dnf_composer
 		{
 		private:
 			MexicanHatKernelParameters parameters;
+		protected:
+			void writeOutput(const std::vector<double>& convolution) override;
 		public:
 			MexicanHatKernel(const ElementCommonParameters& elementCommonParameters, const MexicanHatKernelParameters& mhk_parameters);
 
@@ -44,6 +46,10 @@ namespace dnf_composer
 
 			void printParameters() override;
 
+			std::shared_ptr<Element> clone() const override;
+			void writeState(std::ostream& stream) const override;
+			void readState(std::istream& stream) override;
+
 			void setParameters(const MexicanHatKernelParameters& mhk_parameters);
 			MexicanHatKernelParameters getParameters() const;
 
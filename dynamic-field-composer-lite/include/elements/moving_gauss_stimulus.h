@@ -0,0 +1,69 @@
+#pragma once
+
+#include "element.h"
+#include "trajectory.h"
+
+
+namespace dnf_composer
+{
+	namespace element
+	{
+		// Position, amplitude and sigma of the stimulus over time. Positions are in bins, as for GaussStimulus.
+		struct MovingGaussStimulusParameters
+		{
+			Trajectory position;
+			Trajectory amplitude = Trajectory(15.0);
+			Trajectory sigma = Trajectory(5.0);
+			bool circular = true;
+		};
+
+		// Gaussian stimulus that follows its trajectories, re-rendered at every step without init(). Only the
+		// support window of cutOfFactor * sigma around the position is written, and the window of the previous
+		// step cleared, so a step costs O(support) instead of O(size). With a constant sigma the window is
+		// interpolated from a cached profile sampled at subBinResolution positions per bin, which keeps the
+		// output within 1e-5 of the amplitude of a GaussStimulus at the same position; a varying sigma evaluates
+		// the Gaussian over the window directly. The stimulus does not read its inputs.
+		class MovingGaussStimulus : public Element
+		{
+		private:
+			static constexpr int cutOfFactor = 5;
+			static constexpr int subBinResolution = 64;
+
+			MovingGaussStimulusParameters parameters;
+			// row q holds the Gaussian at offsets -profileRadius .. profileRadius + 1 from a position q / subBinResolution into a bin
+			std::vector<double> profile;
+			double profileSigma = 0.0;
+			int profileRadius = -1;
+			std::vector<int> renderedBins;
+			double renderedTime = 0.0;
+			double position = 0.0;
+			double amplitude = 0.0;
+			double sigma = 0.0;
+		public:
+			MovingGaussStimulus(const ElementCommonParameters& elementCommonParameters, const MovingGaussStimulusParameters& parameters);
+
+			// Renders the stimulus at the time it is initialized at, tZero of the simulation.
+			void init() override;
+			void step(double t, double deltaT) override;
+			void close() override {}
+
+			void printParameters() override;
+
+			std::shared_ptr<Element> clone() const override;
+			void readState(std::istream& stream) override;
+
+			// Re-renders at the time of the last step.
+			void setParameters(const MovingGaussStimulusParameters& parameters);
+			MovingGaussStimulusParameters getParameters() const;
+			// Values the trajectories had at the last rendered time.
+			double getPosition() const;
+			double getAmplitude() const;
+			double getSigma() const;
+
+			~MovingGaussStimulus() override = default;
+		private:
+			void render(double t);
+			void buildProfile(int radius);
+		};
+	}
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <span>
+
 #include "element.h"
 #include "activation_function.h"
 
@@ -48,11 +50,35 @@ namespace dnf_composer
 			}
 		};
 
+		// Component buffers of a field resolved ahead of time, see ExecutionPlan.
+		struct NeuralFieldBuffers
+		{
+			double* activation = nullptr;
+			const double* restingLevel = nullptr;
+			double* input = nullptr;
+			double* output = nullptr;
+		};
+
 		class NeuralField : public Element
 		{
 		protected:
+			// Positions above the centroid threshold, split by the half of the field they lie in so the
+			// circular centroid can be derived once it is known whether the peak touches the field limits.
+			struct CentroidStatistics
+			{
+				double count = 0.0;
+				double lowerCount = 0.0;
+				double lowerDistances = 0.0;
+				double upperDistances = 0.0;
+				bool atLimits = false;
+			};
+
+			static constexpr double centroidThreshold = 0.1;
+
 			NeuralFieldParameters parameters;
 		    double centroid;
+			double maxActivationChange;
+			bool fusedStep;
 		public:
 			NeuralField(const ElementCommonParameters& elementCommonParameters, const NeuralFieldParameters& parameters);
 
@@ -62,9 +88,24 @@ namespace dnf_composer
 
 			void printParameters() override;
 
+			std::shared_ptr<Element> clone() const override;
+			void writeState(std::ostream& stream) const override;
+			void readState(std::istream& stream) override;
+
 			void setParameters(const NeuralFieldParameters& parameters);
+			// Overwrites the activation and recomputes output and centroid, without advancing time.
+			void setActivation(const std::vector<double>& activation);
 			NeuralFieldParameters getParameters() const;
 		    double getCentroid() const;
+			// Largest |activation change| of the last step, a by-product of the Euler update.
+			double getMaxActivationChange() const;
+			// The fused step computes input sum, Euler update, output and centroid statistics in one sweep over the field.
+			// Fields with a custom activation function or inputs of another size always take the separate passes.
+			void setFusedStep(bool enable);
+			bool getFusedStep() const;
+			// Fused step over resolved buffers, with inputValues holding one component of getSize() values and its gain per input.
+			// Returns false without touching the field if the activation function has no fused form.
+			bool stepResolved(const NeuralFieldBuffers& buffers, std::span<const ResolvedInput> inputValues, double deltaT);
 
 			~NeuralField() override = default;
 
@@ -72,6 +113,56 @@ namespace dnf_composer
 			void calculateActivation(double t, double deltaT);
 			void calculateOutput();
 			void calculateCentroid();
+			bool stepFused(double deltaT);
+			template<int Size = 0, typename Activation>
+			CentroidStatistics fusedSweep(const NeuralFieldBuffers& buffers, std::span<const ResolvedInput> inputValues, double deltaT, Activation activation);
+			void updateCentroid(const CentroidStatistics& statistics);
 		};
+
+		template<int Size, typename Activation>
+		NeuralField::CentroidStatistics NeuralField::fusedSweep(const NeuralFieldBuffers& buffers, std::span<const ResolvedInput> inputValues, double deltaT, Activation activation)
+		{
+			// a compile-time size lets the compiler unroll the sweep, see StaticNeuralField
+			const int size = Size > 0 ? Size : commonParameters.dimensionParameters.size;
+			const double halfSize = static_cast<double>(size) * 0.5;
+			double* activationValues = buffers.activation;
+			const double* restingLevel = buffers.restingLevel;
+			double* input = buffers.input;
+			double* output = buffers.output;
+
+			// same operations in the same order as updateInput, calculateActivation, calculateOutput and calculateCentroid
+			CentroidStatistics statistics;
+			double maxChange = 0.0;
+			for (int i = 0; i < size; i++)
+			{
+				double inputSum = 0.0;
+				for (const auto& [values, gain] : inputValues)
+					inputSum += gain * (*values)[i];
+				input[i] = inputSum;
+
+				const double change = deltaT / parameters.tau * (-activationValues[i] + restingLevel[i] + inputSum);
+				const double u = activationValues[i] + change;
+				activationValues[i] = u;
+				maxChange = std::max(maxChange, std::fabs(change));
+
+				output[i] = activation(u);
+
+				if (u > centroidThreshold)
+				{
+					const double distance = static_cast<double>(i) - halfSize;
+					statistics.count += 1.0;
+					if (distance < 0.0)
+					{
+						statistics.lowerCount += 1.0;
+						statistics.lowerDistances += distance;
+					}
+					else
+						statistics.upperDistances += distance;
+				}
+			}
+			maxActivationChange = maxChange;
+			statistics.atLimits = activationValues[0] > centroidThreshold || activationValues[size - 1] > centroidThreshold;
+			return statistics;
+		}
 	}
 }
@@ -24,6 +24,7 @@ namespace dnf_composer
 		{
 		private:
 			NormalNoiseParameters parameters;
+			std::mt19937 generator;
 		public:
 			NormalNoise(const ElementCommonParameters& elementCommonParameters, NormalNoiseParameters parameters);
 
@@ -33,8 +34,15 @@ namespace dnf_composer
 
 			void printParameters() override;
 
+			std::shared_ptr<Element> clone() const override;
+			void writeState(std::ostream& stream) const override;
+			void readState(std::istream& stream) override;
+
 			void setParameters(NormalNoiseParameters parameters);
 			NormalNoiseParameters getParameters() const;
+			void setSeed(unsigned int seed);
+			// Textual state of the random engine, as written by operator<< of std::mt19937.
+			std::string getGeneratorState() const;
 
 			~NormalNoise() override = default;
 		};
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <array>
+
+#include "gauss_kernel.h"
+
+namespace dnf_composer
+{
+	namespace element
+	{
+		// Circular Gauss kernel with the field size and the largest kernel radius fixed at compile time, the
+		// counterpart of StaticNeuralField. The weights live in a std::array of 2 * Radius + 1 entries, zero beyond
+		// the kernel range of the current sigma, and the convolution runs over a wrapped copy of the input with
+		// constant trip counts. Inputs, output and weights match those of a circular GaussKernel bitwise.
+		template<int Size, int Radius>
+		class StaticGaussKernel : public Element
+		{
+			static_assert(Size > 0 && Radius >= 0, "StaticGaussKernel requires a positive size and a non-negative radius");
+		private:
+			static constexpr int cutOfFactor = 5;
+			static constexpr int numberOfWeights = 2 * Radius + 1;
+
+			GaussKernelParameters parameters;
+			std::array<int, 2> kernelRange = { 0, 0 };
+			// weights[Radius + offset] for offsets -Radius .. Radius
+			std::array<double, numberOfWeights> weights = {};
+			double fullSum = 0.0;
+			std::vector<double>* input;
+			std::vector<double>* output;
+			// result of the last check of the input sizes, redone only after the inputs change
+			bool inputsFitSize = true;
+			uint64_t checkedInputsRevision = UINT64_MAX;
+		public:
+			StaticGaussKernel(const ElementCommonParameters& elementCommonParameters, const GaussKernelParameters& parameters)
+				: Element(elementCommonParameters), parameters(parameters)
+			{
+				commonParameters.identifiers.label = ElementLabel::GAUSS_KERNEL;
+				if (commonParameters.dimensionParameters.size != Size)
+					throw Exception(ErrorCode::ELEM_SIZE_NOT_ALLOWED, commonParameters.identifiers.uniqueName);
+				if (!fitsRadius(parameters))
+					throw Exception(ErrorCode::ELEM_INVALID_PARAMETER, commonParameters.identifiers.uniqueName);
+				components["kernel"] = std::vector<double>(Size);
+				resolveComponents();
+			}
+
+			StaticGaussKernel(const StaticGaussKernel& other)
+				: Element(other), parameters(other.parameters), kernelRange(other.kernelRange), weights(other.weights), fullSum(other.fullSum)
+			{
+				resolveComponents();
+			}
+
+			void init() override
+			{
+				kernelRange = mathtools::computeKernelRange(parameters.sigma, cutOfFactor, Size, true);
+				std::vector<int> rangeX(kernelRange[0] + kernelRange[1] + 1);
+				std::iota(rangeX.begin(), rangeX.end(), -kernelRange[0]);
+
+				// same weights as the KernelData of a GaussKernel
+				const std::vector<double> gauss = mathtools::gaussNorm(rangeX, 0.0, parameters.sigma);
+				std::vector<double>& kernel = components["kernel"];
+				kernel.assign(rangeX.size(), 0.0);
+				weights.fill(0.0);
+				for (size_t i = 0; i < rangeX.size(); i++)
+				{
+					kernel[i] += parameters.amplitude * gauss[i];
+					weights[Radius + rangeX[i]] = kernel[i];
+				}
+
+				fullSum = 0;
+				std::ranges::fill(*input, 0.0);
+				checkedInputsRevision = UINT64_MAX;
+				checkInputSizes();
+			}
+
+			void step(double t, double deltaT) override
+			{
+				if (!checkInputSizes())
+					return;
+				const std::vector<ResolvedInput>& inputValues = getResolvedInputs();
+				double* inputSum = input->data();
+				std::fill_n(inputSum, Size, 0.0);
+				for (const auto& [values, gain] : inputValues)
+					for (int i = 0; i < Size; i++)
+						inputSum[i] += gain * (*values)[i];
+				fullSum = std::accumulate(inputSum, inputSum + Size, 0.0);
+
+				// extended[j] = input[(j - Radius) mod Size], so every position convolves without index arithmetic
+				std::array<double, Size + 2 * Radius> extended;
+				for (int j = 0; j < Size + 2 * Radius; j++)
+					extended[j] = inputSum[((j - Radius) % Size + Size) % Size];
+
+				// offsets from Radius down to -Radius, the order of mathtools::kernelConvolution
+				double* outputValues = output->data();
+				for (int i = 0; i < Size; i++)
+				{
+					double sum = 0.0;
+					for (int k = 0; k < numberOfWeights; k++)
+						sum += weights[numberOfWeights - 1 - k] * extended[i + k];
+					outputValues[i] = sum + parameters.amplitudeGlobal * fullSum;
+				}
+			}
+
+			void close() override {}
+
+			void printParameters() override
+			{
+				printCommonParameters();
+
+				std::ostringstream logStream;
+				logStream << "Logging specific element parameters" << std::endl;
+				logStream << "Amplitude: " << parameters.amplitude << std::endl;
+				logStream << "Amplitude Global: " << parameters.amplitudeGlobal << std::endl;
+				logStream << "Sigma: " << parameters.sigma << std::endl;
+				logStream << "Size: " << Size << " | Radius: " << Radius << std::endl;
+
+				log(LogLevel::INFO, logStream.str());
+			}
+
+			std::shared_ptr<Element> clone() const override
+			{
+				return std::make_shared<StaticGaussKernel>(*this);
+			}
+
+			void writeState(std::ostream& stream) const override
+			{
+				utilities::writeBinary(stream, parameters);
+				Element::writeState(stream);
+			}
+
+			void readState(std::istream& stream) override
+			{
+				GaussKernelParameters storedParameters = parameters;
+				utilities::readBinary(stream, storedParameters);
+				if (!(storedParameters == parameters))
+					setParameters(storedParameters);
+				Element::readState(stream);
+			}
+
+			// Parameters whose kernel range exceeds Radius are rejected and the current ones kept.
+			void setParameters(const GaussKernelParameters& gk_parameters)
+			{
+				if (!fitsRadius(gk_parameters))
+				{
+					log(LogLevel::ERROR, "Sigma " + std::to_string(gk_parameters.sigma) + " needs a larger radius than " + std::to_string(Radius) + " for '" + getUniqueName() + "'.\n");
+					return;
+				}
+				parameters = gk_parameters;
+				init();
+			}
+
+			GaussKernelParameters getParameters() const
+			{
+				return parameters;
+			}
+
+			std::array<int, 2> getKernelRange() const
+			{
+				return kernelRange;
+			}
+
+			static bool fitsRadius(const GaussKernelParameters& parameters)
+			{
+				const std::array<int, 2> range = mathtools::computeKernelRange(parameters.sigma, cutOfFactor, Size, true);
+				return range[0] <= Radius && range[1] <= Radius;
+			}
+
+			~StaticGaussKernel() override = default;
+		private:
+			// Reported once per change of the inputs, a kernel with an input of another size is not stepped.
+			bool checkInputSizes()
+			{
+				if (checkedInputsRevision == inputsRevision)
+					return inputsFitSize;
+				checkedInputsRevision = inputsRevision;
+				inputsFitSize = std::ranges::all_of(getResolvedInputs(), [](const ResolvedInput& inputValue) { return inputValue.values->size() == Size; });
+				if (!inputsFitSize)
+					log(LogLevel::ERROR, "Input of '" + getUniqueName() + "' does not have its size, the kernel is not stepped until its inputs change.\n");
+				return inputsFitSize;
+			}
+
+			void resolveComponents()
+			{
+				input = &components.at("input");
+				output = &components.at("output");
+			}
+		};
+	}
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "neural_field.h"
+
+namespace dnf_composer
+{
+	namespace element
+	{
+		// Neural field with its size fixed at compile time, for small categorical, color or motor fields where
+		// component lookups and the dispatch of the activation function cost more than the dynamics.
+		// The components, inputs and centroid are those of NeuralField, so it can take any place of one in a
+		// simulation and computes bitwise the same values. The step sweeps the field once over cached buffers
+		// and inputs with a constant trip count the compiler can unroll.
+		template<int Size>
+		class StaticNeuralField : public NeuralField
+		{
+			static_assert(Size > 0, "StaticNeuralField requires a positive size");
+		private:
+			enum class Activation { SIGMOID, HEAVISIDE, OTHER };
+
+			Activation activation = Activation::OTHER;
+			double steepness = 0.0;
+			double xShift = 0.0;
+			std::vector<double>* activationValues;
+			std::vector<double>* restingLevel;
+			std::vector<double>* input;
+			std::vector<double>* output;
+		public:
+			StaticNeuralField(const ElementCommonParameters& elementCommonParameters, const NeuralFieldParameters& parameters)
+				: NeuralField(elementCommonParameters, parameters)
+			{
+				if (commonParameters.dimensionParameters.size != Size)
+					throw Exception(ErrorCode::ELEM_SIZE_NOT_ALLOWED, commonParameters.identifiers.uniqueName);
+				resolveComponents();
+				resolveActivation();
+			}
+
+			StaticNeuralField(const StaticNeuralField& other)
+				: NeuralField(other), activation(other.activation), steepness(other.steepness), xShift(other.xShift)
+			{
+				resolveComponents();
+			}
+
+			void init() override
+			{
+				NeuralField::init();
+				resolveActivation();
+			}
+
+			void step(double t, double deltaT) override
+			{
+				if (!fusedStep || activation == Activation::OTHER)
+				{
+					NeuralField::step(t, deltaT);
+					return;
+				}
+
+				const std::vector<ResolvedInput>& inputValues = getResolvedInputs();
+				for (const ResolvedInput& inputValue : inputValues)
+					if (inputValue.values->size() != Size)
+					{
+						NeuralField::step(t, deltaT);
+						return;
+					}
+
+				output->resize(Size);
+				const NeuralFieldBuffers buffers{ activationValues->data(), restingLevel->data(), input->data(), output->data() };
+				CentroidStatistics statistics;
+				if (activation == Activation::SIGMOID)
+					statistics = fusedSweep<Size>(buffers, inputValues, deltaT, mathtools::SigmoidActivation<double>{ steepness, xShift });
+				else
+					statistics = fusedSweep<Size>(buffers, inputValues, deltaT, mathtools::HeavisideActivation<double>{ xShift });
+				updateCentroid(statistics);
+			}
+
+			std::shared_ptr<Element> clone() const override
+			{
+				return std::make_shared<StaticNeuralField>(*this);
+			}
+
+			void readState(std::istream& stream) override
+			{
+				NeuralField::readState(stream);
+				resolveActivation();
+			}
+
+			~StaticNeuralField() override = default;
+		private:
+			void resolveComponents()
+			{
+				activationValues = &components.at("activation");
+				restingLevel = &components.at("resting level");
+				input = &components.at("input");
+				output = &components.at("output");
+			}
+
+			void resolveActivation()
+			{
+				activation = Activation::OTHER;
+				if (const auto* sigmoid = dynamic_cast<const SigmoidFunction*>(parameters.activationFunction.get()))
+				{
+					activation = Activation::SIGMOID;
+					steepness = sigmoid->getSteepness();
+					xShift = sigmoid->getXShift();
+				}
+				else if (const auto* heaviside = dynamic_cast<const HeavisideFunction*>(parameters.activationFunction.get()))
+				{
+					activation = Activation::HEAVISIDE;
+					xShift = heaviside->getXShift();
+				}
+			}
+		};
+	}
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <vector>
+#include <utility>
+
+#include "exceptions/exception.h"
+
+
+namespace dnf_composer
+{
+	namespace element
+	{
+		// Value of a stimulus parameter over simulation time. Piecewise-linear and sampled trajectories
+		// interpolate linearly and hold their first and last values outside of the covered time.
+		class Trajectory
+		{
+		public:
+			enum class Kind { CONSTANT, PIECEWISE_LINEAR, SINUSOIDAL, SAMPLED };
+		private:
+			Kind kind = Kind::CONSTANT;
+			double offset = 0.0;
+			double amplitude = 0.0;
+			double period = 1.0;
+			double phase = 0.0;
+			// knot times (piecewise-linear), or the start and interval of the samples
+			std::vector<double> times;
+			std::vector<double> values;
+			double start = 0.0;
+			double interval = 1.0;
+		public:
+			Trajectory(double value = 0.0);
+
+			static Trajectory constant(double value);
+			// Knots as {time, value}, with strictly increasing times.
+			static Trajectory piecewiseLinear(const std::vector<std::pair<double, double>>& knots);
+			// offset + amplitude * sin(2 pi (t / period) + phase)
+			static Trajectory sinusoidal(double offset, double amplitude, double period, double phase = 0.0);
+			// samples[i] is the value at start + i * interval.
+			static Trajectory sampled(const std::vector<double>& samples, double interval, double start = 0.0);
+
+			double valueAt(double t) const;
+			bool isConstant() const;
+			Kind getKind() const;
+		};
+	}
+}
@@ -4,10 +4,21 @@
 #include <string>
 #include <chrono>
 #include <iomanip>
+#include <atomic>
 
 #include "exceptions/exception.h"
 #include "user_interface/logger_window.h"
 
+// Messages below this level are compiled out of every log() call site.
+// Defaults to DEBUG in debug builds and INFO otherwise; define it (e.g. to 2 for WARNING) to strip more.
+#ifndef DNF_COMPOSER_MIN_LOG_LEVEL
+#ifdef _DEBUG
+#define DNF_COMPOSER_MIN_LOG_LEVEL 0
+#else
+#define DNF_COMPOSER_MIN_LOG_LEVEL 1
+#endif
+#endif
+
 namespace dnf_composer
 {
 	enum LogLevel : int
@@ -26,22 +37,36 @@ namespace dnf_composer
 		ALL
 	};
 
+	// Asynchronous logger. Callers push records into a lock-free bounded MPSC queue and a background
+	// sink thread formats them (with a timestamp cached per second) to the console and the logger window.
+	// Identical consecutive messages of a thread are collapsed into a single "repeated" line.
 	class Logger
 	{
 	private:
-		LogLevel logLevel;
-		LogOutputMode outputMode;
+		inline static std::atomic<int> minimumLevel = DNF_COMPOSER_MIN_LOG_LEVEL;
 	public:
-		Logger(LogLevel level, LogOutputMode mode = ALL);
-		void log(const std::string& message) const;
+		static void setMinimumLevel(LogLevel level);
+		static LogLevel getMinimumLevel() { return static_cast<LogLevel>(minimumLevel.load(std::memory_order_relaxed)); }
+
+		static void log(LogLevel level, const std::string& message, LogOutputMode mode = ALL);
+		// Blocks until every message logged before the call has been written.
+		static void flush();
 	private:
+		friend class LogSink;
 		static std::string getLogLevelColorCode(LogLevel level);
 		static std::string getLogLevelText(LogLevel level);
 		static void log_cmd(const std::string& message);
 		static void log_ui(const std::string& message);
 	};
 
-	void log(LogLevel level, const std::string& message, LogOutputMode mode = ALL);
+	inline bool isLogLevelEnabled(LogLevel level)
+	{
+		return level >= DNF_COMPOSER_MIN_LOG_LEVEL && level >= Logger::getMinimumLevel();
+	}
 
-	static Logger logger(LogLevel::INFO);
-}
\ No newline at end of file
+	inline void log(LogLevel level, const std::string& message, LogOutputMode mode = ALL)
+	{
+		if (isLogLevelEnabled(level))
+			Logger::log(level, message, mode);
+	}
+}
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <cstddef>
+#include <algorithm>
+#include <concepts>
+#include <functional>
+#include <type_traits>
+
+namespace dnf_composer
+{
+	namespace mathtools
+	{
+		// Lazy elementwise algebra over field buffers. Operators and functions only build a small tree of nodes,
+		// the values are computed when the expression is evaluated, materialized or summed: then the whole
+		// composition runs as a single loop without temporary vectors. Each element is computed with the same
+		// operations in the same order as the equivalent hand written loop, so results are bitwise equal.
+		// Nodes hold views on the vectors they read, which must outlive the expression.
+		namespace expressions
+		{
+			struct ExpressionBase {};
+
+			template<typename E>
+			concept Expression = std::derived_from<E, ExpressionBase>;
+
+			template<typename T>
+			concept Operand = Expression<T> || std::is_arithmetic_v<T>;
+
+			template<typename T>
+			struct View : ExpressionBase
+			{
+				const T* data;
+				size_t length;
+
+				T operator[](size_t i) const { return data[i]; }
+				size_t size() const { return length; }
+			};
+
+			// Broadcasts a scalar, its size of 0 lets the other operand decide the size.
+			template<typename T>
+			struct Constant : ExpressionBase
+			{
+				T value;
+
+				T operator[](size_t) const { return value; }
+				size_t size() const { return 0; }
+			};
+
+			// first, first + 1, ... without storing them, as std::iota would.
+			template<typename T>
+			struct Indices : ExpressionBase
+			{
+				T first;
+				size_t length;
+
+				T operator[](size_t i) const { return first + static_cast<T>(i); }
+				size_t size() const { return length; }
+			};
+
+			template<typename F, Expression E>
+			struct Unary : ExpressionBase
+			{
+				E operand;
+				F function;
+
+				auto operator[](size_t i) const { return function(operand[i]); }
+				size_t size() const { return operand.size(); }
+			};
+
+			template<typename F, Expression L, Expression R>
+			struct Binary : ExpressionBase
+			{
+				L left;
+				R right;
+				F function;
+
+				auto operator[](size_t i) const { return function(left[i], right[i]); }
+				size_t size() const { return std::max(left.size(), right.size()); }
+			};
+
+			template<typename T>
+			View<T> view(const std::vector<T>& values)
+			{
+				return { {}, values.data(), values.size() };
+			}
+
+			template<typename T>
+			Indices<T> indices(T first, size_t length)
+			{
+				return { {}, first, length };
+			}
+
+			template<Operand T>
+			auto toExpression(const T& operand)
+			{
+				if constexpr (Expression<T>)
+					return operand;
+				else
+					return Constant<T>{ {}, operand };
+			}
+
+			template<typename F, Operand E>
+			auto makeUnary(const E& operand, F function)
+			{
+				using Node = decltype(toExpression(operand));
+				return Unary<F, Node>{ {}, toExpression(operand), function };
+			}
+
+			template<typename F, Operand L, Operand R>
+				requires (Expression<L> || Expression<R>)
+			auto makeBinary(const L& left, const R& right, F function)
+			{
+				using LeftNode = decltype(toExpression(left));
+				using RightNode = decltype(toExpression(right));
+				return Binary<F, LeftNode, RightNode>{ {}, toExpression(left), toExpression(right), function };
+			}
+
+			template<Operand L, Operand R> requires (Expression<L> || Expression<R>)
+			auto operator+(const L& left, const R& right) { return makeBinary(left, right, std::plus<>{}); }
+
+			template<Operand L, Operand R> requires (Expression<L> || Expression<R>)
+			auto operator-(const L& left, const R& right) { return makeBinary(left, right, std::minus<>{}); }
+
+			template<Operand L, Operand R> requires (Expression<L> || Expression<R>)
+			auto operator*(const L& left, const R& right) { return makeBinary(left, right, std::multiplies<>{}); }
+
+			template<Operand L, Operand R> requires (Expression<L> || Expression<R>)
+			auto operator/(const L& left, const R& right) { return makeBinary(left, right, std::divides<>{}); }
+
+			template<Expression E>
+			auto operator-(const E& operand) { return makeUnary(operand, std::negate<>{}); }
+
+			template<Expression E>
+			auto exp(const E& operand) { return makeUnary(operand, [](auto x) { return std::exp(x); }); }
+
+			template<Expression E>
+			auto abs(const E& operand) { return makeUnary(operand, [](auto x) { return std::abs(x); }); }
+
+			template<Expression E, typename T> requires std::is_arithmetic_v<T>
+			auto pow(const E& operand, T exponent) { return makeUnary(operand, [exponent](auto x) { return std::pow(x, exponent); }); }
+
+			// x * x, what compilers make of std::pow(x, 2) with a literal exponent; pow() keeps a runtime exponent
+			template<Expression E>
+			auto square(const E& operand) { return makeUnary(operand, [](auto x) { return x * x; }); }
+
+			template<Operand L, Operand R> requires (Expression<L> || Expression<R>)
+			auto min(const L& left, const R& right) { return makeBinary(left, right, [](auto a, auto b) { return std::min(a, b); }); }
+
+			// Any other elementwise function, e.g. a threshold.
+			template<Expression E, typename F>
+			auto apply(const E& operand, F function) { return makeUnary(operand, function); }
+
+			// The only loop: output[i] = expression[i]. The output may be one of the vectors the expression reads. An output
+			// of another size is only replaced after the evaluation, resizing it first could reallocate what the expression views.
+			template<typename T, Expression E>
+			void evaluate(const E& expression, std::vector<T>& output)
+			{
+				const size_t size = expression.size();
+				if (output.size() != size)
+				{
+					std::vector<T> values(size);
+					for (size_t i = 0; i < size; i++)
+						values[i] = static_cast<T>(expression[i]);
+					output = std::move(values);
+					return;
+				}
+				for (size_t i = 0; i < size; i++)
+					output[i] = static_cast<T>(expression[i]);
+			}
+
+			template<typename T, Expression E>
+			std::vector<T> materialize(const E& expression)
+			{
+				std::vector<T> values;
+				evaluate(expression, values);
+				return values;
+			}
+
+			// Sequential sum, as std::accumulate over the materialized values.
+			template<typename T, Expression E>
+			T sum(const E& expression)
+			{
+				T total = T();
+				for (size_t i = 0; i < expression.size(); i++)
+					total += static_cast<T>(expression[i]);
+				return total;
+			}
+		}
+	}
+}
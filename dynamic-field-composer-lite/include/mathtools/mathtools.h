@@ -19,6 +19,8 @@
 #include <random>
 #include <fstream>
 
+#include "mathtools/expressions.h"
+
 namespace dnf_composer
 {
 	namespace mathtools {
@@ -59,18 +61,23 @@ namespace dnf_composer
 			return out;
 		}
 
+		// Unevaluated Gaussian over rangeX, see expressions.h.
+		template<typename T>
+		auto gaussExpression(const std::vector<int>& rangeX, const T& position, const T& sigma)
+		{
+			using namespace expressions;
+			return exp(-0.5 * square(view(rangeX) - position) / std::pow(sigma, 2));
+		}
+
 		template<typename T>
 		std::vector<T> gaussNorm(const std::vector<int>& rangeX, const T& position, const T& sigma)
 		{
-			std::vector<T> g(rangeX.size());
-			for (int i = 0; i < g.size(); i++)
-				g[i] = exp(-0.5 * pow((rangeX[i] - position), 2) / pow(sigma, 2));
+			std::vector<T> g = expressions::materialize<T>(gaussExpression(rangeX, position, sigma));
 
 			if (!g.empty())
 			{
 				double sumOfG = std::reduce(g.begin(), g.end());
-				for (int i = 0; i < g.size(); i++)
-					g[i] = g[i] / sumOfG;
+				expressions::evaluate(expressions::view(g) / sumOfG, g);
 			}
 
 			return g;
@@ -79,37 +86,30 @@ namespace dnf_composer
 		template<typename T>
 		std::vector<T> gauss(const std::vector<int>& rangeX, const T& position, const T& sigma)
 		{
-			std::vector<T> g(rangeX.size());
-
-			for (int i = 0; i < g.size(); i++)
-				g[i] = exp(-0.5 * pow((rangeX[i] - position), 2) / pow(sigma, 2));
-
-			return g;
+			return expressions::materialize<T>(gaussExpression(rangeX, position, sigma));
 		}
 
+		// Unevaluated circular Gaussian over positions 1 .. size, it reads no vector and can be kept.
 		template<typename T>
-		std::vector<T> circularGauss(uint32_t size, const T& sigma, const T& position)
+		auto circularGaussExpression(uint32_t size, const T& sigma, const T& position)
 		{
+			using namespace expressions;
 			uint32_t l = size - 2 * 1 + 2;
 			uint32_t m = 1;
 			T r = position - static_cast<T>(m); // Calculate the shift with fractional part
 			T rem = std::fmod(r, static_cast<T>(l)); // Calculate the remainder
 			T positionShifted = rem + static_cast<T>(m); // Apply the shifted position
 
-			std::vector<T> g(size);
-			std::vector<T> xRange(size);
-			std::iota(xRange.begin(), xRange.end(), static_cast<T>(1));
-
-			std::vector<T> d(size);
-			std::vector<T> lMinusd(size);
-			std::transform(xRange.begin(), xRange.end(), d.begin(), [&positionShifted, &l](T element) { return std::abs(element - positionShifted); });
-			std::transform(d.begin(), d.end(), lMinusd.begin(), [&l](T element) { return -1 * (element - l); });
-			for (int i = 0; i < size; i++)
-			{
-				g[i] = std::exp(-0.5 * std::pow(std::min(d[i], lMinusd[i]), 2) / std::pow(sigma, 2));
-			}
+			// distance to the position, either direct or around the ring
+			const auto d = abs(indices(static_cast<T>(1), size) - positionShifted);
+			const auto lMinusd = -1 * (d - static_cast<T>(l));
+			return exp(-0.5 * square(min(d, lMinusd)) / std::pow(sigma, 2));
+		}
 
-			return g;
+		template<typename T>
+		std::vector<T> circularGauss(uint32_t size, const T& sigma, const T& position)
+		{
+			return expressions::materialize<T>(circularGaussExpression(size, sigma, position));
 		}
 
 		template<typename T>
@@ -121,38 +121,67 @@ namespace dnf_composer
 			return newContents;
 		}
 
+		// Pointwise activations, for loops that apply them one value at a time.
+		template<typename T>
+		struct SigmoidActivation
+		{
+			T beta;
+			T x0;
+
+			T operator()(T value) const { return 1 / (1 + std::exp(-beta * (value - x0))); }
+		};
+
+		template<typename T>
+		struct HeavisideActivation
+		{
+			T threshold;
+
+			T operator()(T value) const { return (value > threshold) ? T(1) : T(0); }
+		};
+
 		template<typename T>
 		std::vector<T> sigmoid(const std::vector<T>& x, T beta, T x0)
 		{
-			std::vector<T> s(x.size());
-			for (int i = 0; i < static_cast<int>(s.size()); i++)
-				s[i] = 1 / (1 + exp(-beta * (x[i] - x0)));
-			return s;
+			using namespace expressions;
+			return materialize<T>(1 / (1 + exp(-beta * (view(x) - x0))));
 		}
 
 		template<typename T>
 		std::vector<T> heaviside(const std::vector<T>& x, T threshold)
 		{
-			std::vector<T> h(x.size());
-			for (int i = 0; i < static_cast<int>(h.size()); i++)
-				h[i] = (x[i] > threshold) ? 1 : 0;
-			return h;
+			using namespace expressions;
+			return materialize<T>(apply(view(x), HeavisideActivation<T>{ threshold }));
 		}
 
 		template<typename T>
 		std::vector<T> sumGauss(const std::vector<T>& gauss1, const std::vector<T>& gauss2)
 		{
-			std::vector<T> gaussResult(gauss1.size());
-			for (int i = 0; i < gauss1.size(); i++)
-				gaussResult[i] = gauss1[i] + gauss2[i];
-			return gaussResult;
+			using namespace expressions;
+			return materialize<T>(view(gauss1) + view(gauss2));
 		}
 
 
 		std::array<int, 2> computeKernelRange(double sigma, int cutOfFactor, int fieldSize, bool circular);
 		std::vector<int> createExtendedIndex(int fieldSize, const std::array<int, 2>& kernelRange);
+		// Convolution of the input with weights covering the offsets -kernelRange[0] .. kernelRange[1], output has the input size.
+		// Circular borders wrap around, otherwise the input is zero padded. Only the border positions need index arithmetic,
+		// interior positions are a plain dot product over the input, no padded copy is made.
+		void kernelConvolution(const std::vector<double>& input, const std::vector<double>& weights, const std::array<int, 2>& kernelRange,
+			bool circular, std::vector<double>& output);
+
+		// Circular extended box filter (Gwosdek et al., "Theoretical foundations of Gaussian convolution by extended box
+		// filtering"): a moving sum of radius r plus the two next samples weighted by alpha, so its variance is sigma^2
+		// exactly and not only for integer widths. Running sums make it O(size) regardless of sigma.
+		void circularExtendedBoxFilter(const std::vector<double>& input, std::vector<double>& output, double sigma);
+		// Circular convolution with a unit-sum Gaussian approximated by a cascade of box filters.
+		// Costs O(passes * size) regardless of sigma. With 4 passes and sigma >= 2 the deviation of the effective
+		// kernel from the exact normalized Gaussian stays below 3.6% of its peak, see gaussianBoxFilterKernelError().
+		std::vector<double> circularGaussianBoxFilter(const std::vector<double>& input, double sigma, int passes = 4);
+		// Max |effective kernel - normalized circular Gaussian| relative to the Gaussian peak on a ring of the given size.
+		double gaussianBoxFilterKernelError(double sigma, int size, int passes = 4);
 
 		std::vector<double> generateNormalVector(int size);
+		std::vector<double> generateNormalVector(int size, std::mt19937& generator);
 
 		template <typename T>
 		std::vector<std::vector<T>> hebbLearningRule(const std::vector<T>& input, const std::vector<T>& targetOutput, double learningRate)
@@ -255,5 +284,523 @@ namespace dnf_composer
 			return weights;
 		}
 
+		// Compressed sparse row matrix. Rows are stored contiguously, row r spans
+		// [rowOffsets[r], rowOffsets[r + 1]) of columnIndices and values.
+		template <typename T>
+		struct SparseMatrix
+		{
+			int rows = 0;
+			int cols = 0;
+			std::vector<int> rowOffsets;
+			std::vector<int> columnIndices;
+			std::vector<T> values;
+
+			int getNumberOfNonZeros() const
+			{
+				return static_cast<int>(values.size());
+			}
+		};
+
+		// Builds the transposed CSR representation of a dense (input x output) weight matrix,
+		// so that each CSR row holds the afferent weights of one output neuron.
+		// Weights with |w| <= threshold are dropped and, if maxPerRow > 0, only the maxPerRow
+		// strongest weights of each row are kept.
+		template <typename T>
+		SparseMatrix<T> pruneToTransposedSparse(const std::vector<std::vector<T>>& weights, double threshold, int maxPerRow)
+		{
+			SparseMatrix<T> sparse;
+			sparse.cols = static_cast<int>(weights.size());
+			sparse.rows = weights.empty() ? 0 : static_cast<int>(weights[0].size());
+			sparse.rowOffsets.reserve(sparse.rows + 1);
+			sparse.rowOffsets.push_back(0);
+
+			std::vector<int> candidates;
+			candidates.reserve(sparse.cols);
+			for (int r = 0; r < sparse.rows; r++)
+			{
+				candidates.clear();
+				for (int c = 0; c < sparse.cols; c++)
+					if (std::abs(weights[c][r]) > threshold)
+						candidates.push_back(c);
+
+				if (maxPerRow > 0 && static_cast<int>(candidates.size()) > maxPerRow)
+				{
+					std::nth_element(candidates.begin(), candidates.begin() + maxPerRow, candidates.end(),
+						[&](int a, int b) { return std::abs(weights[a][r]) > std::abs(weights[b][r]); });
+					candidates.resize(maxPerRow);
+					std::sort(candidates.begin(), candidates.end());
+				}
+
+				for (const int c : candidates)
+				{
+					sparse.columnIndices.push_back(c);
+					sparse.values.push_back(weights[c][r]);
+				}
+				sparse.rowOffsets.push_back(static_cast<int>(sparse.values.size()));
+			}
+
+			return sparse;
+		}
+
+		// y[r] += sum_c A[r][c] * x[c]
+		template <typename T>
+		void sparseMultiplyAccumulate(const SparseMatrix<T>& matrix, const std::vector<T>& x, std::vector<T>& y)
+		{
+			for (int r = 0; r < matrix.rows; r++)
+			{
+				T sum = T();
+				for (int k = matrix.rowOffsets[r]; k < matrix.rowOffsets[r + 1]; k++)
+					sum += matrix.values[k] * x[matrix.columnIndices[k]];
+				y[r] += sum;
+			}
+		}
+
+		// Dense (input x output) matrix of a transposed CSR built by pruneToTransposedSparse.
+		template <typename T>
+		std::vector<std::vector<T>> transposedSparseToDense(const SparseMatrix<T>& matrix)
+		{
+			std::vector<std::vector<T>> dense(matrix.cols, std::vector<T>(matrix.rows, T()));
+			for (int r = 0; r < matrix.rows; r++)
+				for (int k = matrix.rowOffsets[r]; k < matrix.rowOffsets[r + 1]; k++)
+					dense[matrix.columnIndices[k]][r] = matrix.values[k];
+			return dense;
+		}
+
+		// Adds the rank-1 term left[c] * right[r] to the weights a transposed CSR does not store, where it exceeds
+		// threshold, and drops stored weights that no longer do. Rows over maxPerRow keep their strongest weights.
+		// The candidates of a row are a prefix of the inputs sorted by |left|, so this costs
+		// O(nnz + inputs log inputs + added) instead of visiting every input of every output.
+		template <typename T>
+		void addSparseRankOneTerm(SparseMatrix<T>& matrix, const std::vector<T>& left, const std::vector<T>& right, double threshold, int maxPerRow)
+		{
+			std::vector<int> inputOrder(left.size());
+			std::iota(inputOrder.begin(), inputOrder.end(), 0);
+			std::sort(inputOrder.begin(), inputOrder.end(), [&](int a, int b) { return std::abs(left[a]) > std::abs(left[b]); });
+
+			SparseMatrix<T> updated{ matrix.rows, matrix.cols, {}, {}, {} };
+			updated.rowOffsets.reserve(matrix.rows + 1);
+			updated.rowOffsets.push_back(0);
+			updated.columnIndices.reserve(matrix.columnIndices.size());
+			updated.values.reserve(matrix.values.size());
+			std::vector<std::pair<int, T>> row;
+			for (int r = 0; r < matrix.rows; r++)
+			{
+				const auto storedBegin = matrix.columnIndices.begin() + matrix.rowOffsets[r];
+				const auto storedEnd = matrix.columnIndices.begin() + matrix.rowOffsets[r + 1];
+				row.clear();
+				for (int k = matrix.rowOffsets[r]; k < matrix.rowOffsets[r + 1]; k++)
+					if (std::abs(matrix.values[k]) > threshold)
+						row.emplace_back(matrix.columnIndices[k], matrix.values[k]);
+				for (const int c : inputOrder)
+				{
+					const T value = left[c] * right[r];
+					if (std::abs(value) <= threshold)
+						break;
+					if (!std::binary_search(storedBegin, storedEnd, c))
+						row.emplace_back(c, value);
+				}
+
+				if (maxPerRow > 0 && static_cast<int>(row.size()) > maxPerRow)
+				{
+					std::nth_element(row.begin(), row.begin() + maxPerRow, row.end(),
+						[](const auto& a, const auto& b) { return std::abs(a.second) > std::abs(b.second); });
+					row.resize(maxPerRow);
+				}
+				std::sort(row.begin(), row.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+				for (const auto& [c, value] : row)
+				{
+					updated.columnIndices.push_back(c);
+					updated.values.push_back(value);
+				}
+				updated.rowOffsets.push_back(static_cast<int>(updated.values.size()));
+			}
+			matrix = std::move(updated);
+		}
+
+		// Sparse counterparts of the learning rules above on a transposed CSR, for couplings that keep no dense
+		// matrix. Stored weights are updated in place. A weight that is not stored counts as 0 and is only added
+		// where its update exceeds threshold, so they match the dense rules followed by pruneToTransposedSparse
+		// up to updates that stay below threshold on their own.
+		template <typename T>
+		SparseMatrix<T> hebbLearningRuleSparse(const std::vector<T>& input, const std::vector<T>& targetOutput, double learningRate,
+			double threshold, int maxPerRow)
+		{
+			if (input.size() != targetOutput.size())
+				throw std::invalid_argument("Input and targetOutput must have the same size.");
+
+			SparseMatrix<T> weights{ static_cast<int>(targetOutput.size()), static_cast<int>(input.size()),
+				std::vector<int>(targetOutput.size() + 1, 0), {}, {} };
+			std::vector<T> left(input.size());
+			for (size_t i = 0; i < input.size(); i++)
+				left[i] = learningRate * input[i];
+			addSparseRankOneTerm(weights, left, targetOutput, threshold, maxPerRow);
+			return weights;
+		}
+
+		template <typename T>
+		void deltaLearningRuleWidrowHoffSparse(SparseMatrix<T>& weights, const std::vector<T>& input, const std::vector<T>& targetOutput,
+			double learningRate, double threshold, int maxPerRow)
+		{
+			if (input.size() != targetOutput.size() || static_cast<int>(input.size()) != weights.cols || static_cast<int>(targetOutput.size()) != weights.rows)
+				throw std::invalid_argument("Input and targetOutput must match the size of the weights.");
+
+			std::vector<T> error = targetOutput;
+			std::vector<T> actualOutput(targetOutput.size(), T());
+			sparseMultiplyAccumulate(weights, input, actualOutput);
+			for (size_t r = 0; r < error.size(); r++)
+				error[r] -= actualOutput[r];
+
+			for (int r = 0; r < weights.rows; r++)
+				for (int k = weights.rowOffsets[r]; k < weights.rowOffsets[r + 1]; k++)
+					weights.values[k] += learningRate * error[r] * input[weights.columnIndices[k]];
+
+			std::vector<T> left(input.size());
+			for (size_t i = 0; i < input.size(); i++)
+				left[i] = learningRate * input[i];
+			addSparseRankOneTerm(weights, left, error, threshold, maxPerRow);
+		}
+
+		template <typename T>
+		void deltaLearningRuleKroghHertzSparse(SparseMatrix<T>& weights, const std::vector<T>& input, const std::vector<T>& targetOutput,
+			double learningRate, double threshold, int maxPerRow)
+		{
+			double eta = 0.5;
+
+			if (static_cast<int>(input.size()) != weights.cols || static_cast<int>(targetOutput.size()) != weights.rows)
+				throw std::invalid_argument("Input and targetOutput must match the size of the weights.");
+
+			std::vector<T> error = targetOutput;
+			std::vector<T> actualOutput(targetOutput.size(), T());
+			sparseMultiplyAccumulate(weights, input, actualOutput);
+			for (size_t r = 0; r < error.size(); r++)
+				error[r] -= actualOutput[r];
+
+			for (int r = 0; r < weights.rows; r++)
+				for (int k = weights.rowOffsets[r]; k < weights.rowOffsets[r + 1]; k++)
+				{
+					const int c = weights.columnIndices[k];
+					weights.values[k] += learningRate * (error[r] - eta * weights.values[k]) * input[c];
+				}
+
+			// a weight that is not stored is 0, so its update is the same rank-1 term as in the Widrow-Hoff rule
+			std::vector<T> left(input.size());
+			for (size_t i = 0; i < input.size(); i++)
+				left[i] = learningRate * input[i];
+			addSparseRankOneTerm(weights, left, error, threshold, maxPerRow);
+		}
+
+		// Factorized matrix W = sum_k left[k] * right[k]^T. Each left vector has rows entries
+		// and each right vector has cols entries, so the rank is the number of factor pairs.
+		template <typename T>
+		struct LowRankMatrix
+		{
+			int rows = 0;
+			int cols = 0;
+			std::vector<std::vector<T>> left;
+			std::vector<std::vector<T>> right;
+
+			int getRank() const
+			{
+				return static_cast<int>(left.size());
+			}
+		};
+
+		// y[c] += sum_r W[r][c] * x[r], computed as sum_k right[k][c] * (left[k] . x) in O((rows + cols) * rank)
+		template <typename T>
+		void lowRankMultiplyAccumulate(const LowRankMatrix<T>& matrix, const std::vector<T>& x, std::vector<T>& y)
+		{
+			for (int k = 0; k < matrix.getRank(); k++)
+			{
+				const T projection = std::inner_product(matrix.left[k].begin(), matrix.left[k].end(), x.begin(), T());
+				if (projection == T())
+					continue;
+				const std::vector<T>& right = matrix.right[k];
+				for (int c = 0; c < matrix.cols; c++)
+					y[c] += projection * right[c];
+			}
+		}
+
+		template <typename T>
+		std::vector<std::vector<T>> lowRankToDense(const LowRankMatrix<T>& matrix)
+		{
+			std::vector<std::vector<T>> dense(matrix.rows, std::vector<T>(matrix.cols, T()));
+			for (int k = 0; k < matrix.getRank(); k++)
+				for (int r = 0; r < matrix.rows; r++)
+				{
+					const T scale = matrix.left[k][r];
+					if (scale == T())
+						continue;
+					for (int c = 0; c < matrix.cols; c++)
+						dense[r][c] += scale * matrix.right[k][c];
+				}
+			return dense;
+		}
+
+		// Orthonormalizes the vectors in place with modified Gram-Schmidt and returns the upper
+		// triangular factor R, so that original[k] = sum_i R[i][k] * vectors[i].
+		// Vectors that are numerically dependent on the previous ones are set to zero.
+		template <typename T>
+		std::vector<std::vector<T>> orthonormalize(std::vector<std::vector<T>>& vectors)
+		{
+			const int count = static_cast<int>(vectors.size());
+			std::vector<std::vector<T>> r(count, std::vector<T>(count, T()));
+			for (int k = 0; k < count; k++)
+			{
+				std::vector<T>& v = vectors[k];
+				const T originalNorm = std::sqrt(std::inner_product(v.begin(), v.end(), v.begin(), T()));
+				for (int i = 0; i < k; i++)
+				{
+					const T projection = std::inner_product(vectors[i].begin(), vectors[i].end(), v.begin(), T());
+					r[i][k] = projection;
+					for (size_t j = 0; j < v.size(); j++)
+						v[j] -= projection * vectors[i][j];
+				}
+				const T norm = std::sqrt(std::inner_product(v.begin(), v.end(), v.begin(), T()));
+				if (norm > 1e-12 * originalNorm && norm > T())
+				{
+					r[k][k] = norm;
+					for (auto& value : v)
+						value /= norm;
+				}
+				else
+					std::ranges::fill(v, T());
+			}
+			return r;
+		}
+
+		// Truncated SVD recompression of a factorized matrix. Both factor sets are reduced to
+		// orthonormal bases (W = Qu * Ru * Rv^T * Qv^T), the small rank x rank core is
+		// diagonalized with one-sided Jacobi rotations, and only the maxRank largest singular
+		// triplets above relativeTolerance * sigma_max are kept. The cost is
+		// O((rows + cols) * rank^2 + rank^3), independent of rows * cols.
+		// Returns the relative Frobenius error ||W - W_truncated||_F / ||W||_F.
+		template <typename T>
+		double truncateLowRank(LowRankMatrix<T>& matrix, int maxRank, double relativeTolerance = 1e-12)
+		{
+			const int rank = matrix.getRank();
+			if (rank == 0)
+				return 0.0;
+
+			std::vector<std::vector<T>> qu = matrix.left;
+			std::vector<std::vector<T>> qv = matrix.right;
+			const std::vector<std::vector<T>> ru = orthonormalize(qu);
+			const std::vector<std::vector<T>> rv = orthonormalize(qv);
+
+			// core columns: core[b][a] = (Ru * Rv^T)[a][b]
+			std::vector<std::vector<T>> core(rank, std::vector<T>(rank, T()));
+			for (int a = 0; a < rank; a++)
+				for (int b = 0; b < rank; b++)
+					for (int k = std::max(a, b); k < rank; k++)
+						core[b][a] += ru[a][k] * rv[b][k];
+
+			std::vector<std::vector<T>> rotations(rank, std::vector<T>(rank, T()));
+			for (int k = 0; k < rank; k++)
+				rotations[k][k] = T(1);
+
+			for (int sweep = 0; sweep < 30; sweep++)
+			{
+				bool rotated = false;
+				for (int p = 0; p < rank - 1; p++)
+					for (int q = p + 1; q < rank; q++)
+					{
+						const T alpha = std::inner_product(core[p].begin(), core[p].end(), core[p].begin(), T());
+						const T beta = std::inner_product(core[q].begin(), core[q].end(), core[q].begin(), T());
+						const T gamma = std::inner_product(core[p].begin(), core[p].end(), core[q].begin(), T());
+						if (std::abs(gamma) <= 1e-15 * std::sqrt(alpha * beta) || gamma == T())
+							continue;
+						rotated = true;
+						const T zeta = (beta - alpha) / (2 * gamma);
+						const T t = (zeta >= 0 ? T(1) : T(-1)) / (std::abs(zeta) + std::sqrt(1 + zeta * zeta));
+						const T c = 1 / std::sqrt(1 + t * t);
+						const T s = c * t;
+						for (int i = 0; i < rank; i++)
+						{
+							const T cp = core[p][i], cq = core[q][i];
+							core[p][i] = c * cp - s * cq;
+							core[q][i] = s * cp + c * cq;
+							const T jp = rotations[p][i], jq = rotations[q][i];
+							rotations[p][i] = c * jp - s * jq;
+							rotations[q][i] = s * jp + c * jq;
+						}
+					}
+				if (!rotated)
+					break;
+			}
+
+			// columns of the rotated core are sigma_k * a_k, columns of rotations are b_k
+			std::vector<T> sigma(rank);
+			for (int k = 0; k < rank; k++)
+				sigma[k] = std::sqrt(std::inner_product(core[k].begin(), core[k].end(), core[k].begin(), T()));
+			std::vector<int> order(rank);
+			std::iota(order.begin(), order.end(), 0);
+			std::ranges::sort(order, [&](int a, int b) { return sigma[a] > sigma[b]; });
+
+			const T total = std::inner_product(sigma.begin(), sigma.end(), sigma.begin(), T());
+			const int limit = maxRank > 0 ? std::min(maxRank, rank) : rank;
+			LowRankMatrix<T> truncated{ matrix.rows, matrix.cols, {}, {} };
+			T kept = T();
+			for (int n = 0; n < limit; n++)
+			{
+				const int k = order[n];
+				if (sigma[k] <= relativeTolerance * sigma[order[0]] || sigma[k] == T())
+					break;
+				std::vector<T> left(matrix.rows, T());
+				std::vector<T> right(matrix.cols, T());
+				for (int i = 0; i < rank; i++)
+				{
+					for (int r = 0; r < matrix.rows; r++)
+						left[r] += core[k][i] * qu[i][r];
+					for (int c = 0; c < matrix.cols; c++)
+						right[c] += rotations[k][i] * qv[i][c];
+				}
+				truncated.left.push_back(std::move(left));
+				truncated.right.push_back(std::move(right));
+				kept += sigma[k] * sigma[k];
+			}
+
+			matrix = std::move(truncated);
+			return total > T() ? std::sqrt(std::max(total - kept, T()) / total) : 0.0;
+		}
+
+		// Rank-maxRank approximation of a dense (rows x cols) matrix by a randomized range finder
+		// with one power iteration, followed by truncateLowRank. The cost is O(rows * cols * maxRank),
+		// and the result is exact up to round-off when the rank of the matrix does not exceed maxRank.
+		template <typename T>
+		LowRankMatrix<T> denseToLowRank(const std::vector<std::vector<T>>& dense, int maxRank, double* relativeError = nullptr)
+		{
+			LowRankMatrix<T> matrix;
+			matrix.rows = static_cast<int>(dense.size());
+			matrix.cols = dense.empty() ? 0 : static_cast<int>(dense[0].size());
+			if (relativeError)
+				*relativeError = 0.0;
+			if (matrix.rows == 0 || matrix.cols == 0)
+				return matrix;
+
+			const int fullRank = std::min(matrix.rows, matrix.cols);
+			const int samples = std::min(fullRank, (maxRank > 0 ? maxRank : fullRank) + 5);
+
+			std::mt19937 generator(42);
+			std::normal_distribution<T> distribution(0.0, 1.0);
+
+			// range basis: Q = orth(W * W^T * W * omega)
+			std::vector<std::vector<T>> basis(samples, std::vector<T>(matrix.rows, T()));
+			std::vector<T> probe(matrix.cols);
+			for (int s = 0; s < samples; s++)
+			{
+				for (auto& value : probe)
+					value = distribution(generator);
+				for (int r = 0; r < matrix.rows; r++)
+					basis[s][r] = std::inner_product(dense[r].begin(), dense[r].end(), probe.begin(), T());
+			}
+			orthonormalize(basis);
+			for (int s = 0; s < samples; s++)
+			{
+				std::ranges::fill(probe, T());
+				for (int r = 0; r < matrix.rows; r++)
+					for (int c = 0; c < matrix.cols; c++)
+						probe[c] += dense[r][c] * basis[s][r];
+				for (int r = 0; r < matrix.rows; r++)
+					basis[s][r] = std::inner_product(dense[r].begin(), dense[r].end(), probe.begin(), T());
+			}
+			orthonormalize(basis);
+
+			// W ~= Q * (Q^T * W)
+			T fullNorm = T();
+			for (const auto& row : dense)
+				fullNorm += std::inner_product(row.begin(), row.end(), row.begin(), T());
+			for (int s = 0; s < samples; s++)
+			{
+				std::vector<T> projection(matrix.cols, T());
+				for (int r = 0; r < matrix.rows; r++)
+					if (basis[s][r] != T())
+						for (int c = 0; c < matrix.cols; c++)
+							projection[c] += basis[s][r] * dense[r][c];
+				matrix.left.push_back(basis[s]);
+				matrix.right.push_back(std::move(projection));
+			}
+
+			truncateLowRank(matrix, maxRank);
+
+			if (relativeError && fullNorm > T())
+			{
+				T errorNorm = T();
+				for (int r = 0; r < matrix.rows; r++)
+					for (int c = 0; c < matrix.cols; c++)
+					{
+						T value = dense[r][c];
+						for (int k = 0; k < matrix.getRank(); k++)
+							value -= matrix.left[k][r] * matrix.right[k][c];
+						errorNorm += value * value;
+					}
+				*relativeError = std::sqrt(errorNorm / fullNorm);
+			}
+
+			return matrix;
+		}
+
+		// Factorized counterparts of the learning rules above. They produce the same weights as the
+		// dense rules but only append (or rescale) rank-1 terms; callers recompress with truncateLowRank.
+		template <typename T>
+		LowRankMatrix<T> hebbLearningRuleLowRank(const std::vector<T>& input, const std::vector<T>& targetOutput, double learningRate)
+		{
+			if (input.size() != targetOutput.size())
+				throw std::invalid_argument("Input and targetOutput must have the same size.");
+
+			LowRankMatrix<T> weights{ static_cast<int>(input.size()), static_cast<int>(targetOutput.size()), {}, {} };
+			std::vector<T> left(input.size());
+			for (size_t i = 0; i < input.size(); i++)
+				left[i] = learningRate * input[i];
+			weights.left.push_back(std::move(left));
+			weights.right.push_back(targetOutput);
+			return weights;
+		}
+
+		template <typename T>
+		void deltaLearningRuleWidrowHoffLowRank(LowRankMatrix<T>& weights, const std::vector<T>& input, const std::vector<T>& targetOutput, double learningRate)
+		{
+			if (input.size() != targetOutput.size())
+				throw std::invalid_argument("Input and targetOutput must have the same size.");
+
+			// W += learningRate * input * (target - W^T input)^T
+			std::vector<T> error = targetOutput;
+			std::vector<T> actualOutput(targetOutput.size(), T());
+			lowRankMultiplyAccumulate(weights, input, actualOutput);
+			for (size_t j = 0; j < error.size(); j++)
+				error[j] -= actualOutput[j];
+
+			std::vector<T> left(input.size());
+			for (size_t i = 0; i < input.size(); i++)
+				left[i] = learningRate * input[i];
+			weights.left.push_back(std::move(left));
+			weights.right.push_back(std::move(error));
+		}
+
+		template <typename T>
+		void deltaLearningRuleKroghHertzLowRank(LowRankMatrix<T>& weights, const std::vector<T>& input, const std::vector<T>& targetOutput, double learningRate)
+		{
+			double eta = 0.5;
+
+			if (input.size() != targetOutput.size())
+				throw std::invalid_argument("Input and targetOutput must have the same size.");
+
+			std::vector<T> error = targetOutput;
+			std::vector<T> actualOutput(targetOutput.size(), T());
+			lowRankMultiplyAccumulate(weights, input, actualOutput);
+			for (size_t j = 0; j < error.size(); j++)
+				error[j] -= actualOutput[j];
+
+			// W[i][j] += learningRate * (error[j] - eta * W[i][j]) * input[i]
+			// scales row i of W by (1 - learningRate * eta * input[i]) and adds a rank-1 term
+			for (auto& left : weights.left)
+				for (size_t i = 0; i < input.size(); i++)
+					left[i] *= 1 - learningRate * eta * input[i];
+
+			std::vector<T> left(input.size());
+			for (size_t i = 0; i < input.size(); i++)
+				left[i] = learningRate * input[i];
+			weights.left.push_back(std::move(left));
+			weights.right.push_back(std::move(error));
+		}
+
 	}
-}
\ No newline at end of file
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <span>
+
+#include "elements/element.h"
+#include "elements/kernel.h"
+#include "elements/neural_field.h"
+
+namespace dnf_composer
+{
+	// Architecture of a simulation frozen into a flat list of operations in step order, see Simulation::compile().
+	// Component buffers and inputs are resolved once, so a step does no name lookups, walks no input maps and
+	// dispatches on the operation kind instead of the virtual Element::step. Inputs are summed with their gains in
+	// the order of the input connections, as Element::updateInput does, so a compiled step is bitwise the same.
+	// The plan owns no state: operations point into the component vectors of the elements, which keep the live
+	// state for plots, checkpoints and direct reads, so the memory layout is that of the interpreted step.
+	// Operations are also grouped into stages: no operation reads a buffer that another one of its stage writes
+	// during the step. An undelayed input ties the reader to its source, before it if the source steps first and
+	// after it otherwise, while a delayed input reads a delay line that only changes between steps and ties
+	// nothing, so delays are what break the dependency cycles of recurrent architectures. The operations of a
+	// stage could run concurrently with the same results; execute() runs them in step order.
+	class ExecutionPlan
+	{
+	public:
+		enum class OperationKind : uint8_t
+		{
+			NEURAL_FIELD,	// fused field update over resolved buffers
+			KERNEL,			// direct convolution over resolved buffers
+			KERNEL_BATCH,	// kernels sharing their data, stepped at the position of the first of them
+			ELEMENT			// any other element, stepped through Element::step
+		};
+
+		struct Operation
+		{
+			OperationKind kind = OperationKind::ELEMENT;
+			element::Element* element = nullptr;
+			// range of inputValues summed into the input of the element
+			size_t firstInput = 0;
+			size_t numberOfInputs = 0;
+			std::vector<double>* input = nullptr;
+			std::vector<double>* activation = nullptr;
+			std::vector<double>* restingLevel = nullptr;
+			std::vector<double>* output = nullptr;
+			size_t batch = 0;
+			size_t stage = 0;
+		};
+	private:
+		std::vector<Operation> operations;
+		std::vector<element::ResolvedInput> inputValues;
+		std::vector<element::KernelBatch> kernelBatches;
+		size_t numberOfStages = 0;
+	public:
+		// batchOfElement holds the index in kernelBatches of each element, or -1 (see Simulation).
+		ExecutionPlan(const std::vector<std::shared_ptr<element::Element>>& elements,
+			const std::vector<element::KernelBatch>& kernelBatches, const std::vector<int>& batchOfElement);
+
+		void execute(double t, double deltaT);
+
+		const std::vector<Operation>& getOperations() const;
+		size_t getNumberOfStages() const;
+		// Copies the current gains of the input connections into the resolved inputs, without rebuilding anything.
+		void updateGains();
+	private:
+		// Appends the sources of the element's inputs to inputValues, false if any of them is not a component of the element's size.
+		bool resolveInputs(const element::Element& element);
+		std::span<const element::ResolvedInput> getInputValues(const Operation& operation) const;
+		void assignStages(const std::vector<std::shared_ptr<element::Element>>& elements, const std::vector<int>& batchOfElement);
+	};
+}
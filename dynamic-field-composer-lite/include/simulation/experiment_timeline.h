@@ -0,0 +1,99 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <functional>
+#include <unordered_map>
+
+#include "simulation/simulation.h"
+
+namespace dnf_composer
+{
+	struct TimelineEvent
+	{
+		enum class Kind
+		{
+			SET_COMPONENT,			// fills a component of element with value
+			SET_STIMULUS_POSITION,	// GaussStimulus::setPosition of element
+			SET_STIMULUS_AMPLITUDE,	// GaussStimulus::setAmplitude of element
+			SET_INPUT_GAIN,			// gain of the input element -> target
+			DISABLE_STIMULUS,		// zero gain on every interaction of element, remembering the gains
+			ENABLE_STIMULUS,		// restores the gains a DISABLE_STIMULUS zeroed
+			START_RECORDING,		// component of element every step into the recording label
+			STOP_RECORDING,
+			SNAPSHOT,				// component of element once into the snapshot label
+			WAIT_UNTIL_STABLE,		// Simulation::runUntilStable with criteria, its steps are not recorded
+			ACTION					// anything else, through a callback
+		};
+
+		double time;
+		Kind kind;
+		std::string element;
+		std::string target;
+		double value;
+		std::string label;
+		StabilityCriteria criteria;
+		std::function<void(Simulation&)> action;
+
+		TimelineEvent(double time, Kind kind, std::string element = {}, std::string target = {}, double value = 0.0,
+			std::string label = {}, StabilityCriteria criteria = {}, std::function<void(Simulation&)> action = {})
+			: time(time), kind(kind), element(std::move(element)), target(std::move(target)), value(value),
+			label(std::move(label)), criteria(std::move(criteria)), action(std::move(action))
+		{
+		}
+	};
+
+	// Declarative experiment protocol run by Simulation::run(const ExperimentTimeline&). Times are on the clock of
+	// the timeline, which starts at 0 and advances by deltaT per step; it holds while waiting for stability, so
+	// events keep their spacing however long the simulation takes to settle. Recordings get no frames for the
+	// steps taken while waiting, only for those that advance the clock. Events at the same time fire in the
+	// order they were added, before the step that moves the clock past their time. Actions may edit the
+	// architecture: the events after them are resolved again, and the experiment stops if one no longer resolves.
+	class ExperimentTimeline
+	{
+	private:
+		std::vector<TimelineEvent> events;
+		double duration = 0.0;
+	public:
+		ExperimentTimeline() = default;
+
+		ExperimentTimeline& setComponent(double time, const std::string& element, const std::string& component, double value);
+		ExperimentTimeline& setStimulusPosition(double time, const std::string& stimulus, double position);
+		ExperimentTimeline& setStimulusAmplitude(double time, const std::string& stimulus, double amplitude);
+		ExperimentTimeline& setInputGain(double time, const std::string& input, const std::string& receiver, double gain);
+		ExperimentTimeline& disableStimulus(double time, const std::string& stimulus);
+		ExperimentTimeline& enableStimulus(double time, const std::string& stimulus);
+		ExperimentTimeline& startRecording(double time, const std::string& label, const std::string& element, const std::string& component);
+		ExperimentTimeline& stopRecording(double time, const std::string& label);
+		ExperimentTimeline& snapshot(double time, const std::string& label, const std::string& element, const std::string& component);
+		ExperimentTimeline& waitUntilStable(double time, const StabilityCriteria& criteria = {});
+		ExperimentTimeline& action(double time, const std::function<void(Simulation&)>& callback);
+		// The timeline runs until its clock reaches the duration, or the time of its last event if that is later.
+		ExperimentTimeline& setDuration(double duration);
+
+		const std::vector<TimelineEvent>& getEvents() const;
+		double getDuration() const;
+	private:
+		ExperimentTimeline& add(TimelineEvent event);
+	};
+
+	struct ExperimentRecording
+	{
+		size_t frameSize = 0;
+		// timeline time of each frame, the frames stored one after the other
+		std::vector<double> times;
+		std::vector<double> values;
+
+		size_t getNumberOfFrames() const { return times.size(); }
+		const double* frame(size_t index) const { return values.data() + index * frameSize; }
+	};
+
+	struct ExperimentResults
+	{
+		bool completed = false;
+		std::unordered_map<std::string, ExperimentRecording> recordings;
+		std::unordered_map<std::string, std::vector<double>> snapshots;
+		// steps taken by each wait until stable, in timeline order
+		std::vector<int> settlingSteps;
+	};
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+namespace dnf_composer
+{
+	// Layout of the shared memory segment through which a SharedMemoryPublisher hands components of a simulation
+	// to readers in other processes. The segment starts with a ChannelHeader, followed by one ChannelSlot per
+	// published component and then the values of each slot at its offset. Only sequence, time and the values
+	// change after the publisher opened the segment. They are written under a seqlock: sequence is odd while a
+	// frame is being written, readers retry a copy that saw it change, and sequence / 2 frames were published.
+	namespace shared_memory
+	{
+		inline constexpr uint32_t channelMagicNumber = 0x444E4653; // "DNFS"
+		inline constexpr uint32_t channelVersion = 1;
+		inline constexpr size_t maxIdLength = 64;
+		inline constexpr size_t valuesAlignment = 64;
+
+		static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free,
+			"Shared memory channels require lock-free atomics, they are shared between processes.");
+
+		struct ChannelHeader
+		{
+			// written last when the segment is created, so a reader never sees a partial layout
+			std::atomic<uint32_t> magicNumber;
+			uint32_t version;
+			uint32_t numberOfSlots;
+			// cleared when the publisher closes, the values stay those of the last frame
+			std::atomic<uint32_t> publisherOpen;
+			uint64_t segmentSize;
+			alignas(64) std::atomic<uint64_t> sequence;
+			// simulation time of the last frame
+			double time;
+		};
+
+		struct ChannelSlot
+		{
+			char elementId[maxIdLength];
+			char componentId[maxIdLength];
+			// in bytes from the start of the segment
+			uint64_t offset;
+			uint64_t size;
+		};
+
+		// Named shared memory mapped into this process: shm_open/mmap on POSIX systems and a named file mapping
+		// on Windows. The creating side unlinks the name when the segment is closed, mappings of readers stay valid.
+		class Segment
+		{
+		private:
+			std::string name;
+			void* data = nullptr;
+			size_t size = 0;
+			bool owner = false;
+#ifdef _WIN32
+			void* mappingHandle = nullptr;
+#endif
+		public:
+			Segment() = default;
+			Segment(const Segment&) = delete;
+			Segment& operator=(const Segment&) = delete;
+			Segment(Segment&&) = delete;
+			Segment& operator=(Segment&&) = delete;
+
+			// Creates the segment read-write. Fails if a segment of the same name exists, unless replaceExisting,
+			// meant for the leftover of a process that did not close it; readers of the replaced one keep their mapping.
+			// Windows releases a mapping with its last handle, so there is nothing left over to replace.
+			bool create(const std::string& segmentName, size_t segmentSize, bool replaceExisting = false);
+			bool openReadOnly(const std::string& segmentName);
+			void close();
+
+			bool isOpen() const { return data != nullptr; }
+			void* getData() const { return data; }
+			size_t getSize() const { return size; }
+
+			~Segment() { close(); }
+		};
+	}
+}
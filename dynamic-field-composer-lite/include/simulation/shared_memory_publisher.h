@@ -0,0 +1,48 @@
+#pragma once
+
+#include "simulation.h"
+#include "shared_memory_channel.h"
+
+namespace dnf_composer
+{
+	// Publishes components of a simulation to a named shared memory segment, for dashboards, loggers or
+	// controllers in other processes (see SharedMemoryReader). Components are added before open(), which lays
+	// out one fixed slot per component. Each publish() then copies the components into their slots under the
+	// seqlock of the segment, without system calls. Call it after the steps whose frames should be visible.
+	class SharedMemoryPublisher
+	{
+	private:
+		std::shared_ptr<Simulation> simulation;
+		std::string segmentName;
+		std::vector<std::pair<std::string, std::string>> componentIds;
+		// checked before every publish, the components are only read while their elements are in the simulation
+		std::vector<ElementHandle> componentHandles;
+		std::vector<const std::vector<double>*> componentData;
+		std::vector<double*> slotValues;
+		std::vector<size_t> slotSizes;
+		shared_memory::Segment segment;
+		shared_memory::ChannelHeader* header = nullptr;
+	public:
+		SharedMemoryPublisher(std::shared_ptr<Simulation> targetSimulation, std::string segmentName);
+
+		SharedMemoryPublisher(const SharedMemoryPublisher&) = delete;
+		SharedMemoryPublisher& operator=(const SharedMemoryPublisher&) = delete;
+		SharedMemoryPublisher(SharedMemoryPublisher&&) = delete;
+		SharedMemoryPublisher& operator=(SharedMemoryPublisher&&) = delete;
+
+		// False if the element or component does not exist, or if the segment is already open.
+		bool addComponent(const std::string& elementId, const std::string& componentId);
+		// Fails if the segment name is in use, unless replaceExisting for the leftover of a publisher that did not close.
+		bool open(bool replaceExisting = false);
+		// Closes the segment if the element of a component was removed or reset, or a component no longer has the size of its slot.
+		void publish();
+		// Readers keep the last frame, and see that the publisher closed.
+		void close();
+
+		bool isOpen() const;
+		const std::string& getSegmentName() const;
+		int getNumberOfComponents() const;
+
+		~SharedMemoryPublisher();
+	};
+}
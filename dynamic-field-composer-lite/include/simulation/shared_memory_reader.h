@@ -0,0 +1,60 @@
+#pragma once
+
+#include <vector>
+
+#include "shared_memory_channel.h"
+
+namespace dnf_composer
+{
+	struct SharedMemoryFrame
+	{
+		uint64_t number = 0;
+		double time = 0.0;
+		// in the order of the components of the reader
+		std::vector<std::vector<double>> values;
+	};
+
+	// Reads the components a SharedMemoryPublisher of another process publishes. The segment is mapped read-only
+	// and only depends on shared_memory_channel, so it builds without the rest of the library.
+	class SharedMemoryReader
+	{
+	private:
+		shared_memory::Segment segment;
+		const shared_memory::ChannelHeader* header = nullptr;
+		const shared_memory::ChannelSlot* slots = nullptr;
+		uint64_t lastFrameRead = 0;
+		// copies are made here and only handed out once they are consistent
+		SharedMemoryFrame buffer;
+	public:
+		static constexpr int defaultReadAttempts = 1000;
+
+		SharedMemoryReader() = default;
+		SharedMemoryReader(const SharedMemoryReader&) = delete;
+		SharedMemoryReader& operator=(const SharedMemoryReader&) = delete;
+		SharedMemoryReader(SharedMemoryReader&&) = delete;
+		SharedMemoryReader& operator=(SharedMemoryReader&&) = delete;
+
+		// False if there is no segment of that name or its layout is not one this reader understands.
+		bool open(const std::string& segmentName);
+		void close();
+		bool isOpen() const;
+		bool isPublisherOpen() const;
+
+		int getNumberOfComponents() const;
+		std::string getElementId(int index) const;
+		std::string getComponentId(int index) const;
+		int getComponentSize(int index) const;
+		// -1 if the component is not published
+		int findComponent(const std::string& elementId, const std::string& componentId) const;
+
+		// Frames published so far, without copying any values.
+		uint64_t getPublishedFrames() const;
+		// Copies the latest frame, retrying while the publisher writes it. False if no consistent copy was
+		// made within the given attempts, the frame keeps the values of its last successful read then.
+		bool read(SharedMemoryFrame& frame, int attempts = defaultReadAttempts);
+		// Like read, but also false if no frame was published since the last successful read.
+		bool readNext(SharedMemoryFrame& frame, int attempts = defaultReadAttempts);
+
+		~SharedMemoryReader() = default;
+	};
+}
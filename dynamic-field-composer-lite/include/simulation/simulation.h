@@ -5,21 +5,96 @@
 #include <string>
 #include <filesystem>
 #include <chrono>
+#include <unordered_map>
+#include <cstdint>
 
 
 #include "elements/element.h"
+#include "elements/kernel.h"
+#include "simulation/execution_plan.h"
 #include "exceptions/exception.h"
 #include "utilities/utilities.h"
 
 namespace dnf_composer
 {
+	class ExperimentTimeline;
+	struct ExperimentResults;
+
+	// Stable reference to an element of a simulation. The generation is bumped whenever the slot is
+	// released, so a handle to a removed (or reset) element never resolves to a different element.
+	struct ElementHandle
+	{
+		uint32_t slot = invalidSlot;
+		uint32_t generation = 0;
+
+		static constexpr uint32_t invalidSlot = UINT32_MAX;
+
+		bool isValid() const { return slot != invalidSlot; }
+		bool operator==(const ElementHandle& other) const = default;
+	};
+
+	enum class StabilityMeasure
+	{
+		ACTIVATION_CHANGE, // max |activation change| of a step
+		CENTROID_CHANGE    // |centroid change| of a step
+	};
+
+	struct FieldStabilityCriterion
+	{
+		std::string fieldId;
+		StabilityMeasure measure = StabilityMeasure::ACTIVATION_CHANGE;
+		double tolerance = 1e-3;
+	};
+
+	// A simulation is stable once every criterion stays within its tolerance for consecutiveSteps steps.
+	// Without field criteria every neural field is checked for activation change below defaultTolerance.
+	struct StabilityCriteria
+	{
+		std::vector<FieldStabilityCriterion> fields;
+		double defaultTolerance = 1e-3;
+		int consecutiveSteps = 5;
+		int maxSteps = 1000;
+	};
+
 	class Simulation
 	{
 	protected:
+		struct ElementSlot
+		{
+			std::shared_ptr<element::Element> element;
+			uint32_t generation = 0;
+			size_t position = 0; // index in the ordered elements vector
+		};
+
 		bool initialized;
 		bool paused;
+		// Elements in step order. Removed elements leave a nullptr tombstone until the vector is compacted.
 		std::vector<std::shared_ptr<element::Element>> elements;
+		std::vector<ElementSlot> elementSlots;
+		std::vector<uint32_t> freeElementSlots;
+		std::unordered_map<std::string, ElementHandle> elementHandles;
+		// Positions of the tombstones in elements, sorted, so that getElement(int) skips them by binary search.
+		std::vector<size_t> removedPositions;
+		// Kernels that share their KernelData are stepped as one batch at the position of the first of them.
+		// batchOfElement holds the batch of each position in elements, or -1 for elements stepped on their own.
+		bool kernelBatching;
+		bool kernelBatchesOutdated;
+		std::vector<element::KernelBatch> kernelBatches;
+		std::vector<int> batchOfElement;
+		// Bumped by the elements on edits made directly on them. Compared with the revisions the batches were
+		// built at, so such edits rebuild them and changed gains are copied into the plan before the next step.
+		std::shared_ptr<element::ArchitectureRevisions> architectureRevisions;
+		struct PlannedRevisions
+		{
+			uint64_t structure = 0;
+			uint64_t gains = 0;
+		};
+		PlannedRevisions plannedRevisions;
+		// Built together with the kernel batches while the simulation is compiled.
+		bool compiled;
+		std::unique_ptr<ExecutionPlan> executionPlan;
 		std::string uniqueIdentifier;
+		static constexpr uint32_t checkpointMagicNumber = 0x444E4643; // "DNFC"
 	public:
 		double deltaT;
 		double tZero;
@@ -31,21 +106,62 @@ namespace dnf_composer
 		Simulation(Simulation&&) = delete;
 		Simulation& operator=(Simulation&&) = delete;
 
+		// Deep copy of all elements and their connections. Fails (nullptr) if an element cannot be cloned.
+		std::shared_ptr<Simulation> clone() const;
+		// Binary checkpoint of time, parameters and state of every element. Restoring requires
+		// an architecture with the same element names and labels.
+		bool saveCheckpoint(std::ostream& stream) const;
+		bool loadCheckpoint(std::istream& stream);
+
 		void init();
 		void step();
 		void run(double runTime);
+		// Runs an experiment protocol: every element the events name is resolved and every event scheduled to its
+		// step before the first step, so the loop only steps, fires due events and appends recordings. Events still
+		// due are resolved again after each action. The simulation is initialized if needed and left open afterwards.
+		// Incomplete results if an event does not resolve.
+		ExperimentResults run(const ExperimentTimeline& timeline);
+		// Steps until the criteria are met or maxSteps is reached, returns the number of steps taken.
+		int runUntilStable(const StabilityCriteria& criteria);
 		void close();
 		void pause();
 		void resume();
 
-		void addElement(const std::shared_ptr<element::Element>& element);
+		// Batching is on by default. It only regroups work, the results are the same either way.
+		void setKernelBatching(bool enable);
+		bool getKernelBatching() const;
+		int getNumberOfKernelBatches();
+
+		// Freezes the architecture into an ExecutionPlan that step() runs instead of stepping each element.
+		// Edits of the architecture, through the simulation or directly on its elements, rebuild the plan before the next step.
+		void compile();
+		void decompile();
+		bool isCompiled() const;
+		const ExecutionPlan* getExecutionPlan();
+
+		ElementHandle addElement(const std::shared_ptr<element::Element>& element);
 		void removeElement(const std::string& elementId);
+		void removeElement(const ElementHandle& handle);
 		void resetElement(const std::string& idOfElementToReset, const std::shared_ptr<element::Element>& newElement);
 
+		// The stimulus component is scaled by gain before it is summed into the input of the receiving element.
+		// A delay of d steps reads it as it was at the end of the step d steps back, from a delay line of the
+		// stimulus element that the simulation advances after each step.
 		void createInteraction(const std::string& stimulusElementId, const std::string& stimulusComponent, 
-			const std::string& receivingElementId) const;
+			const std::string& receivingElementId, double gain = 1.0, int delay = 0) const;
+		void removeInteraction(const std::string& stimulusElementId, const std::string& receivingElementId) const;
+		// Changes the gain in place, the architecture and a compiled plan are kept.
+		void setInteractionGain(const std::string& stimulusElementId, const std::string& receivingElementId, double gain) const;
+		// Keeps the gain and delay of the interaction.
+		void retargetInteraction(const std::string& stimulusElementId, const std::string& stimulusComponent,
+			const std::string& previousReceivingElementId, const std::string& newReceivingElementId) const;
+		// Re-initializes a single element, leaving the state of every other element untouched.
+		void initElement(const std::string& id);
 
+		ElementHandle getElementHandle(const std::string& id) const;
+		bool isValid(const ElementHandle& handle) const;
 		std::shared_ptr<element::Element> getElement(const std::string& id) const;
+		std::shared_ptr<element::Element> getElement(const ElementHandle& handle) const;
 		std::shared_ptr<element::Element> getElement(int index) const;
 		std::vector<double> getComponent(const std::string& id, const std::string& componentName) const;
 		std::vector<double>* getComponentPtr(const std::string& id, const std::string& componentName) const;
@@ -58,5 +174,14 @@ namespace dnf_composer
 		bool isInitialized() const;
 
 		~Simulation() = default;
+	private:
+		const ElementSlot* findElementSlot(const std::string& id) const;
+		ElementHandle insertElement(const std::shared_ptr<element::Element>& element);
+		void releaseElementSlot(ElementHandle handle);
+		void compactElements();
+		bool areKernelBatchesCurrent() const;
+		// Rebuilds the kernel batches and the plan if they are outdated, otherwise takes over changed gains.
+		void updateKernelBatches();
+		void buildKernelBatches();
 	};
 }
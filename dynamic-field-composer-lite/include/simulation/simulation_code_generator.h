@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <ostream>
+#include <unordered_map>
+
+#include "simulation/simulation.h"
+
+namespace dnf_composer
+{
+	struct SimulationCodeGeneratorParameters
+	{
+		std::string namespaceName = "dnf_generated";
+		std::string className = "Architecture";
+	};
+
+	// Emits a self-contained C++ header for a frozen architecture: field sizes and kernel weights are compile-time
+	// constants, each element becomes a fused loop over std::array buffers and the current state of the simulation
+	// becomes the initial state. The generated class only exposes step(), reset(), read() and centroid().
+	// Elements are stepped and inputs summed in the order of Simulation::compile(), so the generated code follows
+	// the trajectory of the compiled simulation exactly.
+	// Supported: neural fields with sigmoid or heaviside activation, Gauss and Mexican hat kernels with direct
+	// convolution, Gauss stimuli and normal noise. Architecture files are generated by building them first.
+	class SimulationCodeGenerator
+	{
+	private:
+		std::shared_ptr<Simulation> simulation;
+		SimulationCodeGeneratorParameters parameters;
+	public:
+		SimulationCodeGenerator(const std::shared_ptr<Simulation>& simulation, SimulationCodeGeneratorParameters parameters = {});
+
+		// Returns false and logs the reason if an element or connection cannot be generated.
+		bool generate(std::ostream& stream) const;
+		bool generate(const std::string& filePath) const;
+	private:
+		bool isSupported(const std::shared_ptr<element::Element>& element) const;
+		std::string generateElement(size_t index, const std::shared_ptr<element::Element>& element,
+			const std::unordered_map<const element::Element*, size_t>& positions) const;
+	};
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+
+#include "simulation.h"
+#include "elements/neural_field.h"
+
+namespace dnf_composer
+{
+	struct SteadyStateSolverParameters
+	{
+		double tolerance = 1e-6;	// max |h + s + w*f(a) - a| over all fields
+		int maxIterations = 500;
+		double damping = 0.5;		// fraction of the fixed-point update taken per iteration
+		int andersonDepth = 5;		// number of previous iterates used for acceleration, 0 for damped iteration
+	};
+
+	struct SteadyStateResult
+	{
+		bool converged = false;
+		int iterations = 0;
+		double residual = 0.0;
+	};
+
+	// Finds the fixed point a = h + s + w*f(a) of every neural field of a simulation directly, instead of
+	// integrating the transient. Kernels, couplings and Gauss stimuli are evaluated as operators on the field
+	// outputs, noise is left out. Elements with a state of their own, such as memory traces, external inputs and
+	// moving stimuli, are not stepped and enter with their current output. Anderson acceleration is applied to
+	// the damped fixed-point iteration. Delayed connections read the current values, the delay lines are left
+	// filled with the last iterate as if it had been constant.
+	// The search starts from the current state and leaves the simulation at the last iterate.
+	class SteadyStateSolver
+	{
+	private:
+		std::shared_ptr<Simulation> simulation;
+		SteadyStateSolverParameters parameters;
+		std::vector<std::shared_ptr<element::NeuralField>> fields;
+		std::vector<std::shared_ptr<element::Element>> operators;
+		size_t stateSize;
+	public:
+		SteadyStateSolver(const std::shared_ptr<Simulation>& simulation, const SteadyStateSolverParameters& parameters = {});
+
+		SteadyStateResult solve();
+
+		void setParameters(const SteadyStateSolverParameters& parameters);
+		SteadyStateSolverParameters getParameters() const;
+	private:
+		void collectElements();
+		std::vector<double> getState() const;
+		// evaluates h + s + w*f(a) for the concatenated field activations a
+		std::vector<double> evaluate(const std::vector<double>& state) const;
+	};
+}
@@ -2,6 +2,7 @@
 
 #include <string>
 #include <chrono>
+#include <mutex>
 
 #include "./user_interface/user_interface_window.h"
 
@@ -19,6 +20,7 @@ namespace dnf_composer
 			inline static bool				autoScroll = true;  // Keep scrolling if already at the bottom.
 			inline static std::string		windowTitle;
 			inline static bool 				isWindowActive = false;
+			inline static std::mutex		bufferMutex; // addLog() is called from the logger sink thread
 		public:
 			LoggerWindow();
 			static void addLog(const char* message, ...) IM_FMTARGS(3);
@@ -43,6 +43,9 @@ namespace dnf_composer
 			void addElementMexicanHatKernel() const;
 			void addElementNormalNoise() const;
 			void addElementGaussFieldCoupling() const;
+			void addElementMemoryTrace() const;
+			void addElementMovingGaussStimulus() const;
+			void addElementExternalInput() const;
 		};
 	}
 }
@@ -5,6 +5,8 @@
 #include <random>
 #include <sstream>
 #include <fstream>
+#include <type_traits>
+#include <cstdint>
 
 namespace dnf_composer
 {
@@ -44,5 +46,45 @@ namespace dnf_composer
 				for (auto& element : row)
 					element = dis(gen);
 		}
+
+		// Raw binary (de)serialization used by element checkpoints. The layout follows the
+		// in-memory representation, so checkpoints are only portable between identical builds.
+		template <typename T>
+		void writeBinary(std::ostream& stream, const T& value)
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "writeBinary requires a trivially copyable type.");
+			stream.write(reinterpret_cast<const char*>(&value), sizeof(T));
+		}
+
+		template <typename T>
+		void readBinary(std::istream& stream, T& value)
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "readBinary requires a trivially copyable type.");
+			stream.read(reinterpret_cast<char*>(&value), sizeof(T));
+		}
+
+		template <typename T>
+		void writeBinary(std::ostream& stream, const std::vector<T>& values)
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "writeBinary requires a trivially copyable type.");
+			const auto size = static_cast<uint64_t>(values.size());
+			writeBinary(stream, size);
+			stream.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(size * sizeof(T)));
+		}
+
+		template <typename T>
+		void readBinary(std::istream& stream, std::vector<T>& values)
+		{
+			static_assert(std::is_trivially_copyable_v<T>, "readBinary requires a trivially copyable type.");
+			uint64_t size = 0;
+			readBinary(stream, size);
+			if (!stream)
+				return;
+			values.resize(size);
+			stream.read(reinterpret_cast<char*>(values.data()), static_cast<std::streamsize>(size * sizeof(T)));
+		}
+
+		void writeBinary(std::ostream& stream, const std::string& value);
+		void readBinary(std::istream& stream, std::string& value);
 	}
 }
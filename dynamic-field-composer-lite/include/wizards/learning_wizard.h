@@ -1,14 +1,35 @@
 #pragma once
 
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <span>
+
 #include "./simulation/simulation.h"
+#include "./simulation/steady_state_solver.h"
 #include "./elements/neural_field.h"
 #include "./elements/field_coupling.h"
 #include "./elements/gauss_stimulus.h"
+#include "./elements/normal_noise.h"
 #include "utilities/utilities.h"
 
 
 namespace dnf_composer
 {
+	// Normalized field activation patterns recorded by the association phase.
+	// Pattern p occupies [p * size, (p + 1) * size) of the respective contiguous buffer.
+	struct TrainingData
+	{
+		int inputSize = 0;
+		int outputSize = 0;
+		std::vector<double> inputPatterns;
+		std::vector<double> outputPatterns;
+
+		int getNumberOfPatterns() const;
+		void resize(int numberOfPatterns);
+		void clear();
+	};
+
 	class LearningWizard
 	{
 	private:
@@ -23,8 +44,15 @@ namespace dnf_composer
 
 		element::GaussStimulusParameters gaussStimulusParameters = { 15, 3 };
 
-		std::string pathToFieldActivationPre;
-		std::string pathToFieldActivationPost;
+		TrainingData trainingData;
+		std::string pathToTrainingData;
+
+		int numberOfThreads = std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+		// settling phases of every association run until all neural fields are stable
+		StabilityCriteria settlingCriteria = { {}, 1e-2, 10, 300 };
+		// optionally solve for the settled state directly, falling back to time stepping if the solver fails
+		bool useSteadyStateSolver = false;
+		SteadyStateSolverParameters steadyStateSolverParameters;
 
 	public:
 		LearningWizard() = default;
@@ -32,23 +60,39 @@ namespace dnf_composer
 		~LearningWizard() = default;
 
 		void setDataFilePath(const std::string& filePath);
+		void setNumberOfThreads(int numberOfThreads);
+		void setSettlingCriteria(const StabilityCriteria& settlingCriteria);
+		void setSteadyStateSolver(bool useSteadyStateSolver, const SteadyStateSolverParameters& parameters = {});
 
 		void setGaussStimulusParameters(const element::GaussStimulusParameters& gaussStimulusParameters);
 		void setTargetPeakLocationsForNeuralFieldPre(const std::vector<std::vector<double>>& targetPeakLocationsForNeuralFieldPre);
 		void setTargetPeakLocationsForNeuralFieldPost(const std::vector<std::vector<double>>& targetPeakLocationsForNeuralFieldPost);
 
 		void simulateAssociation();
-		void trainWeights(int iterations) const;
+		void trainWeights(int iterations);
 		void saveWeights() const;
-		void clearTargetPeakLocationsFromFiles() const;
+		void clearTargetPeakLocationsFromFiles();
+
+		const TrainingData& getTrainingData() const;
+		bool saveTrainingData() const;
+		bool loadTrainingData();
 
 	private:
 		void setFieldCoupling(const std::string& fieldCouplingUniqueId);
 		void setNeuralFieldPre();
 		void setNeuralFieldPost();
 
-		static std::vector<double> readFieldActivation(const std::string& filename, int line);
-		static void saveFieldActivation(const std::vector<double>* fieldActivation, const std::string& filename);
+		struct AssociationStimuli
+		{
+			std::vector<std::shared_ptr<element::GaussStimulus>> pre;
+			std::vector<std::shared_ptr<element::GaussStimulus>> post;
+		};
+
+		AssociationStimuli addAssociationStimuli(const std::shared_ptr<Simulation>& targetSimulation) const;
+		void simulateAssociation(const std::shared_ptr<Simulation>& targetSimulation, const AssociationStimuli& stimuli, int targetIndex,
+			std::span<double> inputPattern, std::span<double> outputPattern) const;
+
+		void settle(const std::shared_ptr<Simulation>& targetSimulation) const;
 		static std::vector<double> normalizeFieldActivation(std::vector<double>& vec, const double& restingLevel);
 	};
 }
@@ -22,7 +22,82 @@ namespace dnf_composer
 			components["input"] = std::vector<double>(commonParameters.dimensionParameters.size);
 		}
 
-		void Element::addInput(const std::shared_ptr<Element>& inputElement, const std::string& inputComponent)
+		Element::Element(const Element& other)
+			: commonParameters(other.commonParameters), components(other.components), initTime(other.initTime), delayLines(other.delayLines)
+		{
+			// consumers of the copy reserve the lines again when they connect to it
+			for (auto& [component, line] : delayLines)
+				line.forgetReaders();
+		}
+
+		Element::~Element()
+		{
+			for (const InputConnection& input : inputs)
+				input.element->removeConsumer(this, input.component, input.delay);
+		}
+
+		std::shared_ptr<Element> Element::clone() const
+		{
+			const std::string logMessage = "Element '" + commonParameters.identifiers.uniqueName + "' does not support cloning. \n";
+			log(LogLevel::ERROR, logMessage);
+			return nullptr;
+		}
+
+		void Element::copyInputs(const Element& original, const std::unordered_map<const Element*, std::shared_ptr<Element>>& clones)
+		{
+			for (const InputConnection& input : inputs)
+				input.element->removeConsumer(this, input.component, input.delay);
+			inputs.clear();
+			for (const auto& [inputElement, inputComponent, gain, delay] : original.inputs)
+			{
+				const auto clonedInput = clones.find(inputElement.get());
+				// inputs outside of the cloned set stay shared with the original
+				const std::shared_ptr<Element>& input = clonedInput != clones.end() ? clonedInput->second : inputElement;
+				inputs.push_back({ input, inputComponent, gain, delay });
+				input->addConsumer(this, inputComponent, delay);
+			}
+			inputsRevision++;
+			markStructureChanged();
+		}
+
+		void Element::writeState(std::ostream& stream) const
+		{
+			// components are written in name order so that the layout does not depend on hashing
+			std::vector<const std::pair<const std::string, std::vector<double>>*> sortedComponents;
+			sortedComponents.reserve(components.size());
+			for (const auto& component : components)
+				sortedComponents.push_back(&component);
+			std::ranges::sort(sortedComponents, [](const auto* a, const auto* b) { return a->first < b->first; });
+
+			utilities::writeBinary(stream, static_cast<uint32_t>(sortedComponents.size()));
+			for (const auto* component : sortedComponents)
+			{
+				utilities::writeBinary(stream, component->first);
+				utilities::writeBinary(stream, component->second);
+			}
+		}
+
+		void Element::readState(std::istream& stream)
+		{
+			uint32_t numberOfComponents = 0;
+			utilities::readBinary(stream, numberOfComponents);
+			for (uint32_t i = 0; i < numberOfComponents && stream; i++)
+			{
+				std::string componentName;
+				utilities::readBinary(stream, componentName);
+				const auto component = components.find(componentName);
+				if (component == components.end())
+				{
+					const std::string logMessage = "Element '" + commonParameters.identifiers.uniqueName + "' has no component '" + componentName + "' to restore. \n";
+					log(LogLevel::ERROR, logMessage);
+					stream.setstate(std::ios::failbit);
+					return;
+				}
+				utilities::readBinary(stream, component->second);
+			}
+		}
+
+		void Element::addInput(const std::shared_ptr<Element>& inputElement, const std::string& inputComponent, double gain, int delay)
 		{
 			if (!inputElement)
 			{
@@ -32,13 +107,13 @@ namespace dnf_composer
 				//throw Exception(ErrorCode::ELEM_INPUT_IS_NULL, this->getUniqueIdentifier());
 			}
 
-			const auto existingInput = inputs.find(inputElement);
+			const auto existingInput = std::ranges::find(inputs, inputElement, &InputConnection::element);
 			if (existingInput != inputs.end())
 			{
 				const std::string logMessage = "Input '" + inputElement->getUniqueName() + "' already exists. Thus, addInput() method halted. \n";
 				log(LogLevel::ERROR, logMessage);
 				return;
-				//throw Exception(ErrorCode::ELEM_INPUT_ALREADY_EXISTS, existingInput->first->getUniqueIdentifier());
+				//throw Exception(ErrorCode::ELEM_INPUT_ALREADY_EXISTS, existingInput->element->getUniqueIdentifier());
 			}
 
 			if (inputElement->getComponentPtr("output")->size() != this->getComponentPtr("input")->size())
@@ -52,41 +127,66 @@ namespace dnf_composer
 				}
 			}
 
-			inputs[inputElement] = inputComponent;
+			if (delay > 0 && !inputElement->components.contains(inputComponent))
+			{
+				const std::string logMessage = "Input '" + inputElement->getUniqueName() + "' has no component '" + inputComponent + "' to delay. Thus, addInput() method halted. \n";
+				log(LogLevel::ERROR, logMessage);
+				return;
+			}
+			else if (delay < 0)
+			{
+				const std::string logMessage = "Input '" + inputElement->getUniqueName() + "' has a negative delay. Thus, addInput() method halted. \n";
+				log(LogLevel::ERROR, logMessage);
+				return;
+			}
+
+			inputs.push_back({ inputElement, inputComponent, gain, delay });
+			inputElement->addConsumer(this, inputComponent, delay);
+			inputsRevision++;
+			markStructureChanged();
 
-			const std::string logMessage = "Input '" + inputElement->getUniqueName() +"' added successfully to '" +  this->getUniqueName() + ". \n";
-			log(LogLevel::INFO, logMessage);
+			if (isLogLevelEnabled(LogLevel::INFO))
+				log(LogLevel::INFO, "Input '" + inputElement->getUniqueName() + "' added successfully to '" + this->getUniqueName() + ". \n");
 		}
 
-		void Element::removeInput(const std::string& inputElementId)
+		bool Element::removeInput(const std::string& inputElementId)
 		{
-			for (auto& key : inputs | std::views::keys)
+			for (auto input = inputs.begin(); input != inputs.end(); ++input)
 			{
-				if (key->commonParameters.identifiers.uniqueName == inputElementId) {
-					inputs.erase(key);
-					log(LogLevel::INFO, "Input '" + inputElementId + "' removed successfully from '" + this->getUniqueName() + ". \n");
-					return;
+				if (input->element->commonParameters.identifiers.uniqueName == inputElementId) {
+					input->element->removeConsumer(this, input->component, input->delay);
+					inputs.erase(input);
+					inputsRevision++;
+					markStructureChanged();
+					if (isLogLevelEnabled(LogLevel::INFO))
+						log(LogLevel::INFO, "Input '" + inputElementId + "' removed successfully from '" + this->getUniqueName() + ". \n");
+					return true;
 				}
 			}
+			return false;
 		}
 
-		void Element::removeInput(int uniqueId)
+		bool Element::removeInput(int uniqueId)
 		{
-			for (auto& key : inputs | std::views::keys)
+			for (auto input = inputs.begin(); input != inputs.end(); ++input)
 			{
-				if (key->commonParameters.identifiers.uniqueIdentifier == uniqueId) {
-					inputs.erase(key);
-					log(LogLevel::INFO, "Input '" + std::to_string(uniqueId) + "' removed successfully from '" + this->getUniqueName() + ".");
-					return;
+				if (input->element->commonParameters.identifiers.uniqueIdentifier == uniqueId) {
+					input->element->removeConsumer(this, input->component, input->delay);
+					inputs.erase(input);
+					inputsRevision++;
+					markStructureChanged();
+					if (isLogLevelEnabled(LogLevel::INFO))
+						log(LogLevel::INFO, "Input '" + std::to_string(uniqueId) + "' removed successfully from '" + this->getUniqueName() + ".");
+					return true;
 				}
 			}
+			return false;
 		}
 
 		bool Element::hasInput(const std::string& inputElementName, const std::string& inputComponent)
 		{
-			const bool found = std::ranges::any_of(inputs, [&](const auto& pair) {
-				const auto& [key, value] = pair;
-				return key->commonParameters.identifiers.uniqueName == inputElementName && value == inputComponent;
+			const bool found = std::ranges::any_of(inputs, [&](const InputConnection& input) {
+				return input.element->commonParameters.identifiers.uniqueName == inputElementName && input.component == inputComponent;
 				});
 			if (found)
 				return true;
@@ -95,30 +195,110 @@ namespace dnf_composer
 
 		bool Element::hasInput(int inputElementId, const std::string& inputComponent)
 		{
-			const bool found = std::ranges::any_of(inputs, [&](const auto& pair) {
-				const auto& [key, value] = pair;
-				return key->commonParameters.identifiers.uniqueIdentifier == inputElementId && value == inputComponent;
+			const bool found = std::ranges::any_of(inputs, [&](const InputConnection& input) {
+				return input.element->commonParameters.identifiers.uniqueIdentifier == inputElementId && input.component == inputComponent;
 				});
 			if (found)
 				return true;
 			return false;
 		}
 
+		bool Element::setInputGain(const std::string& inputElementName, double gain)
+		{
+			const auto input = std::ranges::find_if(inputs, [&](const InputConnection& connection) {
+				return connection.element->commonParameters.identifiers.uniqueName == inputElementName;
+				});
+			if (input == inputs.end())
+				return false;
+			input->gain = gain;
+			inputsRevision++;
+			markGainsChanged();
+			return true;
+		}
+
 		void Element::updateInput()
 		{
-			std::ranges::fill(components["input"], 0);
+			std::vector<double>& input = components["input"];
+			std::ranges::fill(input, 0);
 
-			for (const auto& input_pair : inputs) {
-				const auto inputElement = input_pair.first;
-				auto inputElementComponent = input_pair.second;
-				auto& inputElementComponents = inputElement->components;
-				const auto& inputElementComponentValue = inputElementComponents.at(inputElementComponent);
+			// a multiply-add per connection, gain 1 leaves the values exactly as a plain sum
+			for (const auto& [values, gain] : getResolvedInputs())
+				for (size_t i = 0; i < values->size(); i++)
+					input[i] += gain * (*values)[i];
+		}
 
-				for (int i = 0; i < inputElementComponentValue.size(); i++)
-				{
-					components["input"][i] += inputElementComponentValue[i];
-				}
-			}
+		void Element::recordDelayLines()
+		{
+			for (auto& [component, line] : delayLines)
+				line.record(components.at(component));
+		}
+
+		void Element::resetDelayLines()
+		{
+			for (auto& [component, line] : delayLines)
+				line.reset(components.at(component));
+		}
+
+		bool Element::hasDelayLines() const
+		{
+			return !delayLines.empty();
+		}
+
+		const DelayLine* Element::getDelayLine(const std::string& componentName) const
+		{
+			const auto line = delayLines.find(componentName);
+			return line != delayLines.end() ? &line->second : nullptr;
+		}
+
+		void DelayLine::reserve(int delay, const std::vector<double>& current)
+		{
+			// push_back on a deque keeps the addresses of the existing frames
+			readers.insert(delay);
+			while (static_cast<int>(frames.size()) < delay)
+				frames.push_back(current);
+		}
+
+		bool DelayLine::release(int delay)
+		{
+			const auto reader = readers.find(delay);
+			if (reader != readers.end())
+				readers.erase(reader);
+			// pop_back keeps the addresses of the frames the remaining readers point at
+			const int maxDelay = readers.empty() ? 0 : *readers.rbegin();
+			while (static_cast<int>(frames.size()) > maxDelay)
+				frames.pop_back();
+			return !readers.empty();
+		}
+
+		void DelayLine::forgetReaders()
+		{
+			readers.clear();
+		}
+
+		void DelayLine::record(const std::vector<double>& current)
+		{
+			if (frames.empty())
+				return;
+			// the oldest frame becomes the newest: swapping the vectors moves no values, only the copy below does
+			for (size_t i = frames.size() - 1; i > 0; i--)
+				frames[i].swap(frames[i - 1]);
+			frames.front() = current;
+		}
+
+		void DelayLine::reset(const std::vector<double>& current)
+		{
+			for (std::vector<double>& frame : frames)
+				frame = current;
+		}
+
+		const std::vector<double>& DelayLine::frame(int delay) const
+		{
+			return frames[delay - 1];
+		}
+
+		int DelayLine::getMaxDelay() const
+		{
+			return static_cast<int>(frames.size());
 		}
 
 		int Element::getMaxSpatialDimension() const
@@ -186,12 +366,84 @@ namespace dnf_composer
 			std::vector<std::shared_ptr<Element>> inputVec;
 			inputVec.reserve(inputs.size());
 
-			for (const auto& key : inputs | std::views::keys)
-				inputVec.push_back(key);
+			for (const InputConnection& input : inputs)
+				inputVec.push_back(input.element);
 
 			return inputVec;
 		}
 
+		const std::vector<InputConnection>& Element::getInputConnections() const
+		{
+			return inputs;
+		}
+
+		std::vector<Element*> Element::getConsumers() const
+		{
+			const std::lock_guard<std::mutex> lock(wiringMutex);
+			return { consumers.begin(), consumers.end() };
+		}
+
+		void Element::setArchitectureRevisions(std::shared_ptr<ArchitectureRevisions> revisions)
+		{
+			architectureRevisions = std::move(revisions);
+		}
+
+		void Element::setInitTime(double t)
+		{
+			initTime = t;
+		}
+
+		void Element::markStructureChanged() const
+		{
+			if (architectureRevisions)
+				architectureRevisions->structure.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		void Element::markGainsChanged() const
+		{
+			if (architectureRevisions)
+				architectureRevisions->gains.fetch_add(1, std::memory_order_relaxed);
+		}
+
+		void Element::addConsumer(Element* consumer, const std::string& component, int delay)
+		{
+			const std::lock_guard<std::mutex> lock(wiringMutex);
+			if (delay > 0)
+				delayLines[component].reserve(delay, components.at(component));
+			consumers.insert(consumer);
+			// consumers keep kernels from being batched across them
+			markStructureChanged();
+		}
+
+		void Element::removeConsumer(Element* consumer, const std::string& component, int delay)
+		{
+			const std::lock_guard<std::mutex> lock(wiringMutex);
+			if (delay > 0)
+			{
+				const auto line = delayLines.find(component);
+				if (line != delayLines.end() && !line->second.release(delay))
+					delayLines.erase(line);
+			}
+			consumers.erase(consumer);
+			markStructureChanged();
+		}
+
+		const std::vector<ResolvedInput>& Element::getResolvedInputs()
+		{
+			if (resolvedInputsRevision != inputsRevision)
+			{
+				resolvedInputs.clear();
+				for (const auto& [inputElement, inputComponent, gain, delay] : inputs)
+				{
+					const std::vector<double>* values = delay > 0 ? &inputElement->delayLines.at(inputComponent).frame(delay)
+						: &inputElement->components.at(inputComponent);
+					resolvedInputs.push_back({ values, gain });
+				}
+				resolvedInputsRevision = inputsRevision;
+			}
+			return resolvedInputs;
+		}
+
 		void Element::printCommonParameters() const
 		{
 			std::ostringstream logStream;
@@ -209,12 +461,14 @@ namespace dnf_composer
 			}
 
 			logStream << std::endl << "Inputs: ";
-			for (const auto& inputPair : inputs)
+			for (const auto& [inputElement, inputComponent, gain, delay] : inputs)
 			{
-				const std::shared_ptr<Element>& inputElement = inputPair.first;
-				const std::string& inputComponent = inputPair.second;
-
-				logStream << inputElement->getUniqueName() << "->" << inputComponent << " | ";
+				logStream << inputElement->getUniqueName() << "->" << inputComponent;
+				if (gain != 1.0)
+					logStream << " x" << gain;
+				if (delay > 0)
+					logStream << " delay " << delay;
+				logStream << " | ";
 			}
 
 			logStream << std::endl;
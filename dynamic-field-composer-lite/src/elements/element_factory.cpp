@@ -46,6 +46,21 @@ namespace dnf_composer
 			{
 				return std::make_shared<FieldCoupling>(elementCommonParameters, elementSpecificParameters.fcp);
 			};
+
+			elementCreators[ElementLabel::MEMORY_TRACE] = [](const ElementCommonParameters& elementCommonParameters, const CompoundElementParameters& elementSpecificParameters)
+			{
+				return std::make_shared<MemoryTrace>(elementCommonParameters, elementSpecificParameters.mtp);
+			};
+
+			elementCreators[ElementLabel::MOVING_GAUSS_STIMULUS] = [](const ElementCommonParameters& elementCommonParameters, const CompoundElementParameters& elementSpecificParameters)
+			{
+				return std::make_shared<MovingGaussStimulus>(elementCommonParameters, elementSpecificParameters.mgsp);
+			};
+
+			elementCreators[ElementLabel::EXTERNAL_INPUT] = [](const ElementCommonParameters& elementCommonParameters, const CompoundElementParameters& elementSpecificParameters)
+			{
+				return std::make_shared<ExternalInput>(elementCommonParameters, elementSpecificParameters.eip);
+			};
 		}
 
 		std::shared_ptr<Element> ElementFactory::create(ElementLabel type, const ElementCommonParameters& elementCommonParameters, const CompoundElementParameters& elementSpecificParameters)
@@ -0,0 +1,216 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+#include "elements/external_input.h"
+
+namespace dnf_composer
+{
+	namespace element
+	{
+		ExternalInput::ExternalInput(const ElementCommonParameters& elementCommonParameters, const ExternalInputParameters& parameters)
+			: Element(elementCommonParameters), parameters(parameters)
+		{
+			if (parameters.capacity <= 0)
+				throw Exception(ErrorCode::ELEM_INVALID_PARAMETER, commonParameters.identifiers.uniqueName);
+			commonParameters.identifiers.label = ElementLabel::EXTERNAL_INPUT;
+			const int size = commonParameters.dimensionParameters.size;
+			queue.resize(parameters.capacity);
+			for (Frame& frame : queue)
+				frame.values.assign(size, 0.0);
+			previousFrame.values.assign(size, 0.0);
+			nextFrame.values.assign(size, 0.0);
+		}
+
+		ExternalInput::ExternalInput(const ExternalInput& other)
+			: Element(other), parameters(other.parameters), queue(other.queue.size()),
+			previousFrame(other.previousFrame), nextFrame(other.nextFrame),
+			hasPreviousFrame(other.hasPreviousFrame), hasNextFrame(other.hasNextFrame),
+			newestTimestamp(other.newestTimestamp), statistics(other.getStatistics())
+		{
+			for (Frame& frame : queue)
+				frame.values.assign(commonParameters.dimensionParameters.size, 0.0);
+			statistics.queuedFrames = 0;
+		}
+
+		void ExternalInput::init()
+		{
+			// frames published before init belong to the previous run
+			readIndex.store(writeIndex.load(std::memory_order_acquire), std::memory_order_release);
+			framesRejected.store(0, std::memory_order_relaxed);
+			std::ranges::fill(components["output"], 0.0);
+			std::ranges::fill(components["input"], 0.0);
+			hasPreviousFrame = false;
+			hasNextFrame = false;
+			newestTimestamp = 0.0;
+			statistics = {};
+		}
+
+		void ExternalInput::step(double t, double deltaT)
+		{
+			const uint64_t read = readIndex.load(std::memory_order_relaxed);
+			const uint64_t available = writeIndex.load(std::memory_order_acquire) - read;
+			std::vector<double>& output = components["output"];
+			uint64_t taken = 0;
+
+			switch (parameters.policy)
+			{
+			case ExternalInputPolicy::LATEST:
+				if (available > 0)
+				{
+					takeFrame(read + available - 1, output);
+					statistics.framesDropped += available - 1;
+					taken = available;
+				}
+				break;
+			case ExternalInputPolicy::HOLD:
+				if (available > 0)
+				{
+					takeFrame(read, output);
+					taken = 1;
+				}
+				break;
+			case ExternalInputPolicy::INTERPOLATE:
+			{
+				// Frames are taken until one lies past the step time, later ones stay queued for the next steps.
+				bool previousTakenThisStep = false;
+				while (taken < available && (!hasNextFrame || nextFrame.timestamp <= t))
+				{
+					if (hasNextFrame)
+					{
+						if (previousTakenThisStep)
+							statistics.framesDropped++;
+						std::swap(previousFrame, nextFrame);
+						hasPreviousFrame = true;
+						previousTakenThisStep = taken > 0;
+					}
+					nextFrame.timestamp = takeFrame(read + taken, nextFrame.values);
+					hasNextFrame = true;
+					taken++;
+				}
+				interpolate(t);
+				break;
+			}
+			}
+
+			if (taken > 0)
+				readIndex.store(read + taken, std::memory_order_release);
+
+			statistics.framesReceived += taken;
+			statistics.stepsWithoutFrame = taken > 0 ? 0 : statistics.stepsWithoutFrame + 1;
+			if (statistics.framesReceived > 0)
+				statistics.age = t - newestTimestamp;
+			statistics.queuedFrames = static_cast<int>(available - taken);
+		}
+
+		void ExternalInput::printParameters()
+		{
+			printCommonParameters();
+
+			std::ostringstream logStream;
+
+			logStream << "Logging specific element parameters" << std::endl;
+			logStream << "Policy: " << static_cast<int>(parameters.policy) << std::endl;
+			logStream << "Capacity: " << parameters.capacity << std::endl;
+
+			log(LogLevel::INFO, logStream.str());
+		}
+
+		std::shared_ptr<Element> ExternalInput::clone() const
+		{
+			return std::make_shared<ExternalInput>(*this);
+		}
+
+		void ExternalInput::writeState(std::ostream& stream) const
+		{
+			// The queue is not part of the state, its capacity stays the one of the constructor.
+			utilities::writeBinary(stream, parameters.policy);
+			utilities::writeBinary(stream, previousFrame.values);
+			utilities::writeBinary(stream, previousFrame.timestamp);
+			utilities::writeBinary(stream, nextFrame.values);
+			utilities::writeBinary(stream, nextFrame.timestamp);
+			utilities::writeBinary(stream, hasPreviousFrame);
+			utilities::writeBinary(stream, hasNextFrame);
+			utilities::writeBinary(stream, newestTimestamp);
+			Element::writeState(stream);
+		}
+
+		void ExternalInput::readState(std::istream& stream)
+		{
+			utilities::readBinary(stream, parameters.policy);
+			utilities::readBinary(stream, previousFrame.values);
+			utilities::readBinary(stream, previousFrame.timestamp);
+			utilities::readBinary(stream, nextFrame.values);
+			utilities::readBinary(stream, nextFrame.timestamp);
+			utilities::readBinary(stream, hasPreviousFrame);
+			utilities::readBinary(stream, hasNextFrame);
+			utilities::readBinary(stream, newestTimestamp);
+			Element::readState(stream);
+		}
+
+		double* ExternalInput::acquireFrame()
+		{
+			const uint64_t written = writeIndex.load(std::memory_order_relaxed);
+			if (written - readIndex.load(std::memory_order_acquire) >= queue.size())
+			{
+				framesRejected.fetch_add(1, std::memory_order_relaxed);
+				return nullptr;
+			}
+			return queue[written % queue.size()].values.data();
+		}
+
+		void ExternalInput::commitFrame(double timestamp)
+		{
+			const uint64_t written = writeIndex.load(std::memory_order_relaxed);
+			queue[written % queue.size()].timestamp = timestamp;
+			writeIndex.store(written + 1, std::memory_order_release);
+		}
+
+		bool ExternalInput::publish(std::span<const double> values, double timestamp)
+		{
+			if (static_cast<int>(values.size()) != commonParameters.dimensionParameters.size)
+				return false;
+			double* frame = acquireFrame();
+			if (frame == nullptr)
+				return false;
+			std::ranges::copy(values, frame);
+			commitFrame(timestamp);
+			return true;
+		}
+
+		ExternalInputParameters ExternalInput::getParameters() const
+		{
+			return parameters;
+		}
+
+		ExternalInputStatistics ExternalInput::getStatistics() const
+		{
+			ExternalInputStatistics current = statistics;
+			current.framesRejected = framesRejected.load(std::memory_order_relaxed);
+			return current;
+		}
+
+		double ExternalInput::takeFrame(uint64_t index, std::vector<double>& destination)
+		{
+			Frame& frame = queue[index % queue.size()];
+			destination.swap(frame.values);
+			newestTimestamp = frame.timestamp;
+			return frame.timestamp;
+		}
+
+		void ExternalInput::interpolate(double t)
+		{
+			if (!hasNextFrame)
+				return;
+			std::vector<double>& output = components["output"];
+			if (!hasPreviousFrame || nextFrame.timestamp <= previousFrame.timestamp)
+			{
+				std::ranges::copy(nextFrame.values, output.begin());
+				return;
+			}
+			const double weight = std::clamp((t - previousFrame.timestamp) / (nextFrame.timestamp - previousFrame.timestamp), 0.0, 1.0);
+			for (size_t i = 0; i < output.size(); i++)
+				output[i] = previousFrame.values[i] + weight * (nextFrame.values[i] - previousFrame.values[i]);
+		}
+	}
+}
@@ -4,6 +4,8 @@
 
 #include "elements/field_coupling.h"
 
+#include <filesystem>
+
 
 namespace dnf_composer
 {
@@ -28,6 +30,8 @@ namespace dnf_composer
 
 			updateAllWeights = true;
 			trained = false;
+			unsavedWeights = false;
+			updateWeightStorage();
 		}
 
 		void FieldCoupling::init()
@@ -39,10 +43,11 @@ namespace dnf_composer
 				trained = true;
 			else
 			{
-				utilities::resizeMatrix(weights, static_cast<int>(components["input"].size()), static_cast<int>(components["output"].size()));
-				utilities::fillMatrixWithRandomValues(weights, 0.0, 0.0);
+				resetWeights();
 				trained = false;
-				writeWeights();
+				// a file that does not match, trained for other field sizes perhaps, is left for the user
+				if (!std::filesystem::exists(weightsFilePath))
+					writeWeights();
 			}
 		}
 
@@ -83,6 +88,21 @@ namespace dnf_composer
 				logStream << "Delta learning rule Krogh and Hertz variation" << std::endl;;
 				break;
 			}
+			logStream << "Weight Storage: ";
+			switch (parameters.weightStorage)
+			{
+			case WeightStorage::DENSE:
+				logStream << "dense" << std::endl;
+				break;
+			case WeightStorage::SPARSE:
+				logStream << "sparse (threshold " << parameters.pruningThreshold << ", max per output " << parameters.maxWeightsPerOutput
+					<< ", density " << sparsityStatistics.density << ", relative error " << sparsityStatistics.relativeError << ")" << std::endl;
+				break;
+			case WeightStorage::LOW_RANK:
+				logStream << "low rank (max rank " << parameters.maxRank << ", rank " << lowRankStatistics.rank
+					<< ", relative error " << lowRankStatistics.relativeError << ")" << std::endl;
+				break;
+			}
 
 			log(LogLevel::INFO, logStream.str());
 		}
@@ -99,13 +119,22 @@ namespace dnf_composer
 
 		void FieldCoupling::computeOutput()
 		{
-			// multiply the input by the weights to get output
-			for (int i = 0; i < components["output"].size(); i++)
-				for (int j = 0; j < components["input"].size(); j++)
-					components["output"][i] += weights[j][i] * components["input"][j];
+			std::vector<double>& output = components["output"];
+			const std::vector<double>& input = components["input"];
+
+			// multiply the input by the weights to get output, the output of the previous step is not carried over
+			std::ranges::fill(output, 0.0);
+			if (parameters.weightStorage == WeightStorage::SPARSE)
+				mathtools::sparseMultiplyAccumulate(sparseWeights, input, output);
+			else if (parameters.weightStorage == WeightStorage::LOW_RANK)
+				mathtools::lowRankMultiplyAccumulate(lowRankWeights, input, output);
+			else
+				for (int i = 0; i < static_cast<int>(output.size()); i++)
+					for (int j = 0; j < static_cast<int>(input.size()); j++)
+						output[i] += weights[j][i] * input[j];
 
 			// only the positive values of the output are considered
-			for (auto& value : components["output"])
+			for (auto& value : output)
 				if (value < 0)
 					value = 0;
 		}
@@ -120,7 +149,22 @@ namespace dnf_composer
 		void FieldCoupling::resetWeights()
 		{
 			// empty weight matrix
+			if (parameters.weightStorage == WeightStorage::LOW_RANK)
+			{
+				lowRankWeights = { static_cast<int>(components["input"].size()), static_cast<int>(components["output"].size()), {}, {} };
+				lowRankStatistics = {};
+				return;
+			}
+			if (parameters.weightStorage == WeightStorage::SPARSE)
+			{
+				const int outputSize = static_cast<int>(components["output"].size());
+				sparseWeights = { outputSize, static_cast<int>(components["input"].size()), std::vector<int>(outputSize + 1, 0), {}, {} };
+				sparsityStatistics = { 0, 0.0, 0.0 };
+				return;
+			}
+			utilities::resizeMatrix(weights, static_cast<int>(components["input"].size()), static_cast<int>(components["output"].size()));
 			utilities::fillMatrixWithRandomValues(weights, 0, 0);
+			updateWeightStorage();
 		}
 
 		void FieldCoupling::setUpdateAllWeights(bool updateAllWeights)
@@ -130,6 +174,24 @@ namespace dnf_composer
 
 		void FieldCoupling::updateWeights(const std::vector<double>& input, const std::vector<double>& output)
 		{
+			if (!unsavedWeights)
+			{
+				const std::string message = "Weights '" + this->getUniqueName() + "' are updated in memory only, call saveWeights() to write them to: " + weightsFilePath + ". \n";
+				log(LogLevel::INFO, message);
+				unsavedWeights = true;
+			}
+
+			if (parameters.weightStorage == WeightStorage::LOW_RANK)
+			{
+				updateLowRankWeights(input, output);
+				return;
+			}
+			if (parameters.weightStorage == WeightStorage::SPARSE)
+			{
+				updateSparseWeights(input, output);
+				return;
+			}
+
 			switch (parameters.learningRule)
 			{
 			case LearningRule::HEBBIAN:
@@ -143,7 +205,7 @@ namespace dnf_composer
 				break;
 			}
 
-			writeWeights();
+			updateWeightStorage();
 		}
 
 		void FieldCoupling::setLearningRate(double learningRate)
@@ -156,12 +218,191 @@ namespace dnf_composer
 			return weights;
 		}
 
+		std::vector<std::vector<double>> FieldCoupling::reconstructWeights() const
+		{
+			// the factors or the sparse matrix are the master copy in those modes, the dense matrix is not kept
+			if (parameters.weightStorage == WeightStorage::LOW_RANK)
+				return mathtools::lowRankToDense(lowRankWeights);
+			if (parameters.weightStorage == WeightStorage::SPARSE)
+				return mathtools::transposedSparseToDense(sparseWeights);
+			return weights;
+		}
+
+		const mathtools::SparseMatrix<double>& FieldCoupling::getSparseWeights() const
+		{
+			return sparseWeights;
+		}
+
+		SparsityStatistics FieldCoupling::getSparsityStatistics() const
+		{
+			return sparsityStatistics;
+		}
+
+		const mathtools::LowRankMatrix<double>& FieldCoupling::getLowRankWeights() const
+		{
+			return lowRankWeights;
+		}
+
+		LowRankStatistics FieldCoupling::getLowRankStatistics() const
+		{
+			return lowRankStatistics;
+		}
+
+		void FieldCoupling::setWeightStorage(WeightStorage weightStorage, double pruningThreshold, int maxWeightsPerOutput)
+		{
+			if (parameters.weightStorage == WeightStorage::LOW_RANK && weightStorage != WeightStorage::LOW_RANK)
+				weights = mathtools::lowRankToDense(lowRankWeights);
+			if (parameters.weightStorage == WeightStorage::SPARSE)
+				weights = mathtools::transposedSparseToDense(sparseWeights);
+
+			const bool factorize = weightStorage == WeightStorage::LOW_RANK && parameters.weightStorage != WeightStorage::LOW_RANK;
+			parameters.weightStorage = weightStorage;
+			parameters.pruningThreshold = pruningThreshold;
+			parameters.maxWeightsPerOutput = maxWeightsPerOutput;
+			if (weightStorage != WeightStorage::LOW_RANK || factorize)
+				updateWeightStorage();
+		}
+
+		void FieldCoupling::setMaxRank(int maxRank)
+		{
+			parameters.maxRank = maxRank;
+			if (parameters.weightStorage == WeightStorage::LOW_RANK && lowRankWeights.getRank() > getEffectiveMaxRank())
+			{
+				lowRankStatistics.relativeError = mathtools::truncateLowRank(lowRankWeights, getEffectiveMaxRank());
+				lowRankStatistics.rank = lowRankWeights.getRank();
+			}
+		}
+
+		int FieldCoupling::getEffectiveMaxRank() const
+		{
+			// a non-positive maximum rank means the rank is only bounded by the matrix size
+			if (parameters.maxRank > 0)
+				return parameters.maxRank;
+			return std::min(static_cast<int>(components.at("input").size()), static_cast<int>(components.at("output").size()));
+		}
+
+		void FieldCoupling::updateWeightStorage()
+		{
+			if (parameters.weightStorage != WeightStorage::SPARSE)
+			{
+				sparseWeights = {};
+				sparsityStatistics = {};
+			}
+			if (parameters.weightStorage != WeightStorage::LOW_RANK)
+			{
+				lowRankWeights = {};
+				lowRankStatistics = {};
+			}
+
+			switch (parameters.weightStorage)
+			{
+			case WeightStorage::DENSE:
+				break;
+			case WeightStorage::SPARSE:
+				pruneWeights();
+				break;
+			case WeightStorage::LOW_RANK:
+				factorizeWeights();
+				break;
+			}
+		}
+
+		void FieldCoupling::factorizeWeights()
+		{
+			double relativeError = 0.0;
+			lowRankWeights = mathtools::denseToLowRank(weights, getEffectiveMaxRank(), &relativeError);
+			lowRankWeights.rows = static_cast<int>(components["input"].size());
+			lowRankWeights.cols = static_cast<int>(components["output"].size());
+			lowRankStatistics.rank = lowRankWeights.getRank();
+			lowRankStatistics.relativeError = relativeError;
+
+			// the factors become the master copy, release the dense matrix
+			std::vector<std::vector<double>>().swap(weights);
+
+			const std::string message = "Factorized weights '" + this->getUniqueName() + "' to rank " + std::to_string(lowRankStatistics.rank) +
+				" (relative error " + std::to_string(lowRankStatistics.relativeError) + "). \n";
+			log(LogLevel::DEBUG, message);
+		}
+
+		void FieldCoupling::updateLowRankWeights(const std::vector<double>& input, const std::vector<double>& output)
+		{
+			switch (parameters.learningRule)
+			{
+			case LearningRule::HEBBIAN:
+				lowRankWeights = mathtools::hebbLearningRuleLowRank(input, output, parameters.learningRate);
+				break;
+			case LearningRule::DELTA_WIDROW_HOFF:
+				mathtools::deltaLearningRuleWidrowHoffLowRank(lowRankWeights, input, output, parameters.learningRate);
+				break;
+			case LearningRule::DELTA_KROGH_HERTZ:
+				mathtools::deltaLearningRuleKroghHertzLowRank(lowRankWeights, input, output, parameters.learningRate);
+				break;
+			}
+
+			// each update adds one rank-1 term, recompress once the rank budget is exceeded
+			lowRankStatistics.relativeError = 0.0;
+			if (lowRankWeights.getRank() > getEffectiveMaxRank())
+				lowRankStatistics.relativeError = mathtools::truncateLowRank(lowRankWeights, getEffectiveMaxRank());
+			lowRankStatistics.rank = lowRankWeights.getRank();
+		}
+
+		void FieldCoupling::updateSparseWeights(const std::vector<double>& input, const std::vector<double>& output)
+		{
+			switch (parameters.learningRule)
+			{
+			case LearningRule::HEBBIAN:
+				sparseWeights = mathtools::hebbLearningRuleSparse(input, output, parameters.learningRate,
+					parameters.pruningThreshold, parameters.maxWeightsPerOutput);
+				break;
+			case LearningRule::DELTA_WIDROW_HOFF:
+				mathtools::deltaLearningRuleWidrowHoffSparse(sparseWeights, input, output, parameters.learningRate,
+					parameters.pruningThreshold, parameters.maxWeightsPerOutput);
+				break;
+			case LearningRule::DELTA_KROGH_HERTZ:
+				mathtools::deltaLearningRuleKroghHertzSparse(sparseWeights, input, output, parameters.learningRate,
+					parameters.pruningThreshold, parameters.maxWeightsPerOutput);
+				break;
+			}
+
+			// the error against the dense rule is only known when pruning a dense matrix, it is kept from the last pruning
+			const double numberOfWeights = static_cast<double>(sparseWeights.rows) * static_cast<double>(sparseWeights.cols);
+			sparsityStatistics.numberOfNonZeros = sparseWeights.getNumberOfNonZeros();
+			sparsityStatistics.density = numberOfWeights > 0 ? sparsityStatistics.numberOfNonZeros / numberOfWeights : 0.0;
+		}
+
+		void FieldCoupling::pruneWeights()
+		{
+			sparseWeights = mathtools::pruneToTransposedSparse(weights, parameters.pruningThreshold, parameters.maxWeightsPerOutput);
+
+			// The Frobenius norm of the pruned part bounds the output error for any input: ||(W - W_s)x|| <= ||W - W_s||_F ||x||
+			double keptNorm = 0.0;
+			for (const double value : sparseWeights.values)
+				keptNorm += value * value;
+			double fullNorm = 0.0;
+			for (const auto& row : weights)
+				for (const double value : row)
+					fullNorm += value * value;
+
+			const double numberOfWeights = static_cast<double>(sparseWeights.rows) * static_cast<double>(sparseWeights.cols);
+			sparsityStatistics.numberOfNonZeros = sparseWeights.getNumberOfNonZeros();
+			sparsityStatistics.density = numberOfWeights > 0 ? sparsityStatistics.numberOfNonZeros / numberOfWeights : 0.0;
+			sparsityStatistics.relativeError = fullNorm > 0 ? std::sqrt(std::max(fullNorm - keptNorm, 0.0) / fullNorm) : 0.0;
+
+			// the sparse matrix becomes the master copy, release the dense matrix
+			std::vector<std::vector<double>>().swap(weights);
+
+			const std::string message = "Pruned weights '" + this->getUniqueName() + "' to " + std::to_string(sparsityStatistics.numberOfNonZeros) +
+				" non-zeros (density " + std::to_string(sparsityStatistics.density) + ", relative error " + std::to_string(sparsityStatistics.relativeError) + "). \n";
+			log(LogLevel::DEBUG, message);
+		}
+
 		bool FieldCoupling::readWeights()
 		{
 			std::ifstream file(weightsFilePath); 
 
 			if (file.is_open()) {
-				utilities::resizeMatrix(weights, 0, 0);
+				// read aside, so a file that does not match leaves the current weights as they are
+				std::vector<std::vector<double>> readMatrix;
 				double element;
 				std::vector<double> row;
 				while (file >> element) 
@@ -169,11 +410,20 @@ namespace dnf_composer
 					row.push_back(element);  
 					if (row.size() == components["output"].size())
 					{
-						weights.push_back(row);  
+						readMatrix.push_back(row);  
 						row.clear(); 
 					}
 				}
 				file.close();
+				if (readMatrix.size() != components["input"].size() || !row.empty())
+				{
+					const std::string message = "Failed to read weights '" + this->getUniqueName() + "' from: " + weightsFilePath + ". The stored matrix does not match the field sizes, the file is left unchanged. \n";
+					log(LogLevel::ERROR, message);
+					return false;
+				}
+				weights = std::move(readMatrix);
+				updateWeightStorage();
+				unsavedWeights = false;
 				const std::string message = "Weights '" + this->getUniqueName() + "' read successfully from: " + weightsFilePath + ". \n";
 				log(LogLevel::INFO, message);
 				return true;
@@ -190,7 +440,11 @@ namespace dnf_composer
 			std::ofstream file(weightsFilePath);
 
 			if (file.is_open()) {
-				for (const auto& row : weights) {
+				std::vector<std::vector<double>> reconstructedWeights;
+				if (parameters.weightStorage != WeightStorage::DENSE)
+					reconstructedWeights = reconstructWeights();
+				const auto& denseWeights = parameters.weightStorage != WeightStorage::DENSE ? reconstructedWeights : weights;
+				for (const auto& row : denseWeights) {
 					for (const auto& element : row) {
 						file << element << " ";  
 					}
@@ -207,14 +461,97 @@ namespace dnf_composer
 			}
 		}
 
-		void FieldCoupling::saveWeights() const
+		void FieldCoupling::saveWeights()
 		{
 			writeWeights();
+			unsavedWeights = false;
 		}
 
 		void FieldCoupling::setWeightsFilePath(const std::string& filePath)
 		{
 			weightsFilePath = filePath + "/" + commonParameters.identifiers.uniqueName + "_weights.txt";
 		}
+	
+
+		std::shared_ptr<Element> FieldCoupling::clone() const
+		{
+			return std::make_shared<FieldCoupling>(*this);
+		}
+
+		void FieldCoupling::writeState(std::ostream& stream) const
+		{
+			utilities::writeBinary(stream, parameters);
+			utilities::writeBinary(stream, trained);
+			utilities::writeBinary(stream, updateAllWeights);
+
+			// the master copy of the weights
+			if (parameters.weightStorage == WeightStorage::SPARSE)
+			{
+				utilities::writeBinary(stream, sparsityStatistics);
+				utilities::writeBinary(stream, sparseWeights.rowOffsets);
+				utilities::writeBinary(stream, sparseWeights.columnIndices);
+				utilities::writeBinary(stream, sparseWeights.values);
+			}
+			else if (parameters.weightStorage == WeightStorage::LOW_RANK)
+			{
+				utilities::writeBinary(stream, static_cast<uint32_t>(lowRankWeights.getRank()));
+				for (int k = 0; k < lowRankWeights.getRank(); k++)
+				{
+					utilities::writeBinary(stream, lowRankWeights.left[k]);
+					utilities::writeBinary(stream, lowRankWeights.right[k]);
+				}
+			}
+			else
+			{
+				utilities::writeBinary(stream, static_cast<uint32_t>(weights.size()));
+				for (const auto& row : weights)
+					utilities::writeBinary(stream, row);
+			}
+
+			Element::writeState(stream);
+		}
+
+		void FieldCoupling::readState(std::istream& stream)
+		{
+			uint32_t numberOfVectors = 0;
+			utilities::readBinary(stream, parameters);
+			utilities::readBinary(stream, trained);
+			utilities::readBinary(stream, updateAllWeights);
+
+			if (parameters.weightStorage == WeightStorage::SPARSE)
+			{
+				utilities::readBinary(stream, sparsityStatistics);
+				sparseWeights = { static_cast<int>(components["output"].size()), static_cast<int>(components["input"].size()), {}, {}, {} };
+				utilities::readBinary(stream, sparseWeights.rowOffsets);
+				utilities::readBinary(stream, sparseWeights.columnIndices);
+				utilities::readBinary(stream, sparseWeights.values);
+				lowRankWeights = {};
+				std::vector<std::vector<double>>().swap(weights);
+			}
+			else if (parameters.weightStorage == WeightStorage::LOW_RANK)
+			{
+				utilities::readBinary(stream, numberOfVectors);
+				lowRankWeights = { static_cast<int>(components["input"].size()), static_cast<int>(components["output"].size()), {}, {} };
+				lowRankWeights.left.resize(numberOfVectors);
+				lowRankWeights.right.resize(numberOfVectors);
+				for (uint32_t k = 0; k < numberOfVectors && stream; k++)
+				{
+					utilities::readBinary(stream, lowRankWeights.left[k]);
+					utilities::readBinary(stream, lowRankWeights.right[k]);
+				}
+				lowRankStatistics.rank = lowRankWeights.getRank();
+				std::vector<std::vector<double>>().swap(weights);
+			}
+			else
+			{
+				utilities::readBinary(stream, numberOfVectors);
+				weights.resize(numberOfVectors);
+				for (uint32_t i = 0; i < numberOfVectors && stream; i++)
+					utilities::readBinary(stream, weights[i]);
+				updateWeightStorage();
+			}
+
+			Element::readState(stream);
+		}
 	}
 }
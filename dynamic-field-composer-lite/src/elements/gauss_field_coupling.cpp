@@ -86,5 +86,27 @@ namespace dnf_composer
 		{
 			return parameters;
 		}
+	
+
+		std::shared_ptr<Element> GaussFieldCoupling::clone() const
+		{
+			return std::make_shared<GaussFieldCoupling>(*this);
+		}
+
+		void GaussFieldCoupling::writeState(std::ostream& stream) const
+		{
+			utilities::writeBinary(stream, parameters.inputFieldSize);
+			utilities::writeBinary(stream, parameters.sigma);
+			utilities::writeBinary(stream, parameters.couplings);
+			Element::writeState(stream);
+		}
+
+		void GaussFieldCoupling::readState(std::istream& stream)
+		{
+			utilities::readBinary(stream, parameters.inputFieldSize);
+			utilities::readBinary(stream, parameters.sigma);
+			utilities::readBinary(stream, parameters.couplings);
+			Element::readState(stream);
+		}
 	}
 }
\ No newline at end of file
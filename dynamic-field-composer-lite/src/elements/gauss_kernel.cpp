@@ -12,63 +12,34 @@ namespace dnf_composer
 			: Kernel(elementCommonParameters), parameters(gk_parameters)
 		{
 			commonParameters.identifiers.label = ElementLabel::GAUSS_KERNEL;
-			components["kernel"] = std::vector<double>(commonParameters.dimensionParameters.size);
 		}
 
 		void GaussKernel::init()
 		{
-			kernelRange = mathtools::computeKernelRange(parameters.sigma, cutOfFactor, commonParameters.dimensionParameters.size, circular);
+			acquireKernelData(parameters.sigma, { { parameters.sigma, parameters.amplitude } });
 
-			if (circular)
-				extIndex = mathtools::createExtendedIndex(commonParameters.dimensionParameters.size, kernelRange);
-			else
-			{
-				const std::string message = "Tried to initialize a non-circular Mexican hat kernel '" + this->getUniqueName() + "'. That is not supported yet.\n";
-				log(LogLevel::ERROR, message);
-			}
-
-			int rangeXsize = kernelRange[0] + kernelRange[1] + 1;
-			std::vector<int> rangeX(rangeXsize);
-			const int startingValue = static_cast<int>(kernelRange[0]);
-			std::iota(rangeX.begin(), rangeX.end(), -startingValue);
-			std::vector<double> gauss(commonParameters.dimensionParameters.size);
-			if (!normalized)
-				gauss = mathtools::gaussNorm(rangeX, 0.0, parameters.sigma);
-			else
-			{
-				const std::string message = "Tried to initialize a normalized Mexican hat kernel '" + this->getUniqueName() + "'. That is not supported yet.\n";
-				log(LogLevel::ERROR, message);
-			}
-
-			components["kernel"].resize(rangeX.size());
-			for (int i = 0; i < components["kernel"].size(); i++)
-				components["kernel"][i] = parameters.amplitude * gauss[i];
-
-			components["input"].resize(extIndex.size());
 			fullSum = 0;
 			std::ranges::fill(components["input"], 0.0);
 		}
 
 		void GaussKernel::step(double t, double deltaT)
 		{
-
-			updateInput();
-
-			fullSum = std::accumulate(components["input"].begin(), components["input"].end(), (double)0.0);
+			updateKernelInput();
 
 			std::vector<double> convolution(commonParameters.dimensionParameters.size);
-			const std::vector<double> subDataInput = mathtools::obtainCircularVector(extIndex, components["input"]);
-
-
-			if (circular)
-				convolution = mathtools::conv_valid(subDataInput, components["kernel"]);
+			if (usesRecursiveConvolution())
+				convolution = recursiveGaussConvolution(parameters.sigma, parameters.amplitude);
 			else
-				convolution = mathtools::conv(subDataInput, components["kernel"]);
+				convolution = directConvolution(components["input"]);
 
+			writeOutput(convolution);
+		}
+
+		void GaussKernel::writeOutput(const std::vector<double>& convolution)
+		{
 			for (int i = 0; i < components["output"].size(); i++)
 				components["output"][i] = convolution[i] + parameters.amplitudeGlobal * fullSum;
 				//commonParameters.dimensionParameters.d_x;
-
 		}
 
 		void GaussKernel::close()
@@ -87,7 +58,8 @@ namespace dnf_composer
 			logStream << "Sigma: " << parameters.sigma << std::endl;
 			logStream << "Cut-Off Factor: " << cutOfFactor << std::endl;
 			logStream << "Circular: " << circular << std::endl;
-			logStream << "Normalized: " << normalized << std::endl;
+			logStream << "Recursive convolution: " << usesRecursiveConvolution() << std::endl;
+			logStream << "Border compensation: " << borderCompensation << std::endl;
 
 			log(LogLevel::INFO, logStream.str());
 		}
@@ -102,5 +74,27 @@ namespace dnf_composer
 		{
 			return parameters;
 		}
+	
+
+		std::shared_ptr<Element> GaussKernel::clone() const
+		{
+			return std::make_shared<GaussKernel>(*this);
+		}
+
+		void GaussKernel::writeState(std::ostream& stream) const
+		{
+			utilities::writeBinary(stream, parameters);
+			Element::writeState(stream);
+		}
+
+		void GaussKernel::readState(std::istream& stream)
+		{
+			GaussKernelParameters storedParameters = parameters;
+			utilities::readBinary(stream, storedParameters);
+			// the kernel data only needs to be looked up again if the parameters changed
+			if (!(storedParameters == parameters))
+				setParameters(storedParameters);
+			Kernel::readState(stream);
+		}
 	}
 }
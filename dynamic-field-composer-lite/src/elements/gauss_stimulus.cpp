@@ -19,29 +19,9 @@ namespace dnf_composer
 
 		void GaussStimulus::init()
 		{
-			std::vector<double> g(commonParameters.dimensionParameters.size);
-
-			if (parameters.circular)
-				g = mathtools::circularGauss(commonParameters.dimensionParameters.size, parameters.sigma, parameters.position);
-			else
-			{
-				const std::string message = "Tried to initialize a non-circular Gaussian stimulus '" + this->getUniqueName() + "'. That is not supported yet. \n";
-				log(LogLevel::ERROR, message);
-			}
-
-			if (!parameters.normalized)
-				for (int i = 0; i < commonParameters.dimensionParameters.size; i++)
-					components["output"][i] = parameters.amplitude * g[i];
-			else
-			{
-				const std::string message = "Tried to initialize a normalized Gaussian stimulus '" + this->getUniqueName() + "'. That is not supported yet. \n";
-				log(LogLevel::ERROR, message);
-			}
-
 			components["input"] = std::vector<double>(commonParameters.dimensionParameters.size);
 			updateInput();
-			for (int i = 0; i < commonParameters.dimensionParameters.size; i++)
-				components["output"][i] += components["input"][i];
+			updateOutput();
 		}
 
 		void GaussStimulus::step(double t, double deltaT)
@@ -78,5 +58,74 @@ namespace dnf_composer
 		{
 			return parameters;
 		}
+
+		void GaussStimulus::setPosition(double position)
+		{
+			if (position < 0 || position >= commonParameters.dimensionParameters.x_max)
+				throw Exception(ErrorCode::GAUSS_STIMULUS_POSITION_OUT_OF_RANGE, commonParameters.identifiers.uniqueName);
+
+			// only the output is recomputed, the inputs are left as they are
+			parameters.position = position;
+			updateOutput();
+		}
+
+		void GaussStimulus::setAmplitude(double amplitude)
+		{
+			parameters.amplitude = amplitude;
+			updateOutput();
+		}
+
+		void GaussStimulus::updateOutput()
+		{
+			if (parameters.circular && !parameters.normalized)
+			{
+				// amplitude * g + input in a single pass, without the Gaussian as a temporary
+				using namespace mathtools::expressions;
+				const auto g = mathtools::circularGaussExpression(commonParameters.dimensionParameters.size, parameters.sigma, parameters.position);
+				evaluate(parameters.amplitude * g + view(components["input"]), components["output"]);
+				return;
+			}
+
+			std::vector<double> g(commonParameters.dimensionParameters.size);
+
+			if (parameters.circular)
+				g = mathtools::circularGauss(commonParameters.dimensionParameters.size, parameters.sigma, parameters.position);
+			else
+			{
+				const std::string message = "Tried to initialize a non-circular Gaussian stimulus '" + this->getUniqueName() + "'. That is not supported yet. \n";
+				log(LogLevel::ERROR, message);
+			}
+
+			if (!parameters.normalized)
+				for (int i = 0; i < commonParameters.dimensionParameters.size; i++)
+					components["output"][i] = parameters.amplitude * g[i];
+			else
+			{
+				const std::string message = "Tried to initialize a normalized Gaussian stimulus '" + this->getUniqueName() + "'. That is not supported yet. \n";
+				log(LogLevel::ERROR, message);
+			}
+
+			for (int i = 0; i < commonParameters.dimensionParameters.size; i++)
+				components["output"][i] += components["input"][i];
+		}
+	
+
+		std::shared_ptr<Element> GaussStimulus::clone() const
+		{
+			return std::make_shared<GaussStimulus>(*this);
+		}
+
+		void GaussStimulus::writeState(std::ostream& stream) const
+		{
+			utilities::writeBinary(stream, parameters);
+			Element::writeState(stream);
+		}
+
+		void GaussStimulus::readState(std::istream& stream)
+		{
+			// the output is restored with the components, no re-initialization is needed
+			utilities::readBinary(stream, parameters);
+			Element::readState(stream);
+		}
 	}
 }
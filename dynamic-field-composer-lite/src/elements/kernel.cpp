@@ -4,6 +4,8 @@
 
 #include "elements/kernel.h"
 
+#include <numeric>
+
 namespace dnf_composer
 {
 	namespace element
@@ -13,7 +15,7 @@ namespace dnf_composer
 
 		{
 			circular = true;
-			normalized = false;
+			borderCompensation = false;
 			kernelRange = { 0, 0 };
 			fullSum = 0.0;
 			cutOfFactor = 5;
@@ -25,9 +27,27 @@ namespace dnf_composer
 			return circular;
 		}
 
-		bool Kernel::getNormalized() const
+		bool Kernel::getBorderCompensation() const
+		{
+			return borderCompensation;
+		}
+
+		void Kernel::setCircular(bool circular)
 		{
-			return normalized;
+			this->circular = circular;
+			if (!circular && convolutionMethod == ConvolutionMethod::RECURSIVE)
+			{
+				const std::string message = "Recursive convolution of kernel '" + this->getUniqueName() + "' requires circular boundaries, switching to the direct convolution.\n";
+				log(LogLevel::WARNING, message);
+				convolutionMethod = ConvolutionMethod::DIRECT;
+			}
+			init();
+		}
+
+		void Kernel::setBorderCompensation(bool borderCompensation)
+		{
+			this->borderCompensation = borderCompensation;
+			init();
 		}
 
 		std::array<int, 2> Kernel::getKernelRange() const
@@ -35,9 +55,230 @@ namespace dnf_composer
 			return kernelRange;
 		}
 
-		std::vector<int> Kernel::getExtIndex() const
+		std::shared_ptr<const KernelData> Kernel::getKernelData() const
+		{
+			return kernelData;
+		}
+
+		const KernelData* Kernel::getKernelDataPtr() const
+		{
+			return kernelData.get();
+		}
+
+		void Kernel::acquireKernelData(double rangeSigma, const std::vector<std::array<double, 2>>& gaussians)
+		{
+			KernelCacheKey key{ commonParameters.identifiers.label, { rangeSigma }, commonParameters.dimensionParameters.size, circular, borderCompensation, cutOfFactor };
+			for (const auto& [sigma, amplitude] : gaussians)
+			{
+				key.parameters.push_back(sigma);
+				key.parameters.push_back(amplitude);
+			}
+
+			const KernelData* previousData = kernelData.get();
+			kernelData = KernelCache::get(key, [&]
+				{
+					KernelData data;
+					const int size = commonParameters.dimensionParameters.size;
+					data.kernelRange = mathtools::computeKernelRange(rangeSigma, cutOfFactor, size, circular);
+
+					std::vector<int> rangeX(data.kernelRange[0] + data.kernelRange[1] + 1);
+					std::iota(rangeX.begin(), rangeX.end(), -data.kernelRange[0]);
+					data.weights.assign(rangeX.size(), 0.0);
+					for (const auto& [sigma, amplitude] : gaussians)
+					{
+						const std::vector<double> gauss = mathtools::gaussNorm(rangeX, 0.0, sigma);
+						for (size_t i = 0; i < gauss.size(); i++)
+							data.weights[i] += amplitude * gauss[i];
+					}
+
+					// circular kernels always lie fully inside the field, so only non-circular ones need a correction;
+					// absolute weights keep the share well defined for kernels whose weights sum to about zero
+					if (borderCompensation && !circular)
+					{
+						std::vector<double> magnitude(data.weights.size());
+						std::ranges::transform(data.weights, magnitude.begin(), [](double weight) { return std::abs(weight); });
+						std::vector<double> coverage;
+						mathtools::kernelConvolution(std::vector<double>(size, 1.0), magnitude, data.kernelRange, false, coverage);
+						const double total = std::accumulate(magnitude.begin(), magnitude.end(), 0.0);
+						data.borderScale.resize(size);
+						for (int i = 0; i < size; i++)
+							data.borderScale[i] = coverage[i] > 0.0 ? total / coverage[i] : 1.0;
+					}
+					return data;
+				});
+
+			kernelRange = kernelData->kernelRange;
+			updateKernelComponent();
+			// kernels are batched by their data
+			if (kernelData.get() != previousData)
+				markStructureChanged();
+		}
+
+		void Kernel::updateKernelComponent()
+		{
+			if (!kernelData)
+				return;
+			std::vector<double>& kernel = components["kernel"];
+			if (kernelComponentRequested)
+				kernel = kernelData->weights;
+			else
+				kernel = {};
+		}
+
+		std::vector<double> Kernel::getComponent(const std::string& componentName)
+		{
+			if (componentName == "kernel" && !kernelComponentRequested)
+			{
+				kernelComponentRequested = true;
+				updateKernelComponent();
+			}
+			return Element::getComponent(componentName);
+		}
+
+		std::vector<double>* Kernel::getComponentPtr(const std::string& componentName)
+		{
+			if (componentName == "kernel" && !kernelComponentRequested)
+			{
+				kernelComponentRequested = true;
+				updateKernelComponent();
+			}
+			return Element::getComponentPtr(componentName);
+		}
+
+		void Kernel::readState(std::istream& stream)
+		{
+			Element::readState(stream);
+			updateKernelComponent();
+		}
+
+		void Kernel::setConvolutionMethod(ConvolutionMethod method)
+		{
+			if (method == ConvolutionMethod::RECURSIVE && !circular)
+			{
+				const std::string message = "Recursive convolution of kernel '" + this->getUniqueName() + "' requires circular boundaries, the direct convolution is kept.\n";
+				log(LogLevel::WARNING, message);
+				return;
+			}
+			if (method != convolutionMethod)
+				markStructureChanged();
+			convolutionMethod = method;
+		}
+
+		ConvolutionMethod Kernel::getConvolutionMethod() const
+		{
+			return convolutionMethod;
+		}
+
+		bool Kernel::isBatchable() const
+		{
+			return kernelData && !usesRecursiveConvolution();
+		}
+
+		void Kernel::stepBatch(KernelBatch& batch)
+		{
+			const size_t numberOfKernels = batch.kernels.size();
+			const KernelData& data = *batch.data;
+			const int numberOfWeights = static_cast<int>(data.weights.size());
+			const int size = batch.kernels.front()->commonParameters.dimensionParameters.size;
+			const bool circular = batch.kernels.front()->circular;
+
+			// the inputs are interleaved so the innermost loop runs over the kernels
+			batch.input.resize(size * numberOfKernels);
+			for (size_t k = 0; k < numberOfKernels; k++)
+			{
+				Kernel* kernel = batch.kernels[k];
+				if (batch.resolvedInput.empty())
+					kernel->updateKernelInput();
+				else
+					kernel->sumResolvedInputs(*batch.resolvedInput[k], batch.resolvedInputValues[k]);
+				const std::vector<double>& input = batch.resolvedInput.empty() ? kernel->components["input"] : *batch.resolvedInput[k];
+				for (int i = 0; i < size; i++)
+					batch.input[i * numberOfKernels + k] = input[i];
+			}
+
+			// same weights, positions and summation order as mathtools::kernelConvolution
+			batch.convolution.assign(size * numberOfKernels, 0.0);
+			for (int i = 0; i < size; i++)
+			{
+				double* output = &batch.convolution[i * numberOfKernels];
+				const int first = i - data.kernelRange[1];
+				int begin = 0, end = numberOfWeights;
+				if (!circular)
+				{
+					begin = std::max(0, -first);
+					end = std::min(numberOfWeights, size - first);
+				}
+				int index = (first + begin) % size;
+				if (index < 0)
+					index += size;
+				for (int w = begin; w < end; w++)
+				{
+					const double weight = data.weights[numberOfWeights - 1 - w];
+					const double* input = &batch.input[index * numberOfKernels];
+					for (size_t k = 0; k < numberOfKernels; k++)
+						output[k] += weight * input[k];
+					if (++index == size)
+						index = 0;
+				}
+			}
+
+			batch.column.resize(size);
+			for (size_t k = 0; k < numberOfKernels; k++)
+			{
+				for (int i = 0; i < size; i++)
+					batch.column[i] = batch.convolution[i * numberOfKernels + k];
+				if (!data.borderScale.empty())
+					for (int i = 0; i < size; i++)
+						batch.column[i] *= data.borderScale[i];
+				batch.kernels[k]->writeOutput(batch.column);
+			}
+		}
+
+		void Kernel::updateKernelInput()
+		{
+			updateInput();
+			fullSum = std::accumulate(components["input"].begin(), components["input"].end(), 0.0);
+		}
+
+		bool Kernel::usesRecursiveConvolution() const
+		{
+			return convolutionMethod == ConvolutionMethod::RECURSIVE && circular;
+		}
+
+		bool Kernel::stepResolved(std::vector<double>& input, std::span<const ResolvedInput> inputValues)
+		{
+			if (!isBatchable())
+				return false;
+			sumResolvedInputs(input, inputValues);
+			writeOutput(directConvolution(input));
+			return true;
+		}
+
+		void Kernel::sumResolvedInputs(std::vector<double>& input, std::span<const ResolvedInput> inputValues)
+		{
+			std::ranges::fill(input, 0.0);
+			for (const auto& [values, gain] : inputValues)
+				for (size_t i = 0; i < values->size(); i++)
+					input[i] += gain * (*values)[i];
+			fullSum = std::accumulate(input.begin(), input.end(), 0.0);
+		}
+
+		std::vector<double> Kernel::directConvolution(const std::vector<double>& input) const
+		{
+			std::vector<double> convolution;
+			mathtools::kernelConvolution(input, kernelData->weights, kernelData->kernelRange, circular, convolution);
+			if (!kernelData->borderScale.empty())
+				for (size_t i = 0; i < convolution.size(); i++)
+					convolution[i] *= kernelData->borderScale[i];
+			return convolution;
+		}
+
+		std::vector<double> Kernel::recursiveGaussConvolution(double sigma, double amplitude)
 		{
-			return extIndex;
+			std::vector<double> convolution = mathtools::circularGaussianBoxFilter(components["input"], sigma);
+			for (double& value : convolution)
+				value *= amplitude;
+			return convolution;
 		}
 	}
 }
@@ -0,0 +1,60 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+#include "elements/kernel_cache.h"
+
+#include <algorithm>
+
+namespace dnf_composer
+{
+	namespace element
+	{
+		size_t KernelCache::KeyHash::operator()(const KernelCacheKey& key) const
+		{
+			size_t seed = std::hash<int>{}(key.label);
+			const auto combine = [&seed](size_t value) { seed ^= value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2); };
+			for (const double parameter : key.parameters)
+				combine(std::hash<double>{}(parameter));
+			combine(std::hash<int>{}(key.size));
+			combine(std::hash<bool>{}(key.circular));
+			combine(std::hash<bool>{}(key.borderCompensation));
+			combine(std::hash<int>{}(key.cutOfFactor));
+			return seed;
+		}
+
+		std::shared_ptr<const KernelData> KernelCache::get(const KernelCacheKey& key, const std::function<KernelData()>& build)
+		{
+			{
+				const std::lock_guard<std::mutex> lock(mutex);
+				if (const auto found = entries.find(key); found != entries.end())
+					if (auto data = found->second.lock())
+						return data;
+			}
+
+			// built without the lock, so other kernels are not held up by it
+			auto built = std::make_shared<const KernelData>(build());
+
+			const std::lock_guard<std::mutex> lock(mutex);
+			auto& entry = entries[key];
+			// another kernel may have built the same data in the meantime
+			if (auto data = entry.lock())
+				return data;
+			entry = built;
+
+			// expired entries are only swept once the map has doubled since the last sweep
+			if (entries.size() >= sweepThreshold)
+			{
+				std::erase_if(entries, [](const auto& candidate) { return candidate.second.expired(); });
+				sweepThreshold = std::max(minimumSweepThreshold, 2 * entries.size());
+			}
+			return built;
+		}
+
+		size_t KernelCache::getNumberOfEntries()
+		{
+			const std::lock_guard<std::mutex> lock(mutex);
+			return static_cast<size_t>(std::ranges::count_if(entries, [](const auto& entry) { return !entry.second.expired(); }));
+		}
+	}
+}
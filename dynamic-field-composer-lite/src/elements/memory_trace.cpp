@@ -0,0 +1,154 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+#include "elements/memory_trace.h"
+
+namespace dnf_composer
+{
+	namespace element
+	{
+		namespace
+		{
+			bool areValid(const MemoryTraceParameters& parameters)
+			{
+				return parameters.tauBuild > 0 && parameters.tauDecay > 0 && std::isfinite(parameters.threshold);
+			}
+		}
+
+		MemoryTrace::MemoryTrace(const ElementCommonParameters& elementCommonParameters, const MemoryTraceParameters& parameters)
+			: Element(elementCommonParameters), parameters(parameters)
+		{
+			if (!areValid(parameters))
+				throw Exception(ErrorCode::ELEM_INVALID_PARAMETER, commonParameters.identifiers.uniqueName);
+			commonParameters.identifiers.label = ElementLabel::MEMORY_TRACE;
+			const int size = commonParameters.dimensionParameters.size;
+			inTrace.assign(size, 0);
+			activeStamps.assign(size, 0);
+		}
+
+		void MemoryTrace::init()
+		{
+			std::ranges::fill(components["output"], 0.0);
+			std::ranges::fill(components["input"], 0.0);
+			traceBins.clear();
+			std::ranges::fill(inTrace, 0);
+			std::ranges::fill(activeStamps, 0);
+			stepCount = 0;
+		}
+
+		void MemoryTrace::step(double t, double deltaT)
+		{
+			updateInput();
+			const std::vector<double>& input = components["input"];
+			std::vector<double>& output = components["output"];
+
+			stepCount++;
+			activeBins.clear();
+			for (int i = 0; i < static_cast<int>(input.size()); i++)
+				if (input[i] > parameters.threshold)
+				{
+					activeBins.push_back(i);
+					activeStamps[i] = stepCount;
+				}
+			if (activeBins.empty())
+				return;
+
+			const double buildRate = deltaT / parameters.tauBuild;
+			for (const int bin : activeBins)
+			{
+				output[bin] += buildRate * (1.0 - output[bin]);
+				addToTrace(bin);
+			}
+
+			const double decayRate = deltaT / parameters.tauDecay;
+			for (size_t k = 0; k < traceBins.size();)
+			{
+				const int bin = traceBins[k];
+				if (activeStamps[bin] != stepCount)
+				{
+					output[bin] -= decayRate * output[bin];
+					if (std::abs(output[bin]) < negligibleTrace)
+					{
+						output[bin] = 0.0;
+						inTrace[bin] = 0;
+						traceBins[k] = traceBins.back();
+						traceBins.pop_back();
+						continue;
+					}
+				}
+				k++;
+			}
+		}
+
+		void MemoryTrace::printParameters()
+		{
+			printCommonParameters();
+
+			std::ostringstream logStream;
+
+			logStream << "Logging specific element parameters" << std::endl;
+			logStream << "Tau build: " << parameters.tauBuild << std::endl;
+			logStream << "Tau decay: " << parameters.tauDecay << std::endl;
+			logStream << "Threshold: " << parameters.threshold << std::endl;
+
+			log(LogLevel::INFO, logStream.str());
+		}
+
+		std::shared_ptr<Element> MemoryTrace::clone() const
+		{
+			return std::make_shared<MemoryTrace>(*this);
+		}
+
+		void MemoryTrace::writeState(std::ostream& stream) const
+		{
+			utilities::writeBinary(stream, parameters);
+			Element::writeState(stream);
+		}
+
+		void MemoryTrace::readState(std::istream& stream)
+		{
+			utilities::readBinary(stream, parameters);
+			Element::readState(stream);
+			rebuildTraceBins();
+		}
+
+		void MemoryTrace::setParameters(const MemoryTraceParameters& memoryTraceParameters)
+		{
+			if (!areValid(memoryTraceParameters))
+			{
+				log(LogLevel::ERROR, "Memory trace '" + getUniqueName() + "' requires positive time constants and a finite threshold, its parameters were not changed.\n");
+				return;
+			}
+			parameters = memoryTraceParameters;
+		}
+
+		MemoryTraceParameters MemoryTrace::getParameters() const
+		{
+			return parameters;
+		}
+
+		int MemoryTrace::getNumberOfTraceBins() const
+		{
+			return static_cast<int>(traceBins.size());
+		}
+
+		void MemoryTrace::addToTrace(int bin)
+		{
+			if (inTrace[bin])
+				return;
+			inTrace[bin] = 1;
+			traceBins.push_back(bin);
+		}
+
+		void MemoryTrace::rebuildTraceBins()
+		{
+			const std::vector<double>& output = components["output"];
+			traceBins.clear();
+			std::ranges::fill(inTrace, 0);
+			for (int i = 0; i < static_cast<int>(output.size()); i++)
+				if (output[i] != 0.0)
+					addToTrace(i);
+		}
+	}
+}
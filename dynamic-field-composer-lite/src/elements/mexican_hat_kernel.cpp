@@ -16,36 +16,9 @@ namespace dnf_composer
 
 		void MexicanHatKernel::init()
 		{
-			const double maxSigma = std::max(parameters.amplitudeExc * parameters.sigmaExc, parameters.amplitudeInh * parameters.sigmaInh);
-			kernelRange = mathtools::computeKernelRange(maxSigma, cutOfFactor, commonParameters.dimensionParameters.size, circular);
-
-			if (circular)
-				extIndex = mathtools::createExtendedIndex(commonParameters.dimensionParameters.size, kernelRange);
-			else
-			{
-				const std::string message = "Tried to initialize a non-circular Mexican hat kernel '" + this->getUniqueName() + "'. That is not supported yet.\n";
-				log(LogLevel::ERROR, message);
-			}
-
-			uint32_t rangeXsize = kernelRange[0] + kernelRange[1] + 1;
-			std::vector<int> rangeX(rangeXsize);
-			const int startingValue = static_cast<int>(kernelRange[0]);
-			std::iota(rangeX.begin(), rangeX.end(), -startingValue);
-			std::vector<double> gaussExc(commonParameters.dimensionParameters.size);
-			std::vector<double> gaussInh(commonParameters.dimensionParameters.size);
-			if (!normalized)
-			{
-				gaussExc = mathtools::gaussNorm(rangeX, 0.0, parameters.sigmaExc);
-				gaussInh = mathtools::gaussNorm(rangeX, 0.0, parameters.sigmaInh);
-			}
-			else
-			{
-				const std::string message = "Tried to initialize a normalized Mexican hat kernel '" + this->getUniqueName() + "'. That is not supported yet.\n";
-				log(LogLevel::ERROR, message);
-			}
-
-			for (int i = 0; i < components["kernel"].size(); i++)
-				components["kernel"][i] = parameters.amplitudeExc * gaussExc[i] - parameters.amplitudeInh * gaussInh[i];
+			// the range covers the widest Gaussian that contributes to the kernel
+			const double maxSigma = std::max(parameters.amplitudeExc != 0.0 ? parameters.sigmaExc : 0.0, parameters.amplitudeInh != 0.0 ? parameters.sigmaInh : 0.0);
+			acquireKernelData(maxSigma, { { parameters.sigmaExc, parameters.amplitudeExc }, { parameters.sigmaInh, -parameters.amplitudeInh } });
 
 			fullSum = 0;
 			std::ranges::fill(components["input"], 0.0);
@@ -53,18 +26,25 @@ namespace dnf_composer
 
 		void MexicanHatKernel::step(double t, double deltaT)
 		{
-			updateInput();
-
-			fullSum = std::accumulate(components["input"].begin(), components["input"].end(), (double)0.0);
+			updateKernelInput();
 
 			std::vector<double> convolution(commonParameters.dimensionParameters.size);
-			const std::vector<double> subDataInput = mathtools::obtainCircularVector(extIndex, components["input"]);
-
-			if (circular)
-				convolution = mathtools::conv_valid(subDataInput, components["kernel"]);
+			if (usesRecursiveConvolution())
+			{
+				// the difference of Gaussians is filtered as two separate Gaussians
+				convolution = recursiveGaussConvolution(parameters.sigmaExc, parameters.amplitudeExc);
+				const std::vector<double> inhibition = recursiveGaussConvolution(parameters.sigmaInh, parameters.amplitudeInh);
+				for (size_t i = 0; i < convolution.size(); i++)
+					convolution[i] -= inhibition[i];
+			}
 			else
-				convolution = mathtools::conv(subDataInput, components["kernel"]);
+				convolution = directConvolution(components["input"]);
+
+			writeOutput(convolution);
+		}
 
+		void MexicanHatKernel::writeOutput(const std::vector<double>& convolution)
+		{
 			for (int i = 0; i < components["output"].size(); i++)
 				components["output"][i] = (convolution[i] + parameters.amplitudeGlobal) * commonParameters.dimensionParameters.d_x;
 		}
@@ -86,7 +66,8 @@ namespace dnf_composer
 			logStream << "SigmaInh: " << parameters.sigmaInh << std::endl;
 			logStream << "AmplitudeGlobal: " << parameters.amplitudeGlobal << std::endl;
 			logStream << "CutOffFactor: " << cutOfFactor << std::endl;
-			logStream << "Normalized: " << normalized << std::endl;
+			logStream << "Recursive convolution: " << usesRecursiveConvolution() << std::endl;
+			logStream << "Border compensation: " << borderCompensation << std::endl;
 
 			log(LogLevel::INFO, logStream.str());
 		}
@@ -101,5 +82,27 @@ namespace dnf_composer
 		{
 			return parameters;
 		}
+	
+
+		std::shared_ptr<Element> MexicanHatKernel::clone() const
+		{
+			return std::make_shared<MexicanHatKernel>(*this);
+		}
+
+		void MexicanHatKernel::writeState(std::ostream& stream) const
+		{
+			utilities::writeBinary(stream, parameters);
+			Element::writeState(stream);
+		}
+
+		void MexicanHatKernel::readState(std::istream& stream)
+		{
+			MexicanHatKernelParameters storedParameters = parameters;
+			utilities::readBinary(stream, storedParameters);
+			// the kernel data only needs to be looked up again if the parameters changed
+			if (!(storedParameters == parameters))
+				setParameters(storedParameters);
+			Kernel::readState(stream);
+		}
 	}
 }
\ No newline at end of file
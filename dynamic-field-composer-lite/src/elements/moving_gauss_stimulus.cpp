@@ -0,0 +1,193 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+#include "elements/moving_gauss_stimulus.h"
+
+#include <cmath>
+
+namespace dnf_composer
+{
+	namespace element
+	{
+		MovingGaussStimulus::MovingGaussStimulus(const ElementCommonParameters& elementCommonParameters, const MovingGaussStimulusParameters& parameters)
+			: Element(elementCommonParameters), parameters(parameters)
+		{
+			commonParameters.identifiers.label = ElementLabel::MOVING_GAUSS_STIMULUS;
+		}
+
+		void MovingGaussStimulus::init()
+		{
+			std::ranges::fill(components["output"], 0.0);
+			renderedBins.clear();
+			render(initTime);
+		}
+
+		void MovingGaussStimulus::step(double t, double deltaT)
+		{
+			render(t);
+		}
+
+		void MovingGaussStimulus::printParameters()
+		{
+			printCommonParameters();
+
+			std::ostringstream logStream;
+
+			logStream << "Logging specific element parameters" << std::endl;
+			logStream << "Position: " << position << std::endl;
+			logStream << "Amplitude: " << amplitude << std::endl;
+			logStream << "Sigma: " << sigma << std::endl;
+			logStream << "Circular: " << parameters.circular << std::endl;
+			logStream << "Constant sigma: " << parameters.sigma.isConstant() << std::endl;
+
+			log(LogLevel::INFO, logStream.str());
+		}
+
+		std::shared_ptr<Element> MovingGaussStimulus::clone() const
+		{
+			return std::make_shared<MovingGaussStimulus>(*this);
+		}
+
+		void MovingGaussStimulus::readState(std::istream& stream)
+		{
+			Element::readState(stream);
+			// the next step clears whatever the restored output holds
+			const std::vector<double>& output = components["output"];
+			renderedBins.clear();
+			for (int i = 0; i < static_cast<int>(output.size()); i++)
+				if (output[i] != 0.0)
+					renderedBins.push_back(i);
+		}
+
+		void MovingGaussStimulus::setParameters(const MovingGaussStimulusParameters& movingGaussStimulusParameters)
+		{
+			parameters = movingGaussStimulusParameters;
+			profileRadius = -1;
+			render(renderedTime);
+		}
+
+		MovingGaussStimulusParameters MovingGaussStimulus::getParameters() const
+		{
+			return parameters;
+		}
+
+		double MovingGaussStimulus::getPosition() const
+		{
+			return position;
+		}
+
+		double MovingGaussStimulus::getAmplitude() const
+		{
+			return amplitude;
+		}
+
+		double MovingGaussStimulus::getSigma() const
+		{
+			return sigma;
+		}
+
+		void MovingGaussStimulus::render(double t)
+		{
+			std::vector<double>& output = components["output"];
+			for (const int bin : renderedBins)
+				output[bin] = 0.0;
+			renderedBins.clear();
+
+			renderedTime = t;
+			position = parameters.position.valueAt(t);
+			amplitude = parameters.amplitude.valueAt(t);
+			sigma = parameters.sigma.valueAt(t);
+			if (sigma <= 0)
+			{
+				log(LogLevel::ERROR, "Moving Gauss stimulus '" + getUniqueName() + "' has a non-positive sigma, nothing was rendered.\n");
+				return;
+			}
+
+			const int size = commonParameters.dimensionParameters.size;
+			const int radius = static_cast<int>(std::ceil(cutOfFactor * sigma));
+			const int width = 2 * radius + 2;
+			const double inverseVariance = 1.0 / (sigma * sigma);
+
+			// bin i is at coordinate i + 1, the circular position is wrapped into 1 .. size as in mathtools::circularGauss
+			if (parameters.circular && width > size)
+			{
+				// the window would overlap itself, the whole field is in the support
+				double wrapped = std::fmod(position - 1.0, static_cast<double>(size));
+				if (wrapped < 0)
+					wrapped += size;
+				wrapped += 1.0;
+				for (int i = 0; i < size; i++)
+				{
+					const double d = std::abs(static_cast<double>(i + 1) - wrapped);
+					const double distance = std::min(d, size - d);
+					output[i] = amplitude * std::exp(-0.5 * distance * distance * inverseVariance);
+					renderedBins.push_back(i);
+				}
+				return;
+			}
+
+			double center = position;
+			if (parameters.circular)
+			{
+				center = std::fmod(position - 1.0, static_cast<double>(size));
+				if (center < 0)
+					center += size;
+				center += 1.0;
+			}
+			const double base = std::floor(center);
+			const double fraction = center - base;
+
+			const double* row = nullptr;
+			const double* nextRow = nullptr;
+			double weight = 0.0;
+			if (parameters.sigma.isConstant())
+			{
+				if (radius != profileRadius || sigma != profileSigma)
+					buildProfile(radius);
+				const double scaled = fraction * subBinResolution;
+				const int q = std::min(static_cast<int>(scaled), subBinResolution - 1);
+				weight = scaled - q;
+				row = &profile[static_cast<size_t>(q) * width];
+				nextRow = row + width;
+			}
+
+			// offsets k from the bin at the floor of the position, the distance of bin base + k is k - fraction
+			const int firstBin = static_cast<int>(base) - 1 - radius;
+			for (int k = 0; k < width; k++)
+			{
+				int bin = firstBin + k;
+				if (parameters.circular)
+					bin = ((bin % size) + size) % size;
+				else if (bin < 0 || bin >= size)
+					continue;
+
+				double value;
+				if (row)
+					value = (1.0 - weight) * row[k] + weight * nextRow[k];
+				else
+				{
+					const double distance = static_cast<double>(k - radius) - fraction;
+					value = std::exp(-0.5 * distance * distance * inverseVariance);
+				}
+				output[bin] = amplitude * value;
+				renderedBins.push_back(bin);
+			}
+		}
+
+		void MovingGaussStimulus::buildProfile(int radius)
+		{
+			const int width = 2 * radius + 2;
+			const double inverseVariance = 1.0 / (sigma * sigma);
+			profile.resize(static_cast<size_t>(subBinResolution + 1) * width);
+			for (int q = 0; q <= subBinResolution; q++)
+				for (int k = 0; k < width; k++)
+				{
+					const double distance = static_cast<double>(k - radius) - static_cast<double>(q) / subBinResolution;
+					profile[static_cast<size_t>(q) * width + k] = std::exp(-0.5 * distance * distance * inverseVariance);
+				}
+			profileRadius = radius;
+			profileSigma = sigma;
+		}
+	}
+}
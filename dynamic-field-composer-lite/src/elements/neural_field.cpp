@@ -9,7 +9,7 @@ namespace dnf_composer
 	namespace element
 	{
 		NeuralField::NeuralField(const ElementCommonParameters& elementCommonParameters, const NeuralFieldParameters& parameters)
-			: Element(elementCommonParameters), parameters(parameters), centroid(-1)
+			: Element(elementCommonParameters), parameters(parameters), centroid(-1), maxActivationChange(0.0), fusedStep(true)
 		{
 			commonParameters.identifiers.label = ElementLabel::NEURAL_FIELD;
 			components["activation"] = std::vector<double>(commonParameters.dimensionParameters.size);
@@ -21,12 +21,16 @@ namespace dnf_composer
 			std::ranges::fill(components["activation"], parameters.startingRestingLevel);
 			std::ranges::fill(components["input"], 0.0);
 			std::ranges::fill(components["resting level"], parameters.startingRestingLevel);
+			maxActivationChange = 0.0;
 
 			calculateOutput();
 		}
 
 		void NeuralField::step(double t, double deltaT)
 		{
+			if (fusedStep && stepFused(deltaT))
+				return;
+
 			updateInput();
 			calculateActivation(t, deltaT);
 			calculateOutput();
@@ -43,6 +47,19 @@ namespace dnf_composer
 			init();
 		}
 
+		void NeuralField::setActivation(const std::vector<double>& activation)
+		{
+			if (static_cast<int>(activation.size()) != commonParameters.dimensionParameters.size)
+			{
+				const std::string logMessage = "Activation of size " + std::to_string(activation.size()) + " does not match the size of '" + commonParameters.identifiers.uniqueName + "'. \n";
+				log(LogLevel::ERROR, logMessage);
+				return;
+			}
+			components["activation"] = activation;
+			calculateOutput();
+			calculateCentroid();
+		}
+
 		NeuralFieldParameters NeuralField::getParameters() const
 		{
 			return parameters;
@@ -53,6 +70,21 @@ namespace dnf_composer
 			return centroid;
 		}
 
+		double NeuralField::getMaxActivationChange() const
+		{
+			return maxActivationChange;
+		}
+
+		void NeuralField::setFusedStep(bool enable)
+		{
+			fusedStep = enable;
+		}
+
+		bool NeuralField::getFusedStep() const
+		{
+			return fusedStep;
+		}
+
 		void NeuralField::printParameters()
 		{
 			printCommonParameters();
@@ -75,11 +107,18 @@ namespace dnf_composer
 
 		void NeuralField::calculateActivation(double t, double deltaT)
 		{
+			std::vector<double>& activation = components["activation"];
+			const std::vector<double>& restingLevel = components["resting level"];
+			const std::vector<double>& input = components["input"];
+
+			double maxChange = 0.0;
 			for (int i = 0; i < commonParameters.dimensionParameters.size; i++)
 			{
-				components["activation"][i] = components["activation"][i] + deltaT / parameters.tau *
-					(-components["activation"][i] + components["resting level"][i] + components["input"][i]);
+				const double change = deltaT / parameters.tau * (-activation[i] + restingLevel[i] + input[i]);
+				activation[i] += change;
+				maxChange = std::max(maxChange, std::fabs(change));
 			}
+			maxActivationChange = maxChange;
 		}
 
 		void NeuralField::calculateOutput()
@@ -90,42 +129,136 @@ namespace dnf_composer
 
 		void NeuralField::calculateCentroid()
 		{
-			const std::vector<double> f_output = mathtools::heaviside(components["activation"], 0.1);
+			const std::vector<double>& activation = components["activation"];
+			const int size = commonParameters.dimensionParameters.size;
+			const double halfSize = static_cast<double>(size) * 0.5;
 
-			if (*std::ranges::max_element(f_output) > 0)
+			CentroidStatistics statistics;
+			for (int i = 0; i < size; i++)
 			{
-				const bool isAtLimits = (f_output[0] > 0) || (f_output[commonParameters.dimensionParameters.size - 1] > 0);
-
-				double sumActivation = 0.0;
-				double sumWeightedPositions = 0.0;
-
-				for (int i = 0; i < commonParameters.dimensionParameters.size; i++)
+				if (activation[i] > centroidThreshold)
 				{
-					const double activation = f_output[i];
-
-					sumActivation += activation;
-
-					// Calculate the circular distance from the midpoint to the position
-					double distance = 0.0;
-					if (isAtLimits)
-						distance = fmod(static_cast<double>(i) - static_cast<double>(commonParameters.dimensionParameters.size) * 0.5 
-							+ static_cast<double>(commonParameters.dimensionParameters.size) * 10, static_cast<double>(commonParameters.dimensionParameters.size));
+					const double distance = static_cast<double>(i) - halfSize;
+					statistics.count += 1.0;
+					if (distance < 0.0)
+					{
+						statistics.lowerCount += 1.0;
+						statistics.lowerDistances += distance;
+					}
 					else
-						distance = fmod(static_cast<double>(i) - static_cast<double>(commonParameters.dimensionParameters.size) * 0.5, static_cast<double>(commonParameters.dimensionParameters.size));
-					sumWeightedPositions += distance * activation;
+						statistics.upperDistances += distance;
 				}
+			}
+			statistics.atLimits = activation[0] > centroidThreshold || activation[size - 1] > centroidThreshold;
+			updateCentroid(statistics);
+		}
 
-				static constexpr double epsilon = 1e-6;
-				if (std::fabs(sumActivation) > epsilon)
-				{
-					// Shift the centroid back to the circular field
-					centroid = fmod(static_cast<double>(commonParameters.dimensionParameters.size) * 0.5 + sumWeightedPositions / sumActivation, static_cast<double>(commonParameters.dimensionParameters.size));
-					if (isAtLimits)
-						centroid = (centroid >= 0 ? centroid : centroid + static_cast<double>(commonParameters.dimensionParameters.size));
-				}
+		void NeuralField::updateCentroid(const CentroidStatistics& statistics)
+		{
+			if (statistics.count == 0.0)
+			{
+				centroid = -1.0;
+				return;
 			}
+
+			// Distances are taken from the midpoint. A peak at the limits wraps around, so the positions of the lower
+			// half are shifted by the field size (all terms are integers or halves, the sums are exact in any order).
+			const double size = static_cast<double>(commonParameters.dimensionParameters.size);
+			double sumWeightedPositions = statistics.lowerDistances + statistics.upperDistances;
+			if (statistics.atLimits)
+				sumWeightedPositions += size * statistics.lowerCount;
+
+			// Shift the centroid back to the circular field
+			centroid = fmod(size * 0.5 + sumWeightedPositions / statistics.count, size);
+			if (statistics.atLimits)
+				centroid = (centroid >= 0 ? centroid : centroid + size);
+		}
+
+		bool NeuralField::stepFused(double deltaT)
+		{
+			const int size = commonParameters.dimensionParameters.size;
+			const std::vector<ResolvedInput>& inputValues = getResolvedInputs();
+			for (const ResolvedInput& inputValue : inputValues)
+				if (static_cast<int>(inputValue.values->size()) != size)
+					return false;
+
+			std::vector<double>& output = components["output"];
+			output.resize(size);
+			const NeuralFieldBuffers buffers{ components["activation"].data(), components["resting level"].data(), components["input"].data(), output.data() };
+			return stepResolved(buffers, inputValues, deltaT);
+		}
+
+		bool NeuralField::stepResolved(const NeuralFieldBuffers& buffers, std::span<const ResolvedInput> inputValues, double deltaT)
+		{
+			CentroidStatistics statistics;
+			const ActivationFunction* activationFunction = parameters.activationFunction.get();
+			if (const auto* sigmoid = dynamic_cast<const SigmoidFunction*>(activationFunction))
+				statistics = fusedSweep(buffers, inputValues, deltaT, mathtools::SigmoidActivation<double>{ sigmoid->steepness, sigmoid->x_shift });
+			else if (const auto* heaviside = dynamic_cast<const HeavisideFunction*>(activationFunction))
+				statistics = fusedSweep(buffers, inputValues, deltaT, mathtools::HeavisideActivation<double>{ heaviside->x_shift });
 			else
-				centroid = -1.0;
+				return false;
+
+			updateCentroid(statistics);
+			return true;
+		}
+
+		std::shared_ptr<Element> NeuralField::clone() const
+		{
+			return std::make_shared<NeuralField>(*this);
+		}
+
+		void NeuralField::writeState(std::ostream& stream) const
+		{
+			utilities::writeBinary(stream, parameters.tau);
+			utilities::writeBinary(stream, parameters.startingRestingLevel);
+
+			// activation function type followed by its x shift and steepness
+			int32_t activationFunctionType = -1;
+			double xShift = 0.0, steepness = 0.0;
+			if (const auto* sigmoid = dynamic_cast<const SigmoidFunction*>(parameters.activationFunction.get()))
+			{
+				activationFunctionType = ActivationFunctionType::SIGMOID;
+				xShift = sigmoid->getXShift();
+				steepness = sigmoid->getSteepness();
+			}
+			else if (const auto* heaviside = dynamic_cast<const HeavisideFunction*>(parameters.activationFunction.get()))
+			{
+				activationFunctionType = ActivationFunctionType::HEAVISIDE;
+				xShift = heaviside->getXShift();
+			}
+			utilities::writeBinary(stream, activationFunctionType);
+			utilities::writeBinary(stream, xShift);
+			utilities::writeBinary(stream, steepness);
+
+			utilities::writeBinary(stream, centroid);
+			Element::writeState(stream);
+		}
+
+		void NeuralField::readState(std::istream& stream)
+		{
+			int32_t activationFunctionType = -1;
+			double xShift = 0.0, steepness = 0.0;
+			utilities::readBinary(stream, parameters.tau);
+			utilities::readBinary(stream, parameters.startingRestingLevel);
+			utilities::readBinary(stream, activationFunctionType);
+			utilities::readBinary(stream, xShift);
+			utilities::readBinary(stream, steepness);
+
+			switch (activationFunctionType)
+			{
+			case ActivationFunctionType::SIGMOID:
+				parameters.activationFunction = std::make_unique<SigmoidFunction>(xShift, steepness);
+				break;
+			case ActivationFunctionType::HEAVISIDE:
+				parameters.activationFunction = std::make_unique<HeavisideFunction>(xShift);
+				break;
+			default: // custom activation functions are kept as they are
+				break;
+			}
+
+			utilities::readBinary(stream, centroid);
+			Element::readState(stream);
 		}
 	}
 }
\ No newline at end of file
@@ -9,7 +9,7 @@ namespace dnf_composer
 	namespace element
 	{
 		NormalNoise::NormalNoise(const ElementCommonParameters& elementCommonParameters, NormalNoiseParameters parameters)
-			: Element(elementCommonParameters), parameters(parameters)
+			: Element(elementCommonParameters), parameters(parameters), generator(std::random_device{}())
 		{
 			 commonParameters.identifiers.label = ElementLabel::NORMAL_NOISE;
 		}
@@ -21,7 +21,7 @@ namespace dnf_composer
 
 		void NormalNoise::step(double t, double deltaT)
 		{
-			const std::vector<double> rand = mathtools::generateNormalVector(commonParameters.dimensionParameters.size);
+			const std::vector<double> rand = mathtools::generateNormalVector(commonParameters.dimensionParameters.size, generator);
 
 			for (int i = 0; i < commonParameters.dimensionParameters.size; i++)
 				components["output"][i] = parameters.amplitude / sqrt(deltaT) * rand[i];
@@ -48,5 +48,43 @@ namespace dnf_composer
 		{
 			return parameters;
 		}
+	
+
+		void NormalNoise::setSeed(unsigned int seed)
+		{
+			generator.seed(seed);
+		}
+
+		std::string NormalNoise::getGeneratorState() const
+		{
+			std::ostringstream generatorState;
+			generatorState << generator;
+			return generatorState.str();
+		}
+
+		std::shared_ptr<Element> NormalNoise::clone() const
+		{
+			// the clone continues the same random sequence, reseed it for independent noise
+			return std::make_shared<NormalNoise>(*this);
+		}
+
+		void NormalNoise::writeState(std::ostream& stream) const
+		{
+			utilities::writeBinary(stream, parameters);
+			utilities::writeBinary(stream, getGeneratorState());
+			Element::writeState(stream);
+		}
+
+		void NormalNoise::readState(std::istream& stream)
+		{
+			std::string generatorState;
+			utilities::readBinary(stream, parameters);
+			utilities::readBinary(stream, generatorState);
+			std::istringstream generatorStream(generatorState);
+			generatorStream >> generator;
+			if (!generatorStream)
+				stream.setstate(std::ios::failbit);
+			Element::readState(stream);
+		}
 	}
 }
\ No newline at end of file
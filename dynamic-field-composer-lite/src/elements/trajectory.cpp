@@ -0,0 +1,108 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+#include "elements/trajectory.h"
+
+#include <cmath>
+#include <numbers>
+#include <algorithm>
+
+namespace dnf_composer
+{
+	namespace element
+	{
+		Trajectory::Trajectory(double value)
+			: offset(value)
+		{
+		}
+
+		Trajectory Trajectory::constant(double value)
+		{
+			return { value };
+		}
+
+		Trajectory Trajectory::piecewiseLinear(const std::vector<std::pair<double, double>>& knots)
+		{
+			if (knots.empty())
+				throw Exception(ErrorCode::ELEM_INVALID_PARAMETER, "piecewise-linear trajectory");
+			Trajectory trajectory;
+			trajectory.kind = Kind::PIECEWISE_LINEAR;
+			for (const auto& [time, value] : knots)
+			{
+				if (!trajectory.times.empty() && time <= trajectory.times.back())
+					throw Exception(ErrorCode::ELEM_INVALID_PARAMETER, "piecewise-linear trajectory");
+				trajectory.times.push_back(time);
+				trajectory.values.push_back(value);
+			}
+			return trajectory;
+		}
+
+		Trajectory Trajectory::sinusoidal(double offset, double amplitude, double period, double phase)
+		{
+			if (period <= 0)
+				throw Exception(ErrorCode::ELEM_INVALID_PARAMETER, "sinusoidal trajectory");
+			Trajectory trajectory(offset);
+			trajectory.kind = Kind::SINUSOIDAL;
+			trajectory.amplitude = amplitude;
+			trajectory.period = period;
+			trajectory.phase = phase;
+			return trajectory;
+		}
+
+		Trajectory Trajectory::sampled(const std::vector<double>& samples, double interval, double start)
+		{
+			if (samples.empty() || interval <= 0)
+				throw Exception(ErrorCode::ELEM_INVALID_PARAMETER, "sampled trajectory");
+			Trajectory trajectory;
+			trajectory.kind = Kind::SAMPLED;
+			trajectory.values = samples;
+			trajectory.interval = interval;
+			trajectory.start = start;
+			return trajectory;
+		}
+
+		double Trajectory::valueAt(double t) const
+		{
+			switch (kind)
+			{
+			case Kind::CONSTANT:
+				return offset;
+			case Kind::SINUSOIDAL:
+				return offset + amplitude * std::sin(2.0 * std::numbers::pi * t / period + phase);
+			case Kind::PIECEWISE_LINEAR:
+			{
+				if (t <= times.front())
+					return values.front();
+				if (t >= times.back())
+					return values.back();
+				const size_t next = static_cast<size_t>(std::ranges::upper_bound(times, t) - times.begin());
+				const double weight = (t - times[next - 1]) / (times[next] - times[next - 1]);
+				return values[next - 1] + weight * (values[next] - values[next - 1]);
+			}
+			case Kind::SAMPLED:
+			{
+				const double index = (t - start) / interval;
+				if (index <= 0.0)
+					return values.front();
+				if (index >= static_cast<double>(values.size() - 1))
+					return values.back();
+				const size_t previous = static_cast<size_t>(index);
+				const double weight = index - static_cast<double>(previous);
+				return values[previous] + weight * (values[previous + 1] - values[previous]);
+			}
+			}
+			return offset;
+		}
+
+		bool Trajectory::isConstant() const
+		{
+			return kind == Kind::CONSTANT;
+		}
+
+		Trajectory::Kind Trajectory::getKind() const
+		{
+			return kind;
+		}
+	}
+}
@@ -4,50 +4,285 @@
 
 #include "logging/logger.h"
 
+#include <thread>
+#include <vector>
+#include <sstream>
+#include <ctime>
+
 namespace dnf_composer
 {
-    Logger::Logger(LogLevel level, LogOutputMode mode)
-	: logLevel(level), outputMode(mode)
-	{}
+    namespace
+    {
+        struct LogRecord
+        {
+            LogLevel level = INFO;
+            LogOutputMode mode = ALL;
+            std::chrono::system_clock::time_point time;
+            std::string message;
+        };
 
-    void Logger::log(const std::string& message) const
-	{
-        const auto now = std::chrono::system_clock::now();
-        const auto in_time_t = std::chrono::system_clock::to_time_t(now);
-
-        std::tm buf;
-        if (localtime_s(&buf, &in_time_t))
-            throw Exception(ErrorCode::LOG_LOCAL_TIME_ERROR);
-
-    	const std::string levelStr = getLogLevelText(logLevel);
-	    std::ostringstream oss;
-    	const std::string finalMessage = oss.str();
-    	std::string colorCode;
-
-		switch (outputMode)
-		{
-			case LogOutputMode::ALL:
-                colorCode = getLogLevelColorCode(logLevel);
-                oss << colorCode << levelStr << " " << std::put_time(&buf, "%Y-%m-%d %X") << " " << message;
-                log_cmd(oss.str());
-                std::ostringstream().swap(oss); // swap m with a default constructed stringstream
-                oss << levelStr << " " << std::put_time(&buf, "%Y-%m-%d %X") << " " << message;
-                log_ui(oss.str());
-				break;
-			case LogOutputMode::CONSOLE:
-                colorCode = getLogLevelColorCode(logLevel);
-                oss << colorCode << levelStr << " " << std::put_time(&buf, "%Y-%m-%d %X") << " " << message;
-                log_cmd(oss.str());
-				break;
-			case LogOutputMode::GUI:
-    			oss << levelStr << " " << std::put_time(&buf, "%Y-%m-%d %X") << " " << message;
-				log_ui(oss.str());
-				break;
-			default:
-				break;
-		}
+        // Set once the sink has been destroyed during static destruction, later messages are written synchronously.
+        // Threads that are still logging at that point read it concurrently.
+        std::atomic<bool> sinkDestroyed = false;
 
-	}
+        bool toLocalTime(std::time_t time, std::tm& result)
+        {
+#ifdef _WIN32
+            return localtime_s(&result, &time) == 0;
+#else
+            return localtime_r(&time, &result) != nullptr;
+#endif
+        }
+    }
+
+    // Bounded multi-producer single-consumer queue (sequence-numbered ring) drained by one background thread.
+    class LogSink
+    {
+    private:
+        struct Cell
+        {
+            std::atomic<size_t> sequence;
+            LogRecord record;
+        };
+
+        static constexpr size_t capacity = 4096; // power of two
+        static constexpr size_t mask = capacity - 1;
+
+        std::vector<Cell> cells;
+        std::atomic<size_t> enqueuePosition = 0;
+        size_t dequeuePosition = 0;
+        std::atomic<size_t> writtenCount = 0;
+        std::atomic<bool> pending = false;
+        std::atomic<bool> stopping = false;
+        std::time_t cachedSecond = -1;
+        std::string cachedTimestamp;
+        std::thread thread;
+    public:
+        LogSink()
+            : cells(capacity)
+        {
+            for (size_t i = 0; i < capacity; i++)
+                cells[i].sequence.store(i, std::memory_order_relaxed);
+            thread = std::thread([this] { run(); });
+        }
+
+        LogSink(const LogSink&) = delete;
+        LogSink& operator=(const LogSink&) = delete;
+        LogSink(LogSink&&) = delete;
+        LogSink& operator=(LogSink&&) = delete;
+
+        ~LogSink()
+        {
+            stopping.store(true);
+            wake();
+            thread.join();
+            sinkDestroyed.store(true);
+        }
+
+        static LogSink& instance()
+        {
+            static LogSink sink;
+            return sink;
+        }
+
+        void push(LogRecord&& record)
+        {
+            size_t position = enqueuePosition.load(std::memory_order_relaxed);
+            while (true)
+            {
+                Cell& cell = cells[position & mask];
+                const size_t sequence = cell.sequence.load(std::memory_order_acquire);
+                const auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+                if (difference == 0)
+                {
+                    if (enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    {
+                        cell.record = std::move(record);
+                        cell.sequence.store(position + 1, std::memory_order_release);
+                        wake();
+                        return;
+                    }
+                }
+                else if (difference < 0)
+                {
+                    // queue is full, apply back pressure instead of dropping messages
+                    wake();
+                    std::this_thread::yield();
+                    position = enqueuePosition.load(std::memory_order_relaxed);
+                }
+                else
+                    position = enqueuePosition.load(std::memory_order_relaxed);
+            }
+        }
+
+        void flush()
+        {
+            const size_t target = enqueuePosition.load(std::memory_order_acquire);
+            wake();
+            size_t written = writtenCount.load(std::memory_order_acquire);
+            while (written < target)
+            {
+                writtenCount.wait(written, std::memory_order_acquire);
+                written = writtenCount.load(std::memory_order_acquire);
+            }
+        }
+
+        void write(const LogRecord& record)
+        {
+            const std::time_t second = std::chrono::system_clock::to_time_t(record.time);
+            if (second != cachedSecond)
+            {
+                // formatted once per second, the sink thread must not throw so a failed conversion leaves it empty
+                std::tm buf;
+                std::ostringstream oss;
+                if (toLocalTime(second, buf))
+                    oss << std::put_time(&buf, "%Y-%m-%d %X");
+                cachedTimestamp = oss.str();
+                cachedSecond = second;
+            }
+
+            const std::string levelStr = Logger::getLogLevelText(record.level);
+            const std::string line = levelStr + " " + cachedTimestamp + " " + record.message;
+            if (record.mode == LogOutputMode::ALL || record.mode == LogOutputMode::CONSOLE)
+                Logger::log_cmd(Logger::getLogLevelColorCode(record.level) + line);
+            if (record.mode == LogOutputMode::ALL || record.mode == LogOutputMode::GUI)
+                Logger::log_ui(line);
+        }
+    private:
+        void wake()
+        {
+            if (!pending.exchange(true, std::memory_order_acq_rel))
+                pending.notify_one();
+        }
+
+        void run()
+        {
+            while (true)
+            {
+                pending.wait(false, std::memory_order_acquire);
+                // a read-modify-write, so a producer that saw pending still set and skipped the notification
+                // published its record before this exchange, and the drain below sees it
+                pending.exchange(false, std::memory_order_acq_rel);
+                drain();
+                if (stopping.load())
+                {
+                    drain();
+                    return;
+                }
+            }
+        }
+
+        void drain()
+        {
+            bool wroteAny = false;
+            while (true)
+            {
+                Cell& cell = cells[dequeuePosition & mask];
+                if (cell.sequence.load(std::memory_order_acquire) != dequeuePosition + 1)
+                    break;
+
+                const LogRecord record = std::move(cell.record);
+                cell.sequence.store(dequeuePosition + capacity, std::memory_order_release);
+                dequeuePosition++;
+
+                write(record);
+                wroteAny = true;
+                writtenCount.store(dequeuePosition, std::memory_order_release);
+            }
+
+            if (wroteAny)
+            {
+                std::cout.flush();
+                writtenCount.notify_all();
+            }
+        }
+    };
+
+    namespace
+    {
+        // Messages logged repeatedly by the same thread in a short window are collapsed into a summary line.
+        struct RepeatedMessage
+        {
+            static constexpr std::chrono::seconds window{ 1 };
+
+            LogLevel level = INFO;
+            LogOutputMode mode = ALL;
+            std::string message;
+            size_t repetitions = 0;
+            std::chrono::steady_clock::time_point since;
+
+            RepeatedMessage() = default;
+            RepeatedMessage(const RepeatedMessage&) = delete;
+            RepeatedMessage& operator=(const RepeatedMessage&) = delete;
+            RepeatedMessage(RepeatedMessage&&) = delete;
+            RepeatedMessage& operator=(RepeatedMessage&&) = delete;
+
+            ~RepeatedMessage()
+            {
+                report();
+            }
+
+            bool suppress(LogLevel newLevel, LogOutputMode newMode, const std::string& newMessage)
+            {
+                const auto now = std::chrono::steady_clock::now();
+                if (newLevel == level && newMode == mode && now - since < window && newMessage == message)
+                {
+                    repetitions++;
+                    return true;
+                }
+
+                report();
+                level = newLevel;
+                mode = newMode;
+                message = newMessage;
+                since = now;
+                return false;
+            }
+
+            void report()
+            {
+                if (repetitions == 0)
+                    return;
+                const std::string summary = "Previous message repeated " + std::to_string(repetitions) + " times.\n";
+                repetitions = 0;
+                if (sinkDestroyed.load())
+                    return;
+                LogSink::instance().push({ level, mode, std::chrono::system_clock::now(), summary });
+            }
+        };
+
+        thread_local RepeatedMessage repeatedMessage;
+    }
+
+    void Logger::setMinimumLevel(LogLevel level)
+    {
+        minimumLevel.store(level, std::memory_order_relaxed);
+    }
+
+    void Logger::log(LogLevel level, const std::string& message, LogOutputMode mode)
+    {
+        if (repeatedMessage.suppress(level, mode, message))
+            return;
+
+        if (sinkDestroyed.load())
+        {
+            // static destruction already tore down the sink thread
+            log_cmd(getLogLevelColorCode(level) + getLogLevelText(level) + " " + message);
+            return;
+        }
+
+        LogSink& sink = LogSink::instance();
+        sink.push({ level, mode, std::chrono::system_clock::now(), message });
+        if (level == LogLevel::FATAL)
+            sink.flush();
+    }
+
+    void Logger::flush()
+    {
+        repeatedMessage.report();
+        if (!sinkDestroyed.load())
+            LogSink::instance().flush();
+    }
 
     void Logger::log_cmd(const std::string& message)
     {
@@ -57,21 +292,9 @@ namespace dnf_composer
 
     void Logger::log_ui(const std::string& message)
 	{
-    	user_interface::LoggerWindow::addLog(message.c_str());
+    	user_interface::LoggerWindow::addLog("%s", message.c_str());
 	}
 
-
-    void log(LogLevel level, const std::string& message, LogOutputMode mode)
-	{
-#ifndef _DEBUG
-		if(level == LogLevel::DEBUG)
-			return;
-#endif
-        logger = Logger(level, mode);
-        logger.log(message);
-    }
-
-
     std::string Logger::getLogLevelColorCode(LogLevel level)
 	{
         switch (level)
@@ -102,4 +325,4 @@ namespace dnf_composer
         default: return "";
         }
     }
-}
\ No newline at end of file
+}
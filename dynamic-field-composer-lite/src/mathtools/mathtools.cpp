@@ -51,6 +51,45 @@ namespace dnf_composer
 			return extendedVector;
 		}
 
+		void kernelConvolution(const std::vector<double>& input, const std::vector<double>& weights, const std::array<int, 2>& kernelRange,
+			bool circular, std::vector<double>& output)
+		{
+			const int size = static_cast<int>(input.size());
+			const int numberOfWeights = static_cast<int>(weights.size());
+			output.resize(size);
+
+			// the last weight lies over input[first], the input index grows as the weight index falls
+			for (int i = 0; i < size; i++)
+			{
+				const int first = i - kernelRange[1];
+				double sum = 0.0;
+				if (first >= 0 && first + numberOfWeights <= size)
+				{
+					const double* source = input.data() + first;
+					for (int k = 0; k < numberOfWeights; k++)
+						sum += weights[numberOfWeights - 1 - k] * source[k];
+				}
+				else if (circular)
+				{
+					int index = (first % size + size) % size;
+					for (int k = 0; k < numberOfWeights; k++)
+					{
+						sum += weights[numberOfWeights - 1 - k] * input[index];
+						if (++index == size)
+							index = 0;
+					}
+				}
+				else
+				{
+					const int begin = std::max(0, -first);
+					const int end = std::min(numberOfWeights, size - first);
+					for (int k = begin; k < end; k++)
+						sum += weights[numberOfWeights - 1 - k] * input[first + k];
+				}
+				output[i] = sum;
+			}
+		}
+
 		std::vector<double> generateNormalVector(int size)
 		{
 			std::random_device rd;
@@ -63,5 +102,78 @@ namespace dnf_composer
 
 			return vec;
 		}
+
+		void circularExtendedBoxFilter(const std::vector<double>& input, std::vector<double>& output, double sigma)
+		{
+			const int size = static_cast<int>(input.size());
+			output.resize(size);
+			if (size == 0)
+				return;
+
+			// largest radius whose plain box variance r(r+1)/3 does not exceed sigma^2, alpha makes up the rest
+			const double variance = sigma * sigma;
+			const int radius = static_cast<int>(std::floor(0.5 * std::sqrt(12.0 * variance + 1.0) - 0.5));
+			const double alpha = (2.0 * radius + 1.0) * (variance - radius * (radius + 1.0) / 3.0)
+				/ (2.0 * ((radius + 1.0) * (radius + 1.0) - variance));
+			const double scale = 1.0 / (2.0 * radius + 1.0 + 2.0 * alpha);
+			const auto wrap = [size](int index) { return ((index % size) + size) % size; };
+
+			double sum = 0.0;
+			for (int j = -radius; j <= radius; j++)
+				sum += input[wrap(j)];
+
+			for (int i = 0; i < size; i++)
+			{
+				output[i] = scale * (sum + alpha * (input[wrap(i - radius - 1)] + input[wrap(i + radius + 1)]));
+				sum += input[wrap(i + radius + 1)] - input[wrap(i - radius)];
+			}
+		}
+
+		std::vector<double> circularGaussianBoxFilter(const std::vector<double>& input, double sigma, int passes)
+		{
+			// every pass contributes an equal share of the variance
+			const double passSigma = sigma / std::sqrt(static_cast<double>(passes));
+			std::vector<double> current = input;
+			std::vector<double> filtered(input.size());
+			for (int pass = 0; pass < passes; pass++)
+			{
+				circularExtendedBoxFilter(current, filtered, passSigma);
+				current.swap(filtered);
+			}
+			return current;
+		}
+
+		double gaussianBoxFilterKernelError(double sigma, int size, int passes)
+		{
+			// impulse response of the cascade against the normalized circular Gaussian
+			std::vector<double> impulse(size, 0.0);
+			impulse[0] = 1.0;
+			const std::vector<double> response = circularGaussianBoxFilter(impulse, sigma, passes);
+
+			std::vector<double> gauss(size);
+			double sum = 0.0;
+			for (int i = 0; i < size; i++)
+			{
+				const double distance = std::min(i, size - i);
+				gauss[i] = std::exp(-0.5 * distance * distance / (sigma * sigma));
+				sum += gauss[i];
+			}
+
+			double maxError = 0.0;
+			for (int i = 0; i < size; i++)
+				maxError = std::max(maxError, std::fabs(response[i] - gauss[i] / sum));
+			return maxError / (gauss[0] / sum);
+		}
+
+		std::vector<double> generateNormalVector(int size, std::mt19937& generator)
+		{
+			std::normal_distribution<> dist(0, 1);
+
+			std::vector<double> vec(size);
+			for (int i = 0; i < size; ++i)
+				vec[i] = dist(generator);
+
+			return vec;
+		}
 	}
 }
@@ -0,0 +1,201 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+#include "simulation/execution_plan.h"
+
+#include <unordered_map>
+
+namespace dnf_composer
+{
+	ExecutionPlan::ExecutionPlan(const std::vector<std::shared_ptr<element::Element>>& elements,
+		const std::vector<element::KernelBatch>& kernelBatches, const std::vector<int>& batchOfElement)
+		: kernelBatches(kernelBatches)
+	{
+		operations.reserve(elements.size());
+		for (size_t position = 0; position < elements.size(); position++)
+		{
+			element::Element* element = elements[position].get();
+			Operation operation;
+			operation.element = element;
+			operation.firstInput = inputValues.size();
+
+			const int batch = batchOfElement[position];
+			if (batch >= 0)
+			{
+				element::KernelBatch& kernelBatch = this->kernelBatches[batch];
+				if (kernelBatch.kernels.front() != element)
+					continue;
+
+				operation.kind = OperationKind::KERNEL_BATCH;
+				operation.batch = static_cast<size_t>(batch);
+				bool resolved = true;
+				for (element::Kernel* kernel : kernelBatch.kernels)
+				{
+					const size_t firstInput = inputValues.size();
+					resolved = resolved && resolveInputs(*kernel);
+					kernelBatch.resolvedInput.push_back(kernel->getComponentPtr("input"));
+					kernelBatch.resolvedInputValues.emplace_back(inputValues.begin() + static_cast<std::ptrdiff_t>(firstInput), inputValues.end());
+					inputValues.resize(firstInput);
+				}
+				// a single unresolved kernel sends the whole batch through Element::updateInput
+				if (!resolved)
+				{
+					kernelBatch.resolvedInput.clear();
+					kernelBatch.resolvedInputValues.clear();
+				}
+				operations.push_back(operation);
+				continue;
+			}
+
+			if (resolveInputs(*element))
+			{
+				operation.numberOfInputs = inputValues.size() - operation.firstInput;
+				operation.input = element->getComponentPtr("input");
+				operation.output = element->getComponentPtr("output");
+				// by label, so fields derived from NeuralField take the fused update as well
+				if (element->getLabel() == element::ElementLabel::NEURAL_FIELD)
+				{
+					operation.kind = OperationKind::NEURAL_FIELD;
+					operation.activation = element->getComponentPtr("activation");
+					operation.restingLevel = element->getComponentPtr("resting level");
+				}
+				else if (dynamic_cast<element::Kernel*>(element))
+					operation.kind = OperationKind::KERNEL;
+			}
+			if (operation.kind == OperationKind::ELEMENT)
+				inputValues.resize(operation.firstInput);
+			operations.push_back(operation);
+		}
+		assignStages(elements, batchOfElement);
+	}
+
+	void ExecutionPlan::execute(double t, double deltaT)
+	{
+		for (const Operation& operation : operations)
+		{
+			switch (operation.kind)
+			{
+			case OperationKind::NEURAL_FIELD:
+			{
+				auto* field = static_cast<element::NeuralField*>(operation.element);
+				const element::NeuralFieldBuffers buffers{ operation.activation->data(), operation.restingLevel->data(),
+					operation.input->data(), operation.output->data() };
+				if (!field->stepResolved(buffers, getInputValues(operation), deltaT))
+					field->step(t, deltaT);
+				break;
+			}
+			case OperationKind::KERNEL:
+			{
+				auto* kernel = static_cast<element::Kernel*>(operation.element);
+				if (!kernel->stepResolved(*operation.input, getInputValues(operation)))
+					kernel->step(t, deltaT);
+				break;
+			}
+			case OperationKind::KERNEL_BATCH:
+				element::Kernel::stepBatch(kernelBatches[operation.batch]);
+				break;
+			case OperationKind::ELEMENT:
+				operation.element->step(t, deltaT);
+				break;
+			}
+		}
+	}
+
+	const std::vector<ExecutionPlan::Operation>& ExecutionPlan::getOperations() const
+	{
+		return operations;
+	}
+
+	size_t ExecutionPlan::getNumberOfStages() const
+	{
+		return numberOfStages;
+	}
+
+	void ExecutionPlan::updateGains()
+	{
+		// resolveInputs appended one resolved input per connection, in connection order
+		const auto copyGains = [](const element::Element& element, element::ResolvedInput* resolved)
+			{
+				for (const element::InputConnection& connection : element.getInputConnections())
+					(resolved++)->gain = connection.gain;
+			};
+		for (const Operation& operation : operations)
+		{
+			if (operation.kind == OperationKind::NEURAL_FIELD || operation.kind == OperationKind::KERNEL)
+				copyGains(*operation.element, inputValues.data() + operation.firstInput);
+			else if (operation.kind == OperationKind::KERNEL_BATCH)
+			{
+				element::KernelBatch& batch = kernelBatches[operation.batch];
+				for (size_t k = 0; k < batch.resolvedInputValues.size(); k++)
+					copyGains(*batch.kernels[k], batch.resolvedInputValues[k].data());
+			}
+		}
+	}
+
+	bool ExecutionPlan::resolveInputs(const element::Element& element)
+	{
+		const size_t size = static_cast<size_t>(element.getSize());
+		for (const auto& [source, component, gain, delay] : element.getInputConnections())
+		{
+			const element::DelayLine* line = delay > 0 ? source->getDelayLine(component) : nullptr;
+			if (delay > 0 && (!line || line->getMaxDelay() < delay))
+				return false;
+			// delay line frames keep their address, the values behind them change between steps
+			const std::vector<double>* values = delay > 0 ? &line->frame(delay) : source->getComponentPtr(component);
+			if (!values || values->size() != size)
+				return false;
+			inputValues.push_back({ values, gain });
+		}
+		return true;
+	}
+
+	std::span<const element::ResolvedInput> ExecutionPlan::getInputValues(const Operation& operation) const
+	{
+		return { inputValues.data() + operation.firstInput, operation.numberOfInputs };
+	}
+
+	void ExecutionPlan::assignStages(const std::vector<std::shared_ptr<element::Element>>& elements, const std::vector<int>& batchOfElement)
+	{
+		// the operation stepping each element, kernels of a batch share the one of their batch
+		std::unordered_map<const element::Element*, size_t> operationOf;
+		std::vector<size_t> batchOperation(kernelBatches.size());
+		for (size_t index = 0; index < operations.size(); index++)
+		{
+			operationOf[operations[index].element] = index;
+			if (operations[index].kind == OperationKind::KERNEL_BATCH)
+				batchOperation[operations[index].batch] = index;
+		}
+		for (size_t position = 0; position < elements.size(); position++)
+			if (batchOfElement[position] >= 0)
+				operationOf[elements[position].get()] = batchOperation[batchOfElement[position]];
+
+		// every undelayed input orders two operations, the one stepping first must be in an earlier stage
+		std::vector<std::vector<size_t>> predecessors(operations.size());
+		for (const auto& element : elements)
+		{
+			const size_t reader = operationOf.at(element.get());
+			for (const auto& [source, component, gain, delay] : element->getInputConnections())
+			{
+				const auto found = operationOf.find(source.get());
+				if (delay > 0 || found == operationOf.end() || found->second == reader)
+					continue;
+				const size_t writer = found->second;
+				if (writer < reader)
+					predecessors[reader].push_back(writer);
+				else
+					predecessors[writer].push_back(reader);
+			}
+		}
+
+		numberOfStages = 0;
+		for (size_t index = 0; index < operations.size(); index++)
+		{
+			size_t stage = 0;
+			for (const size_t predecessor : predecessors[index])
+				stage = std::max(stage, operations[predecessor].stage + 1);
+			operations[index].stage = stage;
+			numberOfStages = std::max(numberOfStages, stage + 1);
+		}
+	}
+}
@@ -0,0 +1,89 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+#include "simulation/experiment_timeline.h"
+
+namespace dnf_composer
+{
+	ExperimentTimeline& ExperimentTimeline::setComponent(double time, const std::string& element, const std::string& component, double value)
+	{
+		return add({ time, TimelineEvent::Kind::SET_COMPONENT, element, component, value });
+	}
+
+	ExperimentTimeline& ExperimentTimeline::setStimulusPosition(double time, const std::string& stimulus, double position)
+	{
+		return add({ time, TimelineEvent::Kind::SET_STIMULUS_POSITION, stimulus, {}, position });
+	}
+
+	ExperimentTimeline& ExperimentTimeline::setStimulusAmplitude(double time, const std::string& stimulus, double amplitude)
+	{
+		return add({ time, TimelineEvent::Kind::SET_STIMULUS_AMPLITUDE, stimulus, {}, amplitude });
+	}
+
+	ExperimentTimeline& ExperimentTimeline::setInputGain(double time, const std::string& input, const std::string& receiver, double gain)
+	{
+		return add({ time, TimelineEvent::Kind::SET_INPUT_GAIN, input, receiver, gain });
+	}
+
+	ExperimentTimeline& ExperimentTimeline::disableStimulus(double time, const std::string& stimulus)
+	{
+		return add({ time, TimelineEvent::Kind::DISABLE_STIMULUS, stimulus });
+	}
+
+	ExperimentTimeline& ExperimentTimeline::enableStimulus(double time, const std::string& stimulus)
+	{
+		return add({ time, TimelineEvent::Kind::ENABLE_STIMULUS, stimulus });
+	}
+
+	ExperimentTimeline& ExperimentTimeline::startRecording(double time, const std::string& label, const std::string& element, const std::string& component)
+	{
+		return add({ time, TimelineEvent::Kind::START_RECORDING, element, component, 0.0, label });
+	}
+
+	ExperimentTimeline& ExperimentTimeline::stopRecording(double time, const std::string& label)
+	{
+		return add({ time, TimelineEvent::Kind::STOP_RECORDING, {}, {}, 0.0, label });
+	}
+
+	ExperimentTimeline& ExperimentTimeline::snapshot(double time, const std::string& label, const std::string& element, const std::string& component)
+	{
+		return add({ time, TimelineEvent::Kind::SNAPSHOT, element, component, 0.0, label });
+	}
+
+	ExperimentTimeline& ExperimentTimeline::waitUntilStable(double time, const StabilityCriteria& criteria)
+	{
+		return add({ time, TimelineEvent::Kind::WAIT_UNTIL_STABLE, {}, {}, 0.0, {}, criteria });
+	}
+
+	ExperimentTimeline& ExperimentTimeline::action(double time, const std::function<void(Simulation&)>& callback)
+	{
+		return add({ time, TimelineEvent::Kind::ACTION, {}, {}, 0.0, {}, {}, callback });
+	}
+
+	ExperimentTimeline& ExperimentTimeline::setDuration(double timelineDuration)
+	{
+		if (timelineDuration < 0)
+			throw Exception(ErrorCode::SIM_INVALID_PARAMETER, "Negative experiment timeline duration");
+		duration = timelineDuration;
+		return *this;
+	}
+
+	const std::vector<TimelineEvent>& ExperimentTimeline::getEvents() const
+	{
+		return events;
+	}
+
+	double ExperimentTimeline::getDuration() const
+	{
+		return duration;
+	}
+
+	ExperimentTimeline& ExperimentTimeline::add(TimelineEvent event)
+	{
+		if (event.time < 0)
+			throw Exception(ErrorCode::SIM_INVALID_PARAMETER, "Negative experiment timeline event time");
+		events.push_back(std::move(event));
+		return *this;
+	}
+}
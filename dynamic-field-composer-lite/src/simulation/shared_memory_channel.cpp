@@ -0,0 +1,153 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+#include "simulation/shared_memory_channel.h"
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace dnf_composer
+{
+	namespace shared_memory
+	{
+#ifdef _WIN32
+		bool Segment::create(const std::string& segmentName, size_t segmentSize, bool)
+		{
+			close();
+			const auto highSize = static_cast<DWORD>(static_cast<uint64_t>(segmentSize) >> 32);
+			const auto lowSize = static_cast<DWORD>(segmentSize & 0xFFFFFFFF);
+			HANDLE mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, highSize, lowSize, segmentName.c_str());
+			if (mapping == nullptr)
+				return false;
+			if (GetLastError() == ERROR_ALREADY_EXISTS)
+			{
+				CloseHandle(mapping);
+				return false;
+			}
+			void* view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, segmentSize);
+			if (view == nullptr)
+			{
+				CloseHandle(mapping);
+				return false;
+			}
+			name = segmentName;
+			data = view;
+			size = segmentSize;
+			owner = true;
+			mappingHandle = mapping;
+			return true;
+		}
+
+		bool Segment::openReadOnly(const std::string& segmentName)
+		{
+			close();
+			HANDLE mapping = OpenFileMappingA(FILE_MAP_READ, FALSE, segmentName.c_str());
+			if (mapping == nullptr)
+				return false;
+			void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			MEMORY_BASIC_INFORMATION information;
+			if (view == nullptr || VirtualQuery(view, &information, sizeof(information)) == 0)
+			{
+				if (view != nullptr)
+					UnmapViewOfFile(view);
+				CloseHandle(mapping);
+				return false;
+			}
+			name = segmentName;
+			data = view;
+			size = information.RegionSize;
+			owner = false;
+			mappingHandle = mapping;
+			return true;
+		}
+
+		void Segment::close()
+		{
+			if (data != nullptr)
+				UnmapViewOfFile(data);
+			if (mappingHandle != nullptr)
+				CloseHandle(mappingHandle);
+			// the mapping is released with its last handle, there is no name to unlink
+			data = nullptr;
+			mappingHandle = nullptr;
+			size = 0;
+			owner = false;
+			name.clear();
+		}
+#else
+		// POSIX shared memory names start with a single slash.
+		static std::string posixName(const std::string& segmentName)
+		{
+			return segmentName.starts_with('/') ? segmentName : "/" + segmentName;
+		}
+
+		bool Segment::create(const std::string& segmentName, size_t segmentSize, bool replaceExisting)
+		{
+			close();
+			const std::string sharedName = posixName(segmentName);
+			if (replaceExisting)
+				shm_unlink(sharedName.c_str());
+			const int descriptor = shm_open(sharedName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+			if (descriptor < 0)
+				return false;
+			void* view = MAP_FAILED;
+			if (ftruncate(descriptor, static_cast<off_t>(segmentSize)) == 0)
+				view = mmap(nullptr, segmentSize, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+			::close(descriptor);
+			if (view == MAP_FAILED)
+			{
+				shm_unlink(sharedName.c_str());
+				return false;
+			}
+			name = sharedName;
+			data = view;
+			size = segmentSize;
+			owner = true;
+			return true;
+		}
+
+		bool Segment::openReadOnly(const std::string& segmentName)
+		{
+			close();
+			const std::string sharedName = posixName(segmentName);
+			const int descriptor = shm_open(sharedName.c_str(), O_RDONLY, 0);
+			if (descriptor < 0)
+				return false;
+			struct stat status {};
+			void* view = MAP_FAILED;
+			if (fstat(descriptor, &status) == 0 && status.st_size > 0)
+				view = mmap(nullptr, static_cast<size_t>(status.st_size), PROT_READ, MAP_SHARED, descriptor, 0);
+			::close(descriptor);
+			if (view == MAP_FAILED)
+				return false;
+			name = sharedName;
+			data = view;
+			size = static_cast<size_t>(status.st_size);
+			owner = false;
+			return true;
+		}
+
+		void Segment::close()
+		{
+			if (data != nullptr)
+				munmap(data, size);
+			if (owner)
+				shm_unlink(name.c_str());
+			data = nullptr;
+			size = 0;
+			owner = false;
+			name.clear();
+		}
+#endif
+	}
+}
@@ -0,0 +1,149 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+#include "simulation/shared_memory_publisher.h"
+
+#include <cstring>
+#include <new>
+
+namespace dnf_composer
+{
+	SharedMemoryPublisher::SharedMemoryPublisher(std::shared_ptr<Simulation> targetSimulation, std::string segmentName)
+		: simulation(std::move(targetSimulation)), segmentName(std::move(segmentName))
+	{
+		if (simulation == nullptr || this->segmentName.empty())
+			throw Exception(ErrorCode::SIM_INVALID_PARAMETER);
+	}
+
+	bool SharedMemoryPublisher::addComponent(const std::string& elementId, const std::string& componentId)
+	{
+		if (isOpen())
+		{
+			log(LogLevel::ERROR, "Components cannot be added to the open shared memory segment '" + segmentName + "'.\n");
+			return false;
+		}
+		const ElementHandle handle = simulation->getElementHandle(elementId);
+		const std::vector<std::string> components = simulation->isValid(handle) ? simulation->getElement(handle)->getComponentList() : std::vector<std::string>{};
+		if (std::ranges::find(components, componentId) == components.end()
+			|| elementId.size() >= shared_memory::maxIdLength || componentId.size() >= shared_memory::maxIdLength)
+		{
+			log(LogLevel::ERROR, "Tried to publish an invalid element component '" + elementId + "' - '" + componentId + "'.\n");
+			return false;
+		}
+		componentIds.emplace_back(elementId, componentId);
+		return true;
+	}
+
+	bool SharedMemoryPublisher::open(bool replaceExisting)
+	{
+		if (isOpen() || componentIds.empty())
+		{
+			log(LogLevel::ERROR, "Shared memory segment '" + segmentName + "' is already open or has no components.\n");
+			return false;
+		}
+
+		// components are resolved now, publish() closes the segment once one of their elements is removed or reset
+		componentHandles.clear();
+		componentData.clear();
+		for (const auto& [elementId, componentId] : componentIds)
+		{
+			componentHandles.push_back(simulation->getElementHandle(elementId));
+			componentData.push_back(simulation->getComponentPtr(elementId, componentId));
+		}
+
+		const auto alignUp = [](size_t bytes) { return (bytes + shared_memory::valuesAlignment - 1) / shared_memory::valuesAlignment * shared_memory::valuesAlignment; };
+		std::vector<size_t> offsets;
+		size_t segmentSize = alignUp(sizeof(shared_memory::ChannelHeader) + componentIds.size() * sizeof(shared_memory::ChannelSlot));
+		for (const std::vector<double>* data : componentData)
+		{
+			offsets.push_back(segmentSize);
+			segmentSize += alignUp(data->size() * sizeof(double));
+		}
+
+		if (!segment.create(segmentName, segmentSize, replaceExisting))
+		{
+			log(LogLevel::ERROR, "Shared memory segment '" + segmentName + "' could not be created, or is already in use.\n");
+			return false;
+		}
+
+		auto* bytes = static_cast<std::byte*>(segment.getData());
+		header = new (bytes) shared_memory::ChannelHeader{};
+		header->version = shared_memory::channelVersion;
+		header->numberOfSlots = static_cast<uint32_t>(componentIds.size());
+		header->segmentSize = segmentSize;
+		header->time = simulation->t;
+		header->publisherOpen.store(1, std::memory_order_relaxed);
+
+		auto* slots = reinterpret_cast<shared_memory::ChannelSlot*>(bytes + sizeof(shared_memory::ChannelHeader));
+		slotValues.clear();
+		slotSizes.clear();
+		for (size_t i = 0; i < componentIds.size(); i++)
+		{
+			shared_memory::ChannelSlot& slot = slots[i];
+			std::ranges::copy(componentIds[i].first, slot.elementId);
+			std::ranges::copy(componentIds[i].second, slot.componentId);
+			slot.offset = offsets[i];
+			slot.size = componentData[i]->size();
+			slotValues.push_back(reinterpret_cast<double*>(bytes + offsets[i]));
+			slotSizes.push_back(slot.size);
+			std::memcpy(slotValues[i], componentData[i]->data(), slot.size * sizeof(double));
+		}
+		header->magicNumber.store(shared_memory::channelMagicNumber, std::memory_order_release);
+
+		log(LogLevel::INFO, "Publishing " + std::to_string(componentIds.size()) + " components to shared memory segment '" + segmentName + "'.\n");
+		return true;
+	}
+
+	void SharedMemoryPublisher::publish()
+	{
+		if (!isOpen())
+			return;
+		for (size_t i = 0; i < componentData.size(); i++)
+			if (!simulation->isValid(componentHandles[i]) || componentData[i]->size() != slotSizes[i])
+			{
+				log(LogLevel::ERROR, "Component '" + componentIds[i].first + "' - '" + componentIds[i].second + "' was removed or no longer fits its slot in shared memory segment '" + segmentName + "', which was closed.\n");
+				close();
+				return;
+			}
+
+		const uint64_t sequence = header->sequence.load(std::memory_order_relaxed);
+		header->sequence.store(sequence + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		for (size_t i = 0; i < componentData.size(); i++)
+			std::memcpy(slotValues[i], componentData[i]->data(), slotSizes[i] * sizeof(double));
+		header->time = simulation->t;
+		header->sequence.store(sequence + 2, std::memory_order_release);
+	}
+
+	void SharedMemoryPublisher::close()
+	{
+		if (!isOpen())
+			return;
+		header->publisherOpen.store(0, std::memory_order_release);
+		header = nullptr;
+		slotValues.clear();
+		slotSizes.clear();
+		segment.close();
+	}
+
+	bool SharedMemoryPublisher::isOpen() const
+	{
+		return header != nullptr;
+	}
+
+	const std::string& SharedMemoryPublisher::getSegmentName() const
+	{
+		return segmentName;
+	}
+
+	int SharedMemoryPublisher::getNumberOfComponents() const
+	{
+		return static_cast<int>(componentIds.size());
+	}
+
+	SharedMemoryPublisher::~SharedMemoryPublisher()
+	{
+		close();
+	}
+}
@@ -0,0 +1,136 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+#include "simulation/shared_memory_reader.h"
+
+#include <cstring>
+
+namespace dnf_composer
+{
+	bool SharedMemoryReader::open(const std::string& segmentName)
+	{
+		close();
+		if (!segment.openReadOnly(segmentName))
+			return false;
+
+		const size_t segmentSize = segment.getSize();
+		const auto* bytes = static_cast<const std::byte*>(segment.getData());
+		const auto* segmentHeader = reinterpret_cast<const shared_memory::ChannelHeader*>(bytes);
+		if (segmentSize < sizeof(shared_memory::ChannelHeader)
+			|| segmentHeader->magicNumber.load(std::memory_order_acquire) != shared_memory::channelMagicNumber
+			|| segmentHeader->version != shared_memory::channelVersion
+			|| segmentHeader->segmentSize > segmentSize
+			|| sizeof(shared_memory::ChannelHeader) + segmentHeader->numberOfSlots * sizeof(shared_memory::ChannelSlot) > segmentSize)
+		{
+			segment.close();
+			return false;
+		}
+
+		const auto* segmentSlots = reinterpret_cast<const shared_memory::ChannelSlot*>(bytes + sizeof(shared_memory::ChannelHeader));
+		for (uint32_t i = 0; i < segmentHeader->numberOfSlots; i++)
+			if (segmentSlots[i].offset + segmentSlots[i].size * sizeof(double) > segmentSize)
+			{
+				segment.close();
+				return false;
+			}
+
+		header = segmentHeader;
+		slots = segmentSlots;
+		lastFrameRead = 0;
+		buffer.values.resize(header->numberOfSlots);
+		for (uint32_t i = 0; i < header->numberOfSlots; i++)
+			buffer.values[i].resize(slots[i].size);
+		return true;
+	}
+
+	void SharedMemoryReader::close()
+	{
+		header = nullptr;
+		slots = nullptr;
+		segment.close();
+	}
+
+	bool SharedMemoryReader::isOpen() const
+	{
+		return header != nullptr;
+	}
+
+	bool SharedMemoryReader::isPublisherOpen() const
+	{
+		return isOpen() && header->publisherOpen.load(std::memory_order_acquire) != 0;
+	}
+
+	int SharedMemoryReader::getNumberOfComponents() const
+	{
+		return isOpen() ? static_cast<int>(header->numberOfSlots) : 0;
+	}
+
+	std::string SharedMemoryReader::getElementId(int index) const
+	{
+		if (index < 0 || index >= getNumberOfComponents())
+			return {};
+		return { slots[index].elementId, strnlen(slots[index].elementId, shared_memory::maxIdLength) };
+	}
+
+	std::string SharedMemoryReader::getComponentId(int index) const
+	{
+		if (index < 0 || index >= getNumberOfComponents())
+			return {};
+		return { slots[index].componentId, strnlen(slots[index].componentId, shared_memory::maxIdLength) };
+	}
+
+	int SharedMemoryReader::getComponentSize(int index) const
+	{
+		if (index < 0 || index >= getNumberOfComponents())
+			return 0;
+		return static_cast<int>(slots[index].size);
+	}
+
+	int SharedMemoryReader::findComponent(const std::string& elementId, const std::string& componentId) const
+	{
+		for (int i = 0; i < getNumberOfComponents(); i++)
+			if (getElementId(i) == elementId && getComponentId(i) == componentId)
+				return i;
+		return -1;
+	}
+
+	uint64_t SharedMemoryReader::getPublishedFrames() const
+	{
+		return isOpen() ? header->sequence.load(std::memory_order_acquire) / 2 : 0;
+	}
+
+	bool SharedMemoryReader::read(SharedMemoryFrame& frame, int attempts)
+	{
+		if (!isOpen())
+			return false;
+
+		const auto* bytes = static_cast<const std::byte*>(segment.getData());
+		for (int attempt = 0; attempt < attempts; attempt++)
+		{
+			const uint64_t sequence = header->sequence.load(std::memory_order_acquire);
+			if (sequence % 2 != 0)
+				continue;
+			for (uint32_t i = 0; i < header->numberOfSlots; i++)
+				std::memcpy(buffer.values[i].data(), bytes + slots[i].offset, slots[i].size * sizeof(double));
+			buffer.time = header->time;
+			std::atomic_thread_fence(std::memory_order_acquire);
+			if (header->sequence.load(std::memory_order_relaxed) != sequence)
+				continue;
+
+			buffer.number = sequence / 2;
+			lastFrameRead = buffer.number;
+			// reuses the storage of the frame, so reading the same frame again does not allocate
+			frame = buffer;
+			return true;
+		}
+		return false;
+	}
+
+	bool SharedMemoryReader::readNext(SharedMemoryFrame& frame, int attempts)
+	{
+		if (getPublishedFrames() == lastFrameRead)
+			return false;
+		return read(frame, attempts);
+	}
+}
@@ -4,6 +4,10 @@
 
 #include "simulation/simulation.h"
 
+#include "elements/neural_field.h"
+#include "elements/gauss_stimulus.h"
+#include "simulation/experiment_timeline.h"
+
 
 namespace dnf_composer
 {
@@ -16,14 +20,152 @@ namespace dnf_composer
 		initialized = false;
 		paused = false;
 		elements = {};
+		removedPositions = {};
+		kernelBatching = true;
+		kernelBatchesOutdated = true;
+		compiled = false;
+		architectureRevisions = std::make_shared<element::ArchitectureRevisions>();
+	}
+
+	std::shared_ptr<Simulation> Simulation::clone() const
+	{
+		auto simulationClone = std::make_shared<Simulation>(deltaT, tZero, t);
+		simulationClone->initialized = initialized;
+		simulationClone->paused = paused;
+		simulationClone->kernelBatching = kernelBatching;
+		simulationClone->compiled = compiled;
+		simulationClone->elements.reserve(elements.size());
+
+		std::unordered_map<const element::Element*, std::shared_ptr<element::Element>> clones;
+		clones.reserve(elements.size());
+		for (const auto& element : elements)
+		{
+			if (!element)
+				continue;
+			const std::shared_ptr<element::Element> elementClone = element->clone();
+			if (!elementClone)
+			{
+				const std::string logMessage = "Simulation could not be cloned because element '" + element->getUniqueName() + "' is not clonable.\n";
+				log(LogLevel::ERROR, logMessage);
+				return nullptr;
+			}
+			clones[element.get()] = elementClone;
+			simulationClone->insertElement(elementClone);
+		}
+
+		// connect the clones to each other instead of to the original elements
+		for (const auto& element : elements)
+			if (element)
+				clones.at(element.get())->copyInputs(*element, clones);
+
+		return simulationClone;
+	}
+
+	bool Simulation::saveCheckpoint(std::ostream& stream) const
+	{
+		utilities::writeBinary(stream, checkpointMagicNumber);
+		utilities::writeBinary(stream, deltaT);
+		utilities::writeBinary(stream, tZero);
+		utilities::writeBinary(stream, t);
+		utilities::writeBinary(stream, initialized);
+		utilities::writeBinary(stream, static_cast<uint32_t>(getNumberOfElements()));
+
+		// every element state is length-prefixed so that restoring can validate it in isolation
+		std::ostringstream elementState;
+		for (const auto& element : elements)
+		{
+			if (!element)
+				continue;
+			elementState.str(std::string());
+			element->writeState(elementState);
+			utilities::writeBinary(stream, element->getUniqueName());
+			utilities::writeBinary(stream, static_cast<int32_t>(element->getLabel()));
+			utilities::writeBinary(stream, elementState.str());
+		}
+
+		if (!stream)
+		{
+			log(LogLevel::ERROR, "Failed to write simulation checkpoint.\n");
+			return false;
+		}
+		return true;
+	}
+
+	bool Simulation::loadCheckpoint(std::istream& stream)
+	{
+		uint32_t magicNumber = 0, numberOfElements = 0;
+		double storedDeltaT = 0.0, storedTZero = 0.0, storedT = 0.0;
+		bool storedInitialized = false;
+		utilities::readBinary(stream, magicNumber);
+		utilities::readBinary(stream, storedDeltaT);
+		utilities::readBinary(stream, storedTZero);
+		utilities::readBinary(stream, storedT);
+		utilities::readBinary(stream, storedInitialized);
+		utilities::readBinary(stream, numberOfElements);
+
+		if (!stream || magicNumber != checkpointMagicNumber || numberOfElements != static_cast<uint32_t>(getNumberOfElements()))
+		{
+			log(LogLevel::ERROR, "Simulation checkpoint does not match this simulation.\n");
+			return false;
+		}
+
+		// read and validate every entry before any element is modified
+		std::vector<std::pair<std::shared_ptr<element::Element>, std::string>> states;
+		states.reserve(numberOfElements);
+		for (uint32_t i = 0; i < numberOfElements; i++)
+		{
+			std::string elementName, elementState;
+			int32_t label = 0;
+			utilities::readBinary(stream, elementName);
+			utilities::readBinary(stream, label);
+			utilities::readBinary(stream, elementState);
+
+			const ElementSlot* slot = findElementSlot(elementName);
+			if (!stream || !slot || slot->element->getLabel() != label)
+			{
+				const std::string logMessage = "Simulation checkpoint entry '" + elementName + "' does not match any element of this simulation.\n";
+				log(LogLevel::ERROR, logMessage);
+				return false;
+			}
+			states.emplace_back(slot->element, std::move(elementState));
+		}
+
+		for (const auto& [element, elementState] : states)
+		{
+			std::istringstream elementStream(elementState);
+			element->readState(elementStream);
+			if (!elementStream)
+			{
+				const std::string logMessage = "Failed to restore the state of element '" + element->getUniqueName() + "' from the simulation checkpoint.\n";
+				log(LogLevel::ERROR, logMessage);
+				return false;
+			}
+		}
+		// delay lines are not part of checkpoints, they restart from the restored values
+		for (const auto& [element, elementState] : states)
+			element->resetDelayLines();
+
+		deltaT = storedDeltaT;
+		tZero = storedTZero;
+		t = storedT;
+		initialized = storedInitialized;
+		return true;
 	}
 
 	void Simulation::init()
 	{
 		paused = false;
 		t = tZero;
+		compactElements();
 		for (const auto& element : elements)
+		{
+			element->setInitTime(tZero);
 			element->init();
+		}
+		// after every element initialized, delay lines start from the initial values of what they delay
+		for (const auto& element : elements)
+			element->resetDelayLines();
+		kernelBatchesOutdated = true;
 
 		initialized = true;
 		log(LogLevel::INFO, "Simulation initialized.\n");
@@ -34,19 +176,86 @@ namespace dnf_composer
 		if (paused)
 			return;
 		t += deltaT;
+		if (!removedPositions.empty())
+			compactElements();
+		updateKernelBatches();
+		if (executionPlan)
+			executionPlan->execute(t, deltaT);
+		else
+		{
+			for (size_t position = 0; position < elements.size(); position++)
+			{
+				const int batch = batchOfElement[position];
+				if (batch < 0)
+					elements[position]->step(t, deltaT);
+				else if (kernelBatches[batch].kernels.front() == elements[position].get())
+					element::Kernel::stepBatch(kernelBatches[batch]);
+			}
+		}
+
 		for (const auto& element : elements)
-			element->step(t, deltaT);
+			if (element->hasDelayLines())
+				element->recordDelayLines();
 	}
 
 	void Simulation::close()
 	{
 		for (const auto& element : elements)
-			element->close();
+			if (element)
+				element->close();
 		
 		initialized = false;
 		log(LogLevel::INFO, "Simulation closed.\n");
 	}
 
+	void Simulation::setKernelBatching(bool enable)
+	{
+		kernelBatching = enable;
+		kernelBatchesOutdated = true;
+	}
+
+	bool Simulation::getKernelBatching() const
+	{
+		return kernelBatching;
+	}
+
+	int Simulation::getNumberOfKernelBatches()
+	{
+		compactElements();
+		updateKernelBatches();
+		return static_cast<int>(kernelBatches.size());
+	}
+
+	void Simulation::compile()
+	{
+		compiled = true;
+		compactElements();
+		buildKernelBatches();
+		if (isLogLevelEnabled(LogLevel::INFO))
+			log(LogLevel::INFO, "Simulation compiled into " + std::to_string(executionPlan->getOperations().size()) + " operations.\n");
+	}
+
+	void Simulation::decompile()
+	{
+		compiled = false;
+		executionPlan.reset();
+	}
+
+	bool Simulation::isCompiled() const
+	{
+		return compiled;
+	}
+
+	const ExecutionPlan* Simulation::getExecutionPlan()
+	{
+		if (compiled)
+		{
+			compactElements();
+			updateKernelBatches();
+		}
+		return executionPlan.get();
+	}
+
 	void Simulation::pause()
 	{
 		paused = true;
@@ -75,71 +284,422 @@ namespace dnf_composer
 		close();
 	}
 
-	void Simulation::addElement(const std::shared_ptr<element::Element>& element)
+	namespace
 	{
-		// Check if an element with the same id already exists
-		const std::string newElementName = element->getUniqueName();
-		for (const auto& existingElement : elements) {
-			if (existingElement->getUniqueName() == newElementName) 
+		// One run of an experiment timeline: its events resolved to the elements and components they act on and
+		// sorted by step, the recordings in progress and the gains disabled stimuli had.
+		class ExperimentRun
+		{
+		private:
+			using Kind = TimelineEvent::Kind;
+
+			struct ScheduledEvent
 			{
-				const std::string logMessage = "An element with the same unique name already exists '" + newElementName + "'! New element was not added.\n";
-				log(LogLevel::WARNING, logMessage);
-				return;
+				size_t step;
+				const TimelineEvent* event;
+				std::shared_ptr<element::Element> element;
+				std::vector<double>* component;
+			};
+
+			struct ActiveRecording
+			{
+				// position of the start event in the schedule, its component is resolved again with the rest
+				size_t start;
+				ExperimentRecording* recording;
+			};
+
+			Simulation& simulation;
+			ExperimentResults results;
+			std::vector<ScheduledEvent> schedule;
+			bool resolved = false;
+			size_t lastStep;
+			std::vector<ActiveRecording> activeRecordings;
+			// consumers of each disabled stimulus by name with their gains, names stay valid when actions replace elements
+			std::unordered_map<std::string, std::vector<std::pair<std::string, double>>> disabledGains;
+		public:
+			ExperimentRun(Simulation& simulation, const ExperimentTimeline& timeline);
+
+			ExperimentResults run();
+		private:
+			size_t stepOf(double time) const;
+			bool resolve(ScheduledEvent& scheduled) const;
+			// Actions may remove or replace elements, so the events still due and the active recordings are resolved again.
+			bool resolveAfterAction(size_t next);
+			void fire(size_t index, size_t stepIndex);
+			void disableStimulus(const ScheduledEvent& scheduled);
+			void enableStimulus(const ScheduledEvent& scheduled);
+			void startRecording(size_t index, size_t stepIndex);
+			void appendFrame(const ActiveRecording& active, double time);
+		};
+
+		ExperimentRun::ExperimentRun(Simulation& simulation, const ExperimentTimeline& timeline)
+			: simulation(simulation), lastStep(stepOf(timeline.getDuration()))
+		{
+			schedule.reserve(timeline.getEvents().size());
+			for (const TimelineEvent& event : timeline.getEvents())
+			{
+				ScheduledEvent scheduled{ stepOf(event.time), &event, nullptr, nullptr };
+				if (!resolve(scheduled))
+					return;
+				lastStep = std::max(lastStep, scheduled.step);
+				schedule.push_back(std::move(scheduled));
 			}
+			std::ranges::stable_sort(schedule, {}, &ScheduledEvent::step);
+			resolved = true;
 		}
 
-		elements.push_back(element);
-		element->init(); 
+		ExperimentResults ExperimentRun::run()
+		{
+			if (!resolved)
+				return results;
 
-		const std::string logMessage = "Element '" + newElementName + "' was added to the simulation.\n";
-		log(LogLevel::INFO, logMessage);
-	}
+			if (!simulation.isInitialized())
+				simulation.init();
 
-	void Simulation::removeElement(const std::string& elementId)
-	{
-		for (const auto& element : elements)
-			element->removeInput(elementId);
+			size_t next = 0;
+			for (size_t stepIndex = 0; ; stepIndex++)
+			{
+				while (next < schedule.size() && schedule[next].step == stepIndex)
+				{
+					fire(next++, stepIndex);
+					if (schedule[next - 1].event->kind == Kind::ACTION && !resolveAfterAction(next))
+						return results;
+				}
+				if (stepIndex == lastStep)
+					break;
+				simulation.step();
+				for (const ActiveRecording& active : activeRecordings)
+					appendFrame(active, static_cast<double>(stepIndex + 1) * simulation.deltaT);
+			}
+
+			results.completed = true;
+			return results;
+		}
 
-		for (int i = 0; i < static_cast<int>(elements.size()); i++)
+		size_t ExperimentRun::stepOf(double time) const
 		{
-			if (elements[i]->getUniqueName() == elementId)
+			return static_cast<size_t>(std::max(0.0, std::ceil(time / simulation.deltaT - 1e-9)));
+		}
+
+		bool ExperimentRun::resolve(ScheduledEvent& scheduled) const
+		{
+			const TimelineEvent& event = *scheduled.event;
+			bool resolved = true;
+			if (!event.element.empty())
 			{
-				elements.erase(elements.begin() + i);
-				const std::string logMessage = "Element '" + elementId + "' was removed from the simulation.\n";
-				log(LogLevel::INFO, logMessage);
-				return;
+				const ElementHandle handle = simulation.getElementHandle(event.element);
+				scheduled.element = simulation.isValid(handle) ? simulation.getElement(handle) : nullptr;
+				resolved = scheduled.element != nullptr;
+			}
+			if (resolved && (event.kind == Kind::SET_COMPONENT || event.kind == Kind::START_RECORDING || event.kind == Kind::SNAPSHOT))
+			{
+				const std::vector<std::string> componentNames = scheduled.element->getComponentList();
+				resolved = std::ranges::find(componentNames, event.target) != componentNames.end();
+				if (resolved)
+					scheduled.component = scheduled.element->getComponentPtr(event.target);
+			}
+			if (resolved && (event.kind == Kind::SET_STIMULUS_POSITION || event.kind == Kind::SET_STIMULUS_AMPLITUDE))
+				resolved = std::dynamic_pointer_cast<element::GaussStimulus>(scheduled.element) != nullptr;
+			if (resolved && event.kind == Kind::SET_INPUT_GAIN)
+			{
+				const ElementHandle receiver = simulation.getElementHandle(event.target);
+				resolved = simulation.isValid(receiver) && std::ranges::any_of(simulation.getElement(receiver)->getInputConnections(),
+					[&](const element::InputConnection& connection) { return connection.element == scheduled.element; });
+			}
+			if (resolved && event.kind == Kind::ACTION)
+				resolved = static_cast<bool>(event.action);
+			if (!resolved)
+			{
+				const std::string logMessage = "Experiment timeline event at time " + std::to_string(event.time) + " refers to '" + event.element + "' (" + event.target + ") which cannot be resolved. The experiment was stopped.\n";
+				log(LogLevel::ERROR, logMessage);
+			}
+			return resolved;
+		}
+
+		bool ExperimentRun::resolveAfterAction(size_t next)
+		{
+			for (size_t index = next; index < schedule.size(); index++)
+				if (!resolve(schedule[index]))
+					return false;
+			for (const ActiveRecording& active : activeRecordings)
+			{
+				ScheduledEvent& start = schedule[active.start];
+				if (!resolve(start))
+					return false;
+				if (start.component->size() != active.recording->frameSize)
+				{
+					log(LogLevel::ERROR, "Recording '" + start.event->label + "' changed its frame size in an action. The experiment was stopped.\n");
+					return false;
+				}
+			}
+			return true;
+		}
+
+		void ExperimentRun::fire(size_t index, size_t stepIndex)
+		{
+			const ScheduledEvent& scheduled = schedule[index];
+			const TimelineEvent& event = *scheduled.event;
+			switch (event.kind)
+			{
+			case Kind::SET_COMPONENT:
+				std::ranges::fill(*scheduled.component, event.value);
+				break;
+			case Kind::SET_STIMULUS_POSITION:
+				std::static_pointer_cast<element::GaussStimulus>(scheduled.element)->setPosition(event.value);
+				break;
+			case Kind::SET_STIMULUS_AMPLITUDE:
+				std::static_pointer_cast<element::GaussStimulus>(scheduled.element)->setAmplitude(event.value);
+				break;
+			case Kind::SET_INPUT_GAIN:
+				simulation.setInteractionGain(event.element, event.target, event.value);
+				break;
+			case Kind::DISABLE_STIMULUS:
+				disableStimulus(scheduled);
+				break;
+			case Kind::ENABLE_STIMULUS:
+				enableStimulus(scheduled);
+				break;
+			case Kind::START_RECORDING:
+				startRecording(index, stepIndex);
+				break;
+			case Kind::STOP_RECORDING:
+				std::erase_if(activeRecordings, [&](const ActiveRecording& active) { return schedule[active.start].event->label == event.label; });
+				break;
+			case Kind::SNAPSHOT:
+				results.snapshots[event.label] = *scheduled.component;
+				break;
+			case Kind::WAIT_UNTIL_STABLE:
+				results.settlingSteps.push_back(simulation.runUntilStable(event.criteria));
+				break;
+			case Kind::ACTION:
+				event.action(simulation);
+				break;
 			}
 		}
-		const std::string logMessage = "Element '" + elementId + "' was not found and consequently not removed from the simulation.\n";
-		log(LogLevel::FATAL, logMessage);
+
+		void ExperimentRun::disableStimulus(const ScheduledEvent& scheduled)
+		{
+			const std::string& stimulus = scheduled.event->element;
+			if (disabledGains.contains(stimulus))
+				return;
+			auto& saved = disabledGains[stimulus];
+			for (element::Element* consumer : scheduled.element->getConsumers())
+				for (const element::InputConnection& connection : consumer->getInputConnections())
+					if (connection.element == scheduled.element)
+						saved.emplace_back(consumer->getUniqueName(), connection.gain);
+			for (const auto& [consumer, gain] : saved)
+				simulation.setInteractionGain(stimulus, consumer, 0.0);
+		}
+
+		void ExperimentRun::enableStimulus(const ScheduledEvent& scheduled)
+		{
+			const auto saved = disabledGains.find(scheduled.event->element);
+			if (saved == disabledGains.end())
+				return;
+			for (const auto& [consumer, gain] : saved->second)
+				if (simulation.isValid(simulation.getElementHandle(consumer)))
+					simulation.setInteractionGain(saved->first, consumer, gain);
+			disabledGains.erase(saved);
+		}
+
+		void ExperimentRun::startRecording(size_t index, size_t stepIndex)
+		{
+			const ScheduledEvent& scheduled = schedule[index];
+			const std::string& label = scheduled.event->label;
+			ExperimentRecording& recording = results.recordings[label];
+			recording.frameSize = scheduled.component->size();
+			// frames until the matching stop, or the end of the timeline
+			size_t stopStep = lastStep;
+			for (size_t later = index + 1; later < schedule.size(); later++)
+				if (schedule[later].event->kind == Kind::STOP_RECORDING && schedule[later].event->label == label)
+				{
+					stopStep = schedule[later].step;
+					break;
+				}
+			const size_t frames = stopStep - stepIndex + 1;
+			recording.times.reserve(recording.times.size() + frames);
+			recording.values.reserve(recording.values.size() + frames * recording.frameSize);
+			activeRecordings.push_back({ index, &recording });
+			appendFrame(activeRecordings.back(), static_cast<double>(stepIndex) * simulation.deltaT);
+		}
+
+		void ExperimentRun::appendFrame(const ActiveRecording& active, double time)
+		{
+			const std::vector<double>& component = *schedule[active.start].component;
+			active.recording->times.push_back(time);
+			active.recording->values.insert(active.recording->values.end(), component.begin(), component.end());
+		}
 	}
 
-	void Simulation::resetElement(const std::string& idOfElementToReset, const std::shared_ptr<element::Element>& newElement)
+	ExperimentResults Simulation::run(const ExperimentTimeline& timeline)
 	{
-		bool elementFound = false;
+		return ExperimentRun(*this, timeline).run();
+	}
 
-		for (auto& element : elements) 
+	int Simulation::runUntilStable(const StabilityCriteria& criteria)
+	{
+		if (criteria.maxSteps <= 0 || criteria.consecutiveSteps <= 0)
+			throw Exception(ErrorCode::SIM_INVALID_PARAMETER, "Invalid stability criteria for runUntilStable()");
+
+		struct MonitoredField
 		{
-			if (element->getUniqueName() == idOfElementToReset) 
+			std::shared_ptr<element::NeuralField> field;
+			StabilityMeasure measure;
+			double tolerance;
+			double previousCentroid;
+		};
+
+		// resolve the monitored fields once, the loop below only reads the by-products of their step
+		std::vector<MonitoredField> monitoredFields;
+		if (criteria.fields.empty())
+		{
+			for (const auto& element : elements)
+				if (const auto field = std::dynamic_pointer_cast<element::NeuralField>(element))
+					monitoredFields.push_back({ field, StabilityMeasure::ACTIVATION_CHANGE, criteria.defaultTolerance, 0.0 });
+		}
+		for (const auto& criterion : criteria.fields)
+		{
+			const auto field = std::dynamic_pointer_cast<element::NeuralField>(getElement(criterion.fieldId));
+			if (!field)
 			{
-				element = newElement;
-				element->init();
-				const std::string logMessage = "Element '" + idOfElementToReset + "' was reset in the simulation.\n";
-				log(LogLevel::INFO, logMessage);
-				elementFound = true;
-				break;
+				const std::string logMessage = "Element '" + criterion.fieldId + "' is not a neural field and cannot be monitored for stability.\n";
+				log(LogLevel::ERROR, logMessage);
+				return 0;
 			}
+			monitoredFields.push_back({ field, criterion.measure, criterion.tolerance, 0.0 });
 		}
 
-		if (!elementFound)
+		if (!initialized)
+			init();
+
+		for (auto& monitoredField : monitoredFields)
+			monitoredField.previousCentroid = monitoredField.field->getCentroid();
+
+		int stableSteps = 0;
+		for (int steps = 1; steps <= criteria.maxSteps; steps++)
+		{
+			step();
+
+			bool stable = true;
+			for (auto& monitoredField : monitoredFields)
+			{
+				const double centroid = monitoredField.field->getCentroid();
+				const double change = monitoredField.measure == StabilityMeasure::ACTIVATION_CHANGE ?
+					monitoredField.field->getMaxActivationChange() : std::fabs(centroid - monitoredField.previousCentroid);
+				monitoredField.previousCentroid = centroid;
+				stable = stable && change <= monitoredField.tolerance;
+			}
+
+			stableSteps = stable ? stableSteps + 1 : 0;
+			if (stableSteps >= criteria.consecutiveSteps)
+				return steps;
+		}
+
+		log(LogLevel::WARNING, "Simulation did not reach a stable state within " + std::to_string(criteria.maxSteps) + " steps.\n");
+		return criteria.maxSteps;
+	}
+
+	ElementHandle Simulation::addElement(const std::shared_ptr<element::Element>& element)
+	{
+		// Check if an element with the same id already exists
+		const std::string newElementName = element->getUniqueName();
+		if (elementHandles.contains(newElementName))
+		{
+			const std::string logMessage = "An element with the same unique name already exists '" + newElementName + "'! New element was not added.\n";
+			log(LogLevel::WARNING, logMessage);
+			return {};
+		}
+
+		const ElementHandle handle = insertElement(element);
+		element->setInitTime(t);
+		element->init();
+		kernelBatchesOutdated = true;
+
+		if (isLogLevelEnabled(LogLevel::INFO))
+			log(LogLevel::INFO, "Element '" + newElementName + "' was added to the simulation.\n");
+		return handle;
+	}
+
+	void Simulation::removeElement(const std::string& elementId)
+	{
+		const auto handle = elementHandles.find(elementId);
+		if (handle == elementHandles.end())
+		{
+			const std::string logMessage = "Element '" + elementId + "' was not found and consequently not removed from the simulation.\n";
+			log(LogLevel::FATAL, logMessage);
+			return;
+		}
+		removeElement(handle->second);
+	}
+
+	void Simulation::removeElement(const ElementHandle& handle)
+	{
+		if (!isValid(handle))
+		{
+			log(LogLevel::FATAL, "Element handle is no longer valid and consequently no element was removed from the simulation.\n");
+			return;
+		}
+
+		const ElementSlot& slot = elementSlots[handle.slot];
+		const std::shared_ptr<element::Element> element = slot.element;
+		const std::string elementId = element->getUniqueName();
+
+		// only the elements that consume the removed one have to be disconnected
+		for (element::Element* consumer : element->getConsumers())
+		{
+			const ElementSlot* consumerSlot = findElementSlot(consumer->getUniqueName());
+			if (consumerSlot && consumerSlot->element.get() == consumer)
+				consumer->removeInput(elementId);
+		}
+
+		elements[slot.position] = nullptr;
+		removedPositions.insert(std::ranges::upper_bound(removedPositions, slot.position), slot.position);
+		kernelBatchesOutdated = true;
+		releaseElementSlot(handle);
+		// amortized compaction bounds the number of tombstones and so the cost of keeping their positions sorted
+		if (removedPositions.size() * 2 > elements.size())
+			compactElements();
+
+		if (isLogLevelEnabled(LogLevel::INFO))
+			log(LogLevel::INFO, "Element '" + elementId + "' was removed from the simulation.\n");
+	}
+
+	void Simulation::resetElement(const std::string& idOfElementToReset, const std::shared_ptr<element::Element>& newElement)
+	{
+		const auto handle = elementHandles.find(idOfElementToReset);
+		if (handle == elementHandles.end())
 		{
 			const std::string logMessage = "Element '" + idOfElementToReset + "' was not found and consequently not reset.\n";
 			log(LogLevel::FATAL, logMessage);
+			return;
+		}
+
+		const std::string newElementName = newElement->getUniqueName();
+		if (newElementName != idOfElementToReset && elementHandles.contains(newElementName))
+		{
+			const std::string logMessage = "An element with the same unique name already exists '" + newElementName + "'! Element '" + idOfElementToReset + "' was not reset.\n";
+			log(LogLevel::WARNING, logMessage);
+			return;
 		}
+
+		// the new element takes over the position in the step order, handles to the old element become stale
+		const size_t position = elementSlots[handle->second.slot].position;
+		releaseElementSlot(handle->second);
+		const ElementHandle newHandle = insertElement(newElement);
+		elements.pop_back();
+		elements[position] = newElement;
+		elementSlots[newHandle.slot].position = position;
+		newElement->setInitTime(t);
+		newElement->init();
+		newElement->resetDelayLines();
+		kernelBatchesOutdated = true;
+
+		const std::string logMessage = "Element '" + idOfElementToReset + "' was reset in the simulation.\n";
+		log(LogLevel::INFO, logMessage);
 	}
 
 	void Simulation::createInteraction(const std::string& stimulusElementId, 
-		const std::string& stimulusComponent, const std::string& receivingElementId) const
+		const std::string& stimulusComponent, const std::string& receivingElementId, double gain, int delay) const
 	{
 		const std::shared_ptr<element::Element> stimulusElement = getElement(stimulusElementId);
 		const std::shared_ptr<element::Element> receivingElement = getElement(receivingElementId);
@@ -160,26 +720,111 @@ namespace dnf_composer
 			//throw Exception(ErrorCode::SIM_ELEM_NOT_FOUND, receivingElementId);
 		}
 
-		receivingElement->addInput(stimulusElement, stimulusComponent);
+		receivingElement->addInput(stimulusElement, stimulusComponent, gain, delay);
 
-		const std::string logMessage = "Interaction created: " + stimulusElementId + " -> " + receivingElementId + '\n';
-		log(LogLevel::INFO, logMessage);
+		if (isLogLevelEnabled(LogLevel::INFO))
+			log(LogLevel::INFO, "Interaction created: " + stimulusElementId + " -> " + receivingElementId + '\n');
+
+	}
+
+	void Simulation::setInteractionGain(const std::string& stimulusElementId, const std::string& receivingElementId, double gain) const
+	{
+		const std::shared_ptr<element::Element> receivingElement = getElement(receivingElementId);
+		if (!receivingElement || !receivingElement->setInputGain(stimulusElementId, gain))
+		{
+			const std::string logMessage = "Interaction " + stimulusElementId + " -> " + receivingElementId + " does not exist and consequently its gain was not changed.\n";
+			log(LogLevel::ERROR, logMessage);
+		}
+	}
 
+	void Simulation::removeInteraction(const std::string& stimulusElementId, const std::string& receivingElementId) const
+	{
+		const std::shared_ptr<element::Element> receivingElement = getElement(receivingElementId);
+		if (!receivingElement->removeInput(stimulusElementId))
+		{
+			const std::string logMessage = "Interaction " + stimulusElementId + " -> " + receivingElementId + " does not exist and consequently was not removed.\n";
+			log(LogLevel::ERROR, logMessage);
+			return;
+		}
+
+		if (isLogLevelEnabled(LogLevel::INFO))
+			log(LogLevel::INFO, "Interaction removed: " + stimulusElementId + " -> " + receivingElementId + '\n');
+	}
+
+	void Simulation::retargetInteraction(const std::string& stimulusElementId, const std::string& stimulusComponent,
+		const std::string& previousReceivingElementId, const std::string& newReceivingElementId) const
+	{
+		const std::shared_ptr<element::Element> previousReceivingElement = getElement(previousReceivingElementId);
+		if (!previousReceivingElement->hasInput(stimulusElementId, stimulusComponent))
+		{
+			const std::string logMessage = "Interaction " + stimulusElementId + " -> " + previousReceivingElementId + " does not exist and consequently was not retargeted.\n";
+			log(LogLevel::ERROR, logMessage);
+			return;
+		}
+
+		double gain = 1.0;
+		int delay = 0;
+		for (const element::InputConnection& connection : previousReceivingElement->getInputConnections())
+			if (connection.element->getUniqueName() == stimulusElementId && connection.component == stimulusComponent)
+			{
+				gain = connection.gain;
+				delay = connection.delay;
+			}
+
+		previousReceivingElement->removeInput(stimulusElementId);
+		createInteraction(stimulusElementId, stimulusComponent, newReceivingElementId, gain, delay);
+	}
+
+	void Simulation::initElement(const std::string& id)
+	{
+		const std::shared_ptr<element::Element> element = getElement(id);
+		element->setInitTime(t);
+		element->init();
+		element->resetDelayLines();
+		kernelBatchesOutdated = true;
+	}
+
+	ElementHandle Simulation::getElementHandle(const std::string& id) const
+	{
+		const auto handle = elementHandles.find(id);
+		if (handle == elementHandles.end())
+			return {};
+		return handle->second;
+	}
+
+	bool Simulation::isValid(const ElementHandle& handle) const
+	{
+		return handle.slot < elementSlots.size() && elementSlots[handle.slot].generation == handle.generation
+			&& elementSlots[handle.slot].element != nullptr;
 	}
 
 	std::shared_ptr<element::Element> Simulation::getElement(const std::string& id) const
 	{
-		for (const auto& element : elements)
-			if (element->getUniqueName() == id)
-				return element;
+		if (const ElementSlot* slot = findElementSlot(id))
+			return slot->element;
 
 		throw Exception(ErrorCode::SIM_ELEM_NOT_FOUND, id);
 	}
 
+	std::shared_ptr<element::Element> Simulation::getElement(const ElementHandle& handle) const
+	{
+		if (isValid(handle))
+			return elementSlots[handle.slot].element;
+
+		throw Exception(ErrorCode::SIM_ELEM_INDEX, static_cast<int>(handle.slot));
+	}
+
 	std::shared_ptr<element::Element> Simulation::getElement(const int index) const 
 	{
-		if (index < static_cast<int>(elements.size()))
-			return elements[index];
+		if (index >= 0 && index < getNumberOfElements())
+		{
+			// skip the tombstones of removed elements that were not compacted yet: the k-th tombstone
+			// is preceded by removedPositions[k] - k live elements, the ones up to index precede it
+			const auto tombstones = std::views::iota(size_t{ 0 }, removedPositions.size());
+			const auto tombstonesBefore = std::ranges::partition_point(tombstones, [&](size_t k)
+				{ return removedPositions[k] - k <= static_cast<size_t>(index); }) - tombstones.begin();
+			return elements[index + tombstonesBefore];
+		}
 
 		throw Exception(ErrorCode::SIM_ELEM_INDEX, index);
 	}
@@ -198,18 +843,29 @@ namespace dnf_composer
 
 	int Simulation::getNumberOfElements() const
 	{
-		return static_cast<int>(elements.size());
+		return static_cast<int>(elements.size() - removedPositions.size());
 	}
 
 	std::vector<std::shared_ptr<element::Element>> Simulation::getElementsThatHaveSpecifiedElementAsInput(const std::string& specifiedElement, const std::string& inputComponent) const
 	{
 		std::vector<std::shared_ptr<element::Element>> elementsThatHaveSpecifiedElementAsInput;
-		for (const auto& element : elements) 
+		const ElementSlot* specifiedSlot = findElementSlot(specifiedElement);
+		if (!specifiedSlot)
+			return elementsThatHaveSpecifiedElementAsInput;
+
+		std::vector<const ElementSlot*> consumerSlots;
+		for (element::Element* consumer : specifiedSlot->element->getConsumers())
 		{
-			if (element->hasInput(specifiedElement, inputComponent)) {
-				elementsThatHaveSpecifiedElementAsInput.push_back(element);
-			}
+			const ElementSlot* consumerSlot = findElementSlot(consumer->getUniqueName());
+			if (consumerSlot && consumerSlot->element.get() == consumer && consumer->hasInput(specifiedElement, inputComponent))
+				consumerSlots.push_back(consumerSlot);
 		}
+
+		// report consumers in step order, as the previous full scan did
+		std::ranges::sort(consumerSlots, {}, &ElementSlot::position);
+		elementsThatHaveSpecifiedElementAsInput.reserve(consumerSlots.size());
+		for (const ElementSlot* consumerSlot : consumerSlots)
+			elementsThatHaveSpecifiedElementAsInput.push_back(consumerSlot->element);
 		return elementsThatHaveSpecifiedElementAsInput;
 	}
 
@@ -244,5 +900,152 @@ namespace dnf_composer
 
 	}
 
+	const Simulation::ElementSlot* Simulation::findElementSlot(const std::string& id) const
+	{
+		const auto handle = elementHandles.find(id);
+		if (handle == elementHandles.end())
+			return nullptr;
+		return &elementSlots[handle->second.slot];
+	}
+
+	ElementHandle Simulation::insertElement(const std::shared_ptr<element::Element>& element)
+	{
+		ElementHandle handle;
+		if (freeElementSlots.empty())
+		{
+			handle.slot = static_cast<uint32_t>(elementSlots.size());
+			elementSlots.emplace_back();
+		}
+		else
+		{
+			handle.slot = freeElementSlots.back();
+			freeElementSlots.pop_back();
+		}
+
+		ElementSlot& slot = elementSlots[handle.slot];
+		slot.element = element;
+		slot.position = elements.size();
+		handle.generation = slot.generation;
+		element->setArchitectureRevisions(architectureRevisions);
+
+		elements.push_back(element);
+		elementHandles[element->getUniqueName()] = handle;
+		return handle;
+	}
+
+	void Simulation::releaseElementSlot(ElementHandle handle)
+	{
+		// taken by value: callers may pass the handle stored in elementHandles, which the erase below destroys
+		ElementSlot& slot = elementSlots[handle.slot];
+		elementHandles.erase(slot.element->getUniqueName());
+		slot.element->setArchitectureRevisions(nullptr);
+		slot.element = nullptr;
+		slot.generation++;
+		freeElementSlots.push_back(handle.slot);
+	}
+
+	void Simulation::compactElements()
+	{
+		if (removedPositions.empty())
+			return;
+
+		std::erase(elements, nullptr);
+		for (size_t position = 0; position < elements.size(); position++)
+			elementSlots[elementHandles.at(elements[position]->getUniqueName()).slot].position = position;
+		removedPositions.clear();
+		kernelBatchesOutdated = true;
+	}
+
+	bool Simulation::areKernelBatchesCurrent() const
+	{
+		// connections made and kernels re-initialized directly on elements bypass the simulation
+		return architectureRevisions->structure.load(std::memory_order_relaxed) == plannedRevisions.structure;
+	}
+
+	void Simulation::updateKernelBatches()
+	{
+		if (kernelBatchesOutdated || !areKernelBatchesCurrent())
+		{
+			buildKernelBatches();
+			return;
+		}
+
+		// only gains changed since the build, the resolved inputs of a compiled plan carry them
+		const uint64_t gains = architectureRevisions->gains.load(std::memory_order_relaxed);
+		if (gains == plannedRevisions.gains)
+			return;
+		plannedRevisions.gains = gains;
+		if (executionPlan)
+			executionPlan->updateGains();
+	}
+
+	void Simulation::buildKernelBatches()
+	{
+		// taken first, so edits made while building are noticed by the next step
+		plannedRevisions = { architectureRevisions->structure.load(std::memory_order_relaxed), architectureRevisions->gains.load(std::memory_order_relaxed) };
+		kernelBatches.clear();
+		batchOfElement.assign(elements.size(), -1);
+
+		std::unordered_map<const element::Element*, size_t> positions;
+		positions.reserve(elements.size());
+		for (size_t position = 0; position < elements.size(); position++)
+			positions[elements[position].get()] = position;
+
+		// A kernel joins the batch of the previous kernel with the same data only if moving its step forward to the
+		// position of that batch changes nothing: none of its inputs or consumers may be stepped in between.
+		std::vector<std::vector<size_t>> candidates;
+		std::unordered_map<const element::KernelData*, size_t> openCandidate;
+		for (size_t position = 0; position < elements.size(); position++)
+		{
+			const auto kernel = std::dynamic_pointer_cast<element::Kernel>(elements[position]);
+			if (!kernelBatching || !kernel || !kernel->isBatchable())
+				continue;
+
+			const auto isSteppedSince = [&](size_t first, const element::Element* element)
+				{
+					const auto found = positions.find(element);
+					return found != positions.end() && found->second >= first && found->second < position;
+				};
+
+			const auto open = openCandidate.find(kernel->getKernelDataPtr());
+			bool joins = open != openCandidate.end();
+			if (joins)
+			{
+				const size_t first = candidates[open->second].front();
+				for (const auto& input : kernel->getInputs())
+					joins = joins && !isSteppedSince(first, input.get());
+				for (const element::Element* consumer : kernel->getConsumers())
+					joins = joins && !isSteppedSince(first, consumer);
+			}
+
+			if (joins)
+				candidates[open->second].push_back(position);
+			else
+			{
+				openCandidate[kernel->getKernelDataPtr()] = candidates.size();
+				candidates.push_back({ position });
+			}
+		}
+
+		for (const auto& candidate : candidates)
+		{
+			if (candidate.size() < 2)
+				continue;
+			element::KernelBatch batch;
+			batch.data = std::static_pointer_cast<element::Kernel>(elements[candidate.front()])->getKernelData();
+			for (const size_t position : candidate)
+			{
+				batch.kernels.push_back(static_cast<element::Kernel*>(elements[position].get()));
+				batchOfElement[position] = static_cast<int>(kernelBatches.size());
+			}
+			kernelBatches.push_back(std::move(batch));
+		}
+		kernelBatchesOutdated = false;
+
+		if (compiled)
+			executionPlan = std::make_unique<ExecutionPlan>(elements, kernelBatches, batchOfElement);
+		else
+			executionPlan.reset();
+	}
 }
 
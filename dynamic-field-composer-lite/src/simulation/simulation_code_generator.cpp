@@ -0,0 +1,365 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+#include "simulation/simulation_code_generator.h"
+
+#include <fstream>
+#include <sstream>
+#include <typeinfo>
+
+#include "elements/neural_field.h"
+#include "elements/gauss_kernel.h"
+#include "elements/mexican_hat_kernel.h"
+#include "elements/gauss_stimulus.h"
+#include "elements/normal_noise.h"
+
+namespace dnf_composer
+{
+	namespace
+	{
+		// Exact, and parenthesized when negative so it can be placed after any operator.
+		std::string literal(double value)
+		{
+			std::ostringstream stream;
+			stream << std::hexfloat << value;
+			return value < 0.0 ? "(" + stream.str() + ")" : stream.str();
+		}
+
+		std::string quoted(const std::string& text)
+		{
+			std::string result = "\"";
+			for (const char character : text)
+			{
+				if (character == '"' || character == '\\')
+					result += '\\';
+				result += character;
+			}
+			return result + "\"";
+		}
+
+		bool isUniform(const std::vector<double>& values)
+		{
+			return std::ranges::all_of(values, [&values](double value) { return value == values.front(); });
+		}
+
+		std::string arrayType(size_t size)
+		{
+			return "std::array<double, " + std::to_string(size) + ">";
+		}
+
+		std::string arrayInitializer(const std::vector<double>& values)
+		{
+			std::ostringstream stream;
+			stream << "{";
+			for (size_t i = 0; i < values.size(); i++)
+			{
+				stream << (i % 6 == 0 ? "\n\t\t\t" : " ") << literal(values[i]);
+				if (i + 1 < values.size())
+					stream << ",";
+			}
+			stream << "\n\t\t}";
+			return stream.str();
+		}
+
+		std::string prefix(size_t index)
+		{
+			return "e" + std::to_string(index) + "_";
+		}
+
+		// Components another element can take as input, by element kind.
+		std::vector<std::string> readableComponents(const element::Element& element)
+		{
+			if (typeid(element) == typeid(element::NeuralField))
+				return { "activation", "input", "output" };
+			if (typeid(element) == typeid(element::GaussKernel) || typeid(element) == typeid(element::MexicanHatKernel))
+				return { "input", "output" };
+			return { "output" };
+		}
+	}
+
+	SimulationCodeGenerator::SimulationCodeGenerator(const std::shared_ptr<Simulation>& simulation, SimulationCodeGeneratorParameters parameters)
+		: simulation(simulation), parameters(std::move(parameters))
+	{
+		if (!simulation)
+			throw Exception(ErrorCode::SIM_INVALID_PARAMETER, "SimulationCodeGenerator requires a simulation");
+	}
+
+	bool SimulationCodeGenerator::generate(const std::string& filePath) const
+	{
+		std::ostringstream code;
+		if (!generate(code))
+			return false;
+
+		std::ofstream file(filePath, std::ios::trunc);
+		if (!file.is_open())
+		{
+			log(LogLevel::ERROR, "Failed to open '" + filePath + "' for the generated code.\n");
+			return false;
+		}
+		file << code.str();
+		return file.good();
+	}
+
+	bool SimulationCodeGenerator::generate(std::ostream& stream) const
+	{
+		const int numberOfElements = simulation->getNumberOfElements();
+		std::vector<std::shared_ptr<element::Element>> elements;
+		std::unordered_map<const element::Element*, size_t> positions;
+		for (int i = 0; i < numberOfElements; i++)
+		{
+			elements.push_back(simulation->getElement(i));
+			positions[elements.back().get()] = static_cast<size_t>(i);
+		}
+
+		for (const auto& element : elements)
+		{
+			if (!isSupported(element))
+				return false;
+			for (const auto& [source, component, gain, delay] : element->getInputConnections())
+			{
+				const std::vector<std::string> readable = readableComponents(*source);
+				if (!positions.contains(source.get()) || std::ranges::find(readable, component) == readable.end()
+					|| source->getSize() != element->getSize())
+				{
+					log(LogLevel::ERROR, "Input '" + source->getUniqueName() + "' (" + component + ") of '" + element->getUniqueName() +
+						"' cannot be generated, it must be an element of the simulation with a matching size.\n");
+					return false;
+				}
+				if (delay > 0)
+				{
+					log(LogLevel::ERROR, "Input '" + source->getUniqueName() + "' of '" + element->getUniqueName() + "' is delayed, delays cannot be generated.\n");
+					return false;
+				}
+			}
+		}
+
+		bool usesNoise = false;
+		for (const auto& element : elements)
+			usesNoise = usesNoise || typeid(*element) == typeid(element::NormalNoise);
+
+		stream << "// Generated by dnf_composer::SimulationCodeGenerator, do not edit.\n"
+			<< "// " << numberOfElements << " elements, the initial state is the state of the simulation at generation time.\n"
+			<< "#pragma once\n\n"
+			<< "#include <array>\n#include <cmath>\n#include <cstddef>\n#include <span>\n#include <string_view>\n";
+		if (usesNoise)
+			stream << "#include <random>\n#include <sstream>\n";
+		stream << "\nnamespace " << parameters.namespaceName << "\n{\n"
+			<< "\tclass " << parameters.className << "\n\t{\n\tpublic:\n"
+			<< "\t\tstatic constexpr double deltaT = " << literal(simulation->deltaT) << ";\n\n";
+
+		std::ostringstream reset, step, read, centroid;
+		for (size_t index = 0; index < elements.size(); index++)
+		{
+			const auto& element = elements[index];
+			const std::string name = quoted(element->getUniqueName());
+			const std::string p = prefix(index);
+			step << "\t\t\t" << p << "step();\n";
+
+			read << "\t\t\tif (element == " << name << ")\n\t\t\t{\n";
+			for (const std::string& component : readableComponents(*element))
+				read << "\t\t\t\tif (component == " << quoted(component) << ")\n\t\t\t\t\treturn " << p << component << ";\n";
+			read << "\t\t\t}\n";
+
+			if (typeid(*element) == typeid(element::NeuralField))
+				centroid << "\t\t\tif (field == " << name << ")\n\t\t\t\treturn " << p << "centroid;\n";
+
+			if (typeid(*element) == typeid(element::GaussStimulus))
+				continue;
+
+			// state components start from their current values
+			for (const std::string& component : readableComponents(*element))
+			{
+				const std::vector<double> values = element->getComponent(component);
+				if (isUniform(values))
+					reset << "\t\t\t" << p << component << ".fill(" << literal(values.front()) << ");\n";
+				else
+					reset << "\t\t\t" << p << component << " = " << p << component << "Initial;\n";
+			}
+			if (const auto field = std::dynamic_pointer_cast<element::NeuralField>(element))
+				reset << "\t\t\t" << p << "centroid = " << literal(field->getCentroid()) << ";\n";
+			if (typeid(*element) == typeid(element::NormalNoise))
+				reset << "\t\t\t{\n\t\t\t\tstd::istringstream state(" << p << "generatorState);\n\t\t\t\tstate >> " << p << "generator;\n\t\t\t}\n";
+		}
+
+		stream << "\t\t" << parameters.className << "()\n\t\t{\n\t\t\treset();\n\t\t}\n\n"
+			<< "\t\t// Back to the state of the simulation at generation time.\n"
+			<< "\t\tvoid reset()\n\t\t{\n\t\t\tt = " << literal(simulation->t) << ";\n" << reset.str() << "\t\t}\n\n"
+			<< "\t\tvoid step()\n\t\t{\n\t\t\tt += deltaT;\n" << step.str() << "\t\t}\n\n"
+			<< "\t\tdouble time() const\n\t\t{\n\t\t\treturn t;\n\t\t}\n\n"
+			<< "\t\t// Component of an element by its name in the simulation, empty if it was not generated.\n"
+			<< "\t\tstd::span<const double> read(std::string_view element, std::string_view component) const\n\t\t{\n"
+			<< read.str() << "\t\t\treturn {};\n\t\t}\n\n"
+			<< "\t\tdouble centroid(std::string_view field) const\n\t\t{\n" << centroid.str() << "\t\t\treturn -1.0;\n\t\t}\n\n"
+			<< "\tprivate:\n\t\tdouble t = 0.0;\n";
+
+		for (size_t index = 0; index < elements.size(); index++)
+			stream << generateElement(index, elements[index], positions);
+
+		stream << "\t};\n}\n";
+		return stream.good();
+	}
+
+	bool SimulationCodeGenerator::isSupported(const std::shared_ptr<element::Element>& element) const
+	{
+		std::string reason;
+		if (const auto field = std::dynamic_pointer_cast<element::NeuralField>(element); field && typeid(*element) == typeid(element::NeuralField))
+		{
+			const element::NeuralFieldParameters fieldParameters = field->getParameters();
+			const element::ActivationFunction* activationFunction = fieldParameters.activationFunction.get();
+			if (!dynamic_cast<const element::SigmoidFunction*>(activationFunction) && !dynamic_cast<const element::HeavisideFunction*>(activationFunction))
+				reason = "only sigmoid and heaviside activation functions can be generated";
+		}
+		else if (typeid(*element) == typeid(element::GaussKernel) || typeid(*element) == typeid(element::MexicanHatKernel))
+		{
+			if (!std::static_pointer_cast<element::Kernel>(element)->isBatchable())
+				reason = "only kernels with direct convolution can be generated";
+		}
+		else if (typeid(*element) != typeid(element::GaussStimulus) && typeid(*element) != typeid(element::NormalNoise))
+			reason = "its kind of element is not supported by the code generator";
+
+		if (reason.empty())
+			return true;
+		log(LogLevel::ERROR, "Element '" + element->getUniqueName() + "' cannot be generated, " + reason + ".\n");
+		return false;
+	}
+
+	std::string SimulationCodeGenerator::generateElement(size_t index, const std::shared_ptr<element::Element>& element,
+		const std::unordered_map<const element::Element*, size_t>& positions) const
+	{
+		const std::string p = prefix(index);
+		const size_t size = static_cast<size_t>(element->getSize());
+		const std::string sizeText = std::to_string(size);
+		std::ostringstream code;
+
+		std::ostringstream inputSum;
+		inputSum << "\t\t\t\tdouble inputSum = 0.0;\n";
+		// in connection order, as the interpreted step sums them; a gain of 1 multiplies nothing
+		for (const auto& [source, component, gain, delay] : element->getInputConnections())
+		{
+			inputSum << "\t\t\t\tinputSum += ";
+			if (gain != 1.0)
+				inputSum << literal(gain) << " * ";
+			inputSum << prefix(positions.at(source.get())) << component << "[i];\n";
+		}
+		inputSum << "\t\t\t\t" << p << "input[i] = inputSum;\n";
+
+		const auto declareState = [&](const std::string& component)
+			{
+				code << "\t\t" << arrayType(size) << " " << p << component << "{};\n";
+				const std::vector<double> values = element->getComponent(component);
+				if (!isUniform(values))
+					code << "\t\tstatic constexpr " << arrayType(size) << " " << p << component << "Initial = " << arrayInitializer(values) << ";\n";
+			};
+
+		code << "\n\t\t// " << element::ElementLabelToString.at(element->getLabel()) << " '" << element->getUniqueName() << "'\n";
+
+		if (const auto field = std::dynamic_pointer_cast<element::NeuralField>(element); field && typeid(*element) == typeid(element::NeuralField))
+		{
+			const element::NeuralFieldParameters fieldParameters = field->getParameters();
+			declareState("activation");
+			declareState("input");
+			declareState("output");
+			code << "\t\tdouble " << p << "centroid = -1.0;\n";
+
+			const std::vector<double> restingLevel = element->getComponent("resting level");
+			std::string restingLevelText = literal(restingLevel.front());
+			if (!isUniform(restingLevel))
+			{
+				code << "\t\tstatic constexpr " << arrayType(size) << " " << p << "restingLevel = " << arrayInitializer(restingLevel) << ";\n";
+				restingLevelText = p + "restingLevel[i]";
+			}
+
+			std::string activationText;
+			if (const auto* sigmoid = dynamic_cast<const element::SigmoidFunction*>(fieldParameters.activationFunction.get()))
+				activationText = "1 / (1 + std::exp(-" + literal(sigmoid->getSteepness()) + " * (u - " + literal(sigmoid->getXShift()) + ")))";
+			else
+				activationText = "u > " + literal(static_cast<const element::HeavisideFunction*>(fieldParameters.activationFunction.get())->getXShift()) + " ? 1.0 : 0.0";
+
+			const std::string threshold = "0.1";
+			const std::string fieldSize = literal(static_cast<double>(size));
+			code << "\n\t\tvoid " << p << "step()\n\t\t{\n"
+				<< "\t\t\tdouble count = 0.0, lowerCount = 0.0, lowerDistances = 0.0, upperDistances = 0.0;\n"
+				<< "\t\t\tfor (std::size_t i = 0; i < " << sizeText << "; i++)\n\t\t\t{\n"
+				<< inputSum.str()
+				<< "\t\t\t\tconst double change = deltaT / " << literal(fieldParameters.tau) << " * (-" << p << "activation[i] + " << restingLevelText << " + inputSum);\n"
+				<< "\t\t\t\tconst double u = " << p << "activation[i] + change;\n"
+				<< "\t\t\t\t" << p << "activation[i] = u;\n"
+				<< "\t\t\t\t" << p << "output[i] = " << activationText << ";\n"
+				<< "\t\t\t\tif (u > " << threshold << ")\n\t\t\t\t{\n"
+				<< "\t\t\t\t\tconst double distance = static_cast<double>(i) - " << literal(static_cast<double>(size) * 0.5) << ";\n"
+				<< "\t\t\t\t\tcount += 1.0;\n"
+				<< "\t\t\t\t\tif (distance < 0.0)\n\t\t\t\t\t{\n\t\t\t\t\t\tlowerCount += 1.0;\n\t\t\t\t\t\tlowerDistances += distance;\n\t\t\t\t\t}\n"
+				<< "\t\t\t\t\telse\n\t\t\t\t\t\tupperDistances += distance;\n\t\t\t\t}\n\t\t\t}\n\n"
+				<< "\t\t\tif (count == 0.0)\n\t\t\t{\n\t\t\t\t" << p << "centroid = -1.0;\n\t\t\t\treturn;\n\t\t\t}\n"
+				<< "\t\t\tconst bool atLimits = " << p << "activation[0] > " << threshold << " || " << p << "activation[" << size - 1 << "] > " << threshold << ";\n"
+				<< "\t\t\tdouble sumWeightedPositions = lowerDistances + upperDistances;\n"
+				<< "\t\t\tif (atLimits)\n\t\t\t\tsumWeightedPositions += " << fieldSize << " * lowerCount;\n"
+				<< "\t\t\t" << p << "centroid = std::fmod(" << fieldSize << " * 0.5 + sumWeightedPositions / count, " << fieldSize << ");\n"
+				<< "\t\t\tif (atLimits)\n\t\t\t\t" << p << "centroid = (" << p << "centroid >= 0 ? " << p << "centroid : " << p << "centroid + " << fieldSize << ");\n"
+				<< "\t\t}\n";
+		}
+		else if (const auto kernel = std::dynamic_pointer_cast<element::Kernel>(element))
+		{
+			const auto data = kernel->getKernelData();
+			const size_t numberOfWeights = data->weights.size();
+			const std::string weightsText = std::to_string(numberOfWeights);
+			declareState("input");
+			declareState("output");
+			code << "\t\tstatic constexpr " << arrayType(numberOfWeights) << " " << p << "weights = " << arrayInitializer(data->weights) << ";\n";
+			if (!data->borderScale.empty())
+				code << "\t\tstatic constexpr " << arrayType(size) << " " << p << "borderScale = " << arrayInitializer(data->borderScale) << ";\n";
+
+			std::string outputText;
+			if (const auto gaussKernel = std::dynamic_pointer_cast<element::GaussKernel>(element))
+				outputText = "sum + " + literal(gaussKernel->getParameters().amplitudeGlobal) + " * fullSum";
+			else
+				outputText = "(sum + " + literal(std::static_pointer_cast<element::MexicanHatKernel>(element)->getParameters().amplitudeGlobal) + ") * " + literal(element->getStepSize());
+
+			code << "\n\t\tvoid " << p << "step()\n\t\t{\n"
+				<< "\t\t\tdouble fullSum = 0.0;\n"
+				<< "\t\t\tfor (std::size_t i = 0; i < " << sizeText << "; i++)\n\t\t\t{\n"
+				<< inputSum.str()
+				<< "\t\t\t\tfullSum += inputSum;\n\t\t\t}\n\n"
+				<< "\t\t\tconstexpr int size = " << sizeText << ", numberOfWeights = " << weightsText << ";\n"
+				<< "\t\t\tfor (int i = 0; i < size; i++)\n\t\t\t{\n"
+				<< "\t\t\t\tconst int first = i - " << data->kernelRange[1] << ";\n"
+				<< "\t\t\t\tdouble sum = 0.0;\n"
+				<< "\t\t\t\tif (first >= 0 && first + numberOfWeights <= size)\n\t\t\t\t{\n"
+				<< "\t\t\t\t\tfor (int k = 0; k < numberOfWeights; k++)\n"
+				<< "\t\t\t\t\t\tsum += " << p << "weights[numberOfWeights - 1 - k] * " << p << "input[first + k];\n\t\t\t\t}\n";
+			if (kernel->getCircular())
+				code << "\t\t\t\telse\n\t\t\t\t{\n"
+					<< "\t\t\t\t\tint index = (first % size + size) % size;\n"
+					<< "\t\t\t\t\tfor (int k = 0; k < numberOfWeights; k++)\n\t\t\t\t\t{\n"
+					<< "\t\t\t\t\t\tsum += " << p << "weights[numberOfWeights - 1 - k] * " << p << "input[index];\n"
+					<< "\t\t\t\t\t\tif (++index == size)\n\t\t\t\t\t\t\tindex = 0;\n\t\t\t\t\t}\n\t\t\t\t}\n";
+			else
+				code << "\t\t\t\telse\n\t\t\t\t{\n"
+					<< "\t\t\t\t\tconst int end = first + numberOfWeights < size ? numberOfWeights : size - first;\n"
+					<< "\t\t\t\t\tfor (int k = first < 0 ? -first : 0; k < end; k++)\n"
+					<< "\t\t\t\t\t\tsum += " << p << "weights[numberOfWeights - 1 - k] * " << p << "input[first + k];\n\t\t\t\t}\n";
+			if (!data->borderScale.empty())
+				code << "\t\t\t\tsum *= " << p << "borderScale[i];\n";
+			code << "\t\t\t\t" << p << "output[i] = " << outputText << ";\n\t\t\t}\n\t\t}\n";
+		}
+		else if (typeid(*element) == typeid(element::GaussStimulus))
+		{
+			code << "\t\tstatic constexpr " << arrayType(size) << " " << p << "output = " << arrayInitializer(element->getComponent("output")) << ";\n"
+				<< "\n\t\tvoid " << p << "step()\n\t\t{\n\t\t}\n";
+		}
+		else
+		{
+			const auto noise = std::static_pointer_cast<element::NormalNoise>(element);
+			declareState("output");
+			code << "\t\tstd::mt19937 " << p << "generator;\n"
+				<< "\t\tstatic constexpr const char* " << p << "generatorState = " << quoted(noise->getGeneratorState()) << ";\n"
+				<< "\n\t\tvoid " << p << "step()\n\t\t{\n"
+				<< "\t\t\tstd::normal_distribution<> distribution(0, 1);\n"
+				<< "\t\t\tfor (std::size_t i = 0; i < " << sizeText << "; i++)\n"
+				<< "\t\t\t\t" << p << "output[i] = " << literal(noise->getParameters().amplitude) << " / std::sqrt(deltaT) * distribution(" << p << "generator);\n"
+				<< "\t\t}\n";
+		}
+		return code.str();
+	}
+}
@@ -0,0 +1,279 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+#include "simulation/steady_state_solver.h"
+
+#include <deque>
+
+#include "elements/normal_noise.h"
+
+namespace dnf_composer
+{
+	namespace
+	{
+		// Solves the small regularized normal equations (A^T A + lambda I) gamma = A^T b of the Anderson step.
+		std::vector<double> solveLeastSquares(const std::deque<std::vector<double>>& columns, const std::vector<double>& b)
+		{
+			const size_t m = columns.size();
+			std::vector<std::vector<double>> system(m, std::vector<double>(m + 1, 0.0));
+			double trace = 0.0;
+			for (size_t i = 0; i < m; i++)
+			{
+				for (size_t j = i; j < m; j++)
+				{
+					double dot = 0.0;
+					for (size_t k = 0; k < b.size(); k++)
+						dot += columns[i][k] * columns[j][k];
+					system[i][j] = system[j][i] = dot;
+				}
+				for (size_t k = 0; k < b.size(); k++)
+					system[i][m] += columns[i][k] * b[k];
+				trace += system[i][i];
+			}
+			const double lambda = 1e-10 * (trace > 0.0 ? trace : 1.0);
+			for (size_t i = 0; i < m; i++)
+				system[i][i] += lambda;
+
+			// gaussian elimination with partial pivoting
+			for (size_t col = 0; col < m; col++)
+			{
+				size_t pivot = col;
+				for (size_t row = col + 1; row < m; row++)
+					if (std::fabs(system[row][col]) > std::fabs(system[pivot][col]))
+						pivot = row;
+				std::swap(system[col], system[pivot]);
+				if (std::fabs(system[col][col]) < 1e-300)
+					return std::vector<double>(m, 0.0);
+				for (size_t row = col + 1; row < m; row++)
+				{
+					const double factor = system[row][col] / system[col][col];
+					for (size_t k = col; k <= m; k++)
+						system[row][k] -= factor * system[col][k];
+				}
+			}
+			std::vector<double> gamma(m, 0.0);
+			for (size_t i = m; i-- > 0;)
+			{
+				double sum = system[i][m];
+				for (size_t k = i + 1; k < m; k++)
+					sum -= system[i][k] * gamma[k];
+				gamma[i] = sum / system[i][i];
+			}
+			return gamma;
+		}
+
+		bool areValid(const SteadyStateSolverParameters& parameters)
+		{
+			return parameters.tolerance > 0 && parameters.maxIterations > 0 && parameters.damping > 0 && parameters.damping <= 1 && parameters.andersonDepth >= 0;
+		}
+
+		// Elements whose step only maps their inputs to their output, so evaluating them any number of times is safe.
+		bool isStatelessOperator(element::ElementLabel label)
+		{
+			switch (label)
+			{
+			case element::ElementLabel::GAUSS_KERNEL:
+			case element::ElementLabel::MEXICAN_HAT_KERNEL:
+			case element::ElementLabel::GAUSS_STIMULUS:
+			case element::ElementLabel::FIELD_COUPLING:
+			case element::ElementLabel::GAUSS_FIELD_COUPLING:
+				return true;
+			default:
+				return false;
+			}
+		}
+
+		double maxAbs(const std::vector<double>& values)
+		{
+			double result = 0.0;
+			for (const double value : values)
+				result = std::max(result, std::fabs(value));
+			return result;
+		}
+	}
+
+	SteadyStateSolver::SteadyStateSolver(const std::shared_ptr<Simulation>& simulation, const SteadyStateSolverParameters& parameters)
+		: simulation(simulation), parameters(parameters), stateSize(0)
+	{
+		if (!simulation)
+			throw Exception(ErrorCode::SIM_INVALID_PARAMETER, "SteadyStateSolver requires a simulation");
+		if (!areValid(parameters))
+			throw Exception(ErrorCode::SIM_INVALID_PARAMETER, "Invalid parameters for SteadyStateSolver constructor");
+	}
+
+	void SteadyStateSolver::setParameters(const SteadyStateSolverParameters& parameters)
+	{
+		if (!areValid(parameters))
+		{
+			log(LogLevel::ERROR, "Invalid parameters for SteadyStateSolver, its parameters were not changed.\n");
+			return;
+		}
+		this->parameters = parameters;
+	}
+
+	SteadyStateSolverParameters SteadyStateSolver::getParameters() const
+	{
+		return parameters;
+	}
+
+	SteadyStateResult SteadyStateSolver::solve()
+	{
+		SteadyStateResult result;
+		collectElements();
+		if (fields.empty())
+		{
+			log(LogLevel::WARNING, "Simulation has no neural fields, there is no steady state to solve for.\n");
+			result.converged = true;
+			return result;
+		}
+
+		const double beta = parameters.damping;
+		std::vector<double> state = getState();
+		std::vector<double> previousResidual, previousTarget;
+		std::deque<std::vector<double>> residualDifferences, stepDifferences;
+		double bestResidual = std::numeric_limits<double>::infinity();
+
+		for (int iteration = 1; iteration <= parameters.maxIterations; iteration++)
+		{
+			const std::vector<double> target = evaluate(state);
+			std::vector<double> residual(stateSize);
+			for (size_t i = 0; i < stateSize; i++)
+				residual[i] = target[i] - state[i];
+
+			result.iterations = iteration;
+			result.residual = maxAbs(residual);
+			if (!std::isfinite(result.residual))
+				break;
+			if (result.residual <= parameters.tolerance)
+			{
+				result.converged = true;
+				return result;
+			}
+
+			// restart the acceleration when it drives the iteration away from the best iterate so far
+			if (result.residual > 10 * bestResidual)
+			{
+				residualDifferences.clear();
+				stepDifferences.clear();
+			}
+			else if (!previousResidual.empty() && parameters.andersonDepth > 0)
+			{
+				std::vector<double> residualDifference(stateSize), stepDifference(stateSize);
+				for (size_t i = 0; i < stateSize; i++)
+				{
+					residualDifference[i] = residual[i] - previousResidual[i];
+					// difference of the state update x + beta * f between the last two iterates
+					stepDifference[i] = (target[i] - previousTarget[i]) - (1.0 - beta) * residualDifference[i];
+				}
+				residualDifferences.push_back(std::move(residualDifference));
+				stepDifferences.push_back(std::move(stepDifference));
+				if (static_cast<int>(residualDifferences.size()) > parameters.andersonDepth)
+				{
+					residualDifferences.pop_front();
+					stepDifferences.pop_front();
+				}
+			}
+			bestResidual = std::min(bestResidual, result.residual);
+
+			std::vector<double> nextState(stateSize);
+			for (size_t i = 0; i < stateSize; i++)
+				nextState[i] = state[i] + beta * residual[i];
+			if (!residualDifferences.empty())
+			{
+				const std::vector<double> gamma = solveLeastSquares(residualDifferences, residual);
+				for (size_t j = 0; j < gamma.size(); j++)
+					for (size_t i = 0; i < stateSize; i++)
+						nextState[i] -= gamma[j] * stepDifferences[j][i];
+			}
+
+			previousResidual = std::move(residual);
+			previousTarget = target;
+			state = std::move(nextState);
+		}
+
+		// leave the fields at the last iterate
+		size_t offset = 0;
+		for (const auto& field : fields)
+		{
+			const auto size = static_cast<size_t>(field->getSize());
+			field->setActivation({ state.begin() + offset, state.begin() + offset + size });
+			field->resetDelayLines();
+			offset += size;
+		}
+
+		const std::string logMessage = "Steady state solver did not converge within " + std::to_string(result.iterations) +
+			" iterations (residual " + std::to_string(result.residual) + ").\n";
+		log(LogLevel::WARNING, logMessage);
+		return result;
+	}
+
+	void SteadyStateSolver::collectElements()
+	{
+		fields.clear();
+		operators.clear();
+		stateSize = 0;
+		for (int i = 0; i < simulation->getNumberOfElements(); i++)
+		{
+			const auto element = simulation->getElement(i);
+			if (const auto field = std::dynamic_pointer_cast<element::NeuralField>(element))
+			{
+				fields.push_back(field);
+				stateSize += static_cast<size_t>(field->getSize());
+			}
+			else if (std::dynamic_pointer_cast<element::NormalNoise>(element))
+			{
+				// the steady state is solved for the noise-free equations
+				std::ranges::fill(*element->getComponentPtr("output"), 0.0);
+				element->resetDelayLines();
+			}
+			else if (isStatelessOperator(element->getLabel()))
+				operators.push_back(element);
+			// other elements would advance their state once per iteration, they enter with their current output
+		}
+	}
+
+	std::vector<double> SteadyStateSolver::getState() const
+	{
+		std::vector<double> state;
+		state.reserve(stateSize);
+		for (const auto& field : fields)
+		{
+			const std::vector<double>* activation = field->getComponentPtr("activation");
+			state.insert(state.end(), activation->begin(), activation->end());
+		}
+		return state;
+	}
+
+	std::vector<double> SteadyStateSolver::evaluate(const std::vector<double>& state) const
+	{
+		size_t offset = 0;
+		for (const auto& field : fields)
+		{
+			const auto size = static_cast<size_t>(field->getSize());
+			field->setActivation({ state.begin() + offset, state.begin() + offset + size });
+			// a fixed point is constant in time, so delayed connections read the current values
+			field->resetDelayLines();
+			offset += size;
+		}
+
+		// kernels, couplings and stimuli act as operators on the field outputs, time does not advance
+		for (const auto& element : operators)
+		{
+			element->step(simulation->t, simulation->deltaT);
+			element->resetDelayLines();
+		}
+
+		std::vector<double> target;
+		target.reserve(stateSize);
+		for (const auto& field : fields)
+		{
+			field->updateInput();
+			const std::vector<double>* restingLevel = field->getComponentPtr("resting level");
+			const std::vector<double>* input = field->getComponentPtr("input");
+			for (size_t i = 0; i < restingLevel->size(); i++)
+				target.push_back((*restingLevel)[i] + (*input)[i]);
+		}
+		return target;
+	}
+}
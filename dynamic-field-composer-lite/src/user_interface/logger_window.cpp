@@ -29,6 +29,7 @@ namespace dnf_composer
 
 		void LoggerWindow::clean()
 		{
+			const std::lock_guard<std::mutex> lock(bufferMutex);
 			buffer.clear();
 			lineOffsets.clear();
             lineOffsets.push_back(0);
@@ -65,6 +66,7 @@ namespace dnf_composer
 
         void LoggerWindow::drawLog()
 		{
+            const std::lock_guard<std::mutex> lock(bufferMutex);
 
             const char* buf = buffer.begin();
             const char* buf_end = buffer.end();
@@ -174,6 +176,7 @@ namespace dnf_composer
 
         void LoggerWindow::addLog(const char* message, ...)
         {
+            const std::lock_guard<std::mutex> lock(bufferMutex);
             int old_size = buffer.size();
             va_list args;
             va_start(args, message);
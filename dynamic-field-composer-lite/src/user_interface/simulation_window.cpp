@@ -89,10 +89,7 @@ namespace dnf_composer
 						}
 
 						if (ImGui::Button("Add", { 100.0f, 30.0f }))
-						{
-							auto input = simulation->getElement(selectedElementId);
-							simulationElement->addInput(input);
-						}
+							simulation->createInteraction(selectedElementId, "output", targetElementId);
 						ImGui::TreePop();
 					}
 				}
@@ -150,6 +147,15 @@ namespace dnf_composer
 				case element::ElementLabel::GAUSS_FIELD_COUPLING:
 					addElementGaussFieldCoupling();
 					break;
+				case element::ElementLabel::MEMORY_TRACE:
+					addElementMemoryTrace();
+					break;
+				case element::ElementLabel::MOVING_GAUSS_STIMULUS:
+					addElementMovingGaussStimulus();
+					break;
+				case element::ElementLabel::EXTERNAL_INPUT:
+					addElementExternalInput();
+					break;
 				default:
 					log(LogLevel::ERROR, "There is a missing element in the TreeNode in simulation window.\n");
 					break;
@@ -288,6 +294,83 @@ namespace dnf_composer
 			}
 		}
 
+		void SimulationWindow::addElementMemoryTrace() const
+		{
+			static char id[CHAR_SIZE] = "memory trace a";
+			ImGui::InputTextWithHint("id", "enter text here", id, IM_ARRAYSIZE(id));
+			static int x_max = 100;
+			ImGui::InputInt("x_max", &x_max, 1.0, 10.0);
+			static double d_x = 0.1;
+			ImGui::InputDouble("d_x", &d_x, 0.1, 0.5, "%.2f");
+			static double tauBuild = 100;
+			ImGui::InputDouble("tau build", &tauBuild, 10.0f, 100.0f, "%.2f");
+			static double tauDecay = 1000;
+			ImGui::InputDouble("tau decay", &tauDecay, 10.0f, 100.0f, "%.2f");
+			static double threshold = 0.5;
+			ImGui::InputDouble("threshold", &threshold, 0.1f, 0.5f, "%.2f");
+
+			if (ImGui::Button("Add", { 100.0f, 30.0f }))
+			{
+				const element::MemoryTraceParameters mtp = { tauBuild, tauDecay, threshold };
+				const element::ElementSpatialDimensionParameters dimensions{ x_max, d_x };
+				const std::shared_ptr<element::MemoryTrace> memoryTrace(new element::MemoryTrace({ id, dimensions }, mtp));
+				simulation->addElement(memoryTrace);
+			}
+		}
+
+		void SimulationWindow::addElementMovingGaussStimulus() const
+		{
+			static char id[CHAR_SIZE] = "moving gauss stimulus a";
+			ImGui::InputTextWithHint("id", "enter text here", id, IM_ARRAYSIZE(id));
+			static int x_max = 100;
+			ImGui::InputInt("x_max", &x_max, 1.0, 10.0);
+			static double d_x = 0.1;
+			ImGui::InputDouble("d_x", &d_x, 0.1, 0.5, "%.2f");
+			static double sigma = 5;
+			ImGui::InputDouble("sigma", &sigma, 1.0f, 10.0f, "%.2f");
+			static double amplitude = 20;
+			ImGui::InputDouble("amplitude", &amplitude, 1.0f, 10.0f, "%.2f");
+			static double center = 50;
+			ImGui::InputDouble("center", &center, 1.0f, 10.0f, "%.2f");
+			static double range = 20;
+			ImGui::InputDouble("range", &range, 1.0f, 10.0f, "%.2f");
+			static double period = 100;
+			ImGui::InputDouble("period", &period, 10.0f, 100.0f, "%.2f");
+
+			if (ImGui::Button("Add", { 100.0f, 30.0f }) && period > 0)
+			{
+				// oscillates around the center
+				const element::MovingGaussStimulusParameters mgsp = { element::Trajectory::sinusoidal(center, range, period),
+					element::Trajectory::constant(amplitude), element::Trajectory::constant(sigma) };
+				const element::ElementSpatialDimensionParameters dimensions{ x_max, d_x };
+				const std::shared_ptr<element::MovingGaussStimulus> movingGaussStimulus(new element::MovingGaussStimulus({ id, dimensions }, mgsp));
+				simulation->addElement(movingGaussStimulus);
+			}
+		}
+
+		void SimulationWindow::addElementExternalInput() const
+		{
+			static char id[CHAR_SIZE] = "external input a";
+			ImGui::InputTextWithHint("id", "enter text here", id, IM_ARRAYSIZE(id));
+			static int x_max = 100;
+			ImGui::InputInt("x_max", &x_max, 1.0, 10.0);
+			static double d_x = 0.1;
+			ImGui::InputDouble("d_x", &d_x, 0.1, 0.5, "%.2f");
+			static int policy = 0;
+			ImGui::Combo("policy", &policy, "latest\0hold\0interpolate\0");
+			static int capacity = 4;
+			ImGui::InputInt("capacity", &capacity, 1, 4);
+
+			// producers are attached from code, through the element of the simulation
+			if (ImGui::Button("Add", { 100.0f, 30.0f }) && capacity > 0)
+			{
+				const element::ExternalInputParameters eip = { static_cast<element::ExternalInputPolicy>(policy), capacity };
+				const element::ElementSpatialDimensionParameters dimensions{ x_max, d_x };
+				const std::shared_ptr<element::ExternalInput> externalInput(new element::ExternalInput({ id, dimensions }, eip));
+				simulation->addElement(externalInput);
+			}
+		}
+
 		void SimulationWindow::addElementFieldCoupling() const
 		{
 		}
@@ -35,5 +35,22 @@ namespace dnf_composer::utilities
 		}
 		return false;
 	}
+
+	void writeBinary(std::ostream& stream, const std::string& value)
+	{
+		const auto size = static_cast<uint64_t>(value.size());
+		writeBinary(stream, size);
+		stream.write(value.data(), static_cast<std::streamsize>(size));
+	}
+
+	void readBinary(std::istream& stream, std::string& value)
+	{
+		uint64_t size = 0;
+		readBinary(stream, size);
+		if (!stream)
+			return;
+		value.resize(size);
+		stream.read(value.data(), static_cast<std::streamsize>(size));
+	}
 }
 
@@ -11,19 +11,31 @@ namespace dnf_composer
         setNeuralFieldPost();
         fieldCoupling->resetWeights();
 
-        const std::string pathPrefix = std::string(OUTPUT_DIRECTORY) + "/" + fieldCoupling->getUniqueName() + "_";
-        pathToFieldActivationPre = pathPrefix + neuralFieldPre->getUniqueName() + ".txt";
-        pathToFieldActivationPost = pathPrefix + neuralFieldPost->getUniqueName() + ".txt";
+        setDataFilePath(std::string(OUTPUT_DIRECTORY));
     }
 
     void LearningWizard::setDataFilePath(const std::string& filePath)
     {
-        const std::string pathPrefix = filePath + "/" + fieldCoupling->getUniqueName() + "_";
-        pathToFieldActivationPre = pathPrefix + neuralFieldPre->getUniqueName() + ".txt";
-        pathToFieldActivationPost = pathPrefix + neuralFieldPost->getUniqueName() + ".txt";
+        pathToTrainingData = filePath + "/" + fieldCoupling->getUniqueName() + "_" + neuralFieldPre->getUniqueName() + "_" + neuralFieldPost->getUniqueName() + "_training_data.bin";
     }
 
 
+    void LearningWizard::setNumberOfThreads(int numberOfThreads)
+    {
+        this->numberOfThreads = std::max(1, numberOfThreads);
+    }
+
+    void LearningWizard::setSettlingCriteria(const StabilityCriteria& settlingCriteria)
+    {
+        this->settlingCriteria = settlingCriteria;
+    }
+
+    void LearningWizard::setSteadyStateSolver(bool useSteadyStateSolver, const SteadyStateSolverParameters& parameters)
+    {
+        this->useSteadyStateSolver = useSteadyStateSolver;
+        this->steadyStateSolverParameters = parameters;
+    }
+
     void LearningWizard::setGaussStimulusParameters(const dnf_composer::element::GaussStimulusParameters& gaussStimulusParameters)
     {
         this->gaussStimulusParameters = gaussStimulusParameters;
@@ -41,88 +53,177 @@ namespace dnf_composer
 
     void LearningWizard::simulateAssociation()
     {
-        for (int i = 0; i < static_cast<int>(targetPeakLocationsForNeuralFieldPre.size()); i++)
+        if (targetPeakLocationsForNeuralFieldPre.size() != targetPeakLocationsForNeuralFieldPost.size())
         {
-            // Create Gaussian stimuli in the input field
-            for (int j = 0; j < static_cast<int>(targetPeakLocationsForNeuralFieldPre[i].size()); j++)
-            {
-                const std::string stimulusName = "Input Gaussian Stimulus " + std::to_string(i + 1) + std::to_string(j + 1);
-            	const element::ElementIdentifiers stimulusIdentifiers{ stimulusName };
-
-            	element::ElementSpatialDimensionParameters stimulusDimensions{ neuralFieldPre->getMaxSpatialDimension(), neuralFieldPre->getStepSize() };
-                element::ElementCommonParameters commonParameters{ stimulusIdentifiers, stimulusDimensions };
+            const std::string message = "Error simulating the association. The number of target peak locations for the input and output fields differ.\n";
+            log(LogLevel::ERROR, message);
+            return;
+        }
 
-            	gaussStimulusParameters.position = targetPeakLocationsForNeuralFieldPre[i][j];
-                std::shared_ptr<element::GaussStimulus> stimulus = std::make_shared<element::GaussStimulus>(commonParameters, gaussStimulusParameters);
+        // patterns are appended to the ones recorded by previous calls
+        trainingData.inputSize = neuralFieldPre->getSize();
+        trainingData.outputSize = neuralFieldPost->getSize();
+        const int firstPattern = trainingData.getNumberOfPatterns();
+        const int numberOfTargets = static_cast<int>(targetPeakLocationsForNeuralFieldPre.size());
+        trainingData.resize(firstPattern + numberOfTargets);
+        const auto inputRow = [&](int i) { return std::span<double>(trainingData.inputPatterns).subspan(static_cast<size_t>(firstPattern + i) * trainingData.inputSize, trainingData.inputSize); };
+        const auto outputRow = [&](int i) { return std::span<double>(trainingData.outputPatterns).subspan(static_cast<size_t>(firstPattern + i) * trainingData.outputSize, trainingData.outputSize); };
+
+        // every target pair starts from the initialized simulation without learnt weights
+        simulation->init();
+        fieldCoupling->resetWeights();
+        const std::shared_ptr<Simulation> initialState = simulation->clone();
+
+        // Each worker owns one episode simulation with a pool of stimuli added once. Between target pairs the
+        // initial state is restored from a checkpoint and the pooled stimuli are only moved and reconnected.
+        const unsigned int noiseSeed = std::random_device{}();
+        std::atomic<int> nextTarget = 0;
+        std::exception_ptr failure;
+        std::mutex failureMutex;
+        const auto worker = [&](const std::shared_ptr<Simulation>& episode)
+            {
+                try
+                {
+                    const AssociationStimuli stimuli = addAssociationStimuli(episode);
+                    std::stringstream initialCheckpoint;
+                    episode->saveCheckpoint(initialCheckpoint);
+
+                    for (int i = nextTarget++; i < numberOfTargets; i = nextTarget++)
+                    {
+                        initialCheckpoint.clear();
+                        initialCheckpoint.seekg(0);
+                        episode->loadCheckpoint(initialCheckpoint);
+                        for (int e = 0; e < episode->getNumberOfElements(); e++)
+                            if (const auto noise = std::dynamic_pointer_cast<element::NormalNoise>(episode->getElement(e)))
+                                noise->setSeed(noiseSeed + i);
+                        simulateAssociation(episode, stimuli, i, inputRow(i), outputRow(i));
+                    }
+
+                    for (const auto& stimulus : stimuli.pre)
+                        episode->removeElement(stimulus->getUniqueName());
+                    for (const auto& stimulus : stimuli.post)
+                        episode->removeElement(stimulus->getUniqueName());
+                }
+                catch (...)
+                {
+                    const std::lock_guard<std::mutex> lock(failureMutex);
+                    if (!failure)
+                        failure = std::current_exception();
+                }
+            };
+
+        if (!initialState)
+        {
+            log(LogLevel::WARNING, "The simulation cannot be cloned, the association is simulated sequentially.\n");
+            worker(simulation);
+        }
+        else
+        {
+            const int numberOfWorkers = std::max(1, std::min(numberOfThreads, numberOfTargets));
+            std::vector<std::thread> workers;
+            workers.reserve(numberOfWorkers - 1);
+            for (int w = 1; w < numberOfWorkers; w++)
+                workers.emplace_back([&] { worker(initialState->clone()); });
+            worker(initialState->clone());
+            for (auto& thread : workers)
+                thread.join();
+        }
 
-                simulation->addElement(stimulus);
-                neuralFieldPre->addInput(stimulus);
+        // restart simulation
+        simulation->init();
 
-                simulation->init();
-                fieldCoupling->resetWeights();
-                for (int k = 0; k < 100; k++)
-                    simulation->step();
-            }
+        if (failure)
+            std::rethrow_exception(failure);
+    }
 
-            // Create Gaussian stimuli in the output field
-            for (int j = 0; j < targetPeakLocationsForNeuralFieldPost[i].size(); j++)
+    LearningWizard::AssociationStimuli LearningWizard::addAssociationStimuli(const std::shared_ptr<Simulation>& targetSimulation) const
+    {
+        // one stimulus per simultaneous target peak, created disconnected
+        size_t numberOfPreStimuli = 0, numberOfPostStimuli = 0;
+        for (const auto& targets : targetPeakLocationsForNeuralFieldPre)
+            numberOfPreStimuli = std::max(numberOfPreStimuli, targets.size());
+        for (const auto& targets : targetPeakLocationsForNeuralFieldPost)
+            numberOfPostStimuli = std::max(numberOfPostStimuli, targets.size());
+
+        const auto createStimulus = [&](const std::string& stimulusName, const std::shared_ptr<element::Element>& field)
             {
-                const std::string stimulusName = "Output Gaussian Stimulus " + std::to_string(i + 1) + std::to_string(j + 1);
                 const element::ElementIdentifiers stimulusIdentifiers{ stimulusName };
-
-                element::ElementSpatialDimensionParameters stimulusDimensions{ neuralFieldPost->getMaxSpatialDimension(), neuralFieldPost->getStepSize() };
+                element::ElementSpatialDimensionParameters stimulusDimensions{ field->getMaxSpatialDimension(), field->getStepSize() };
                 element::ElementCommonParameters commonParameters{ stimulusIdentifiers, stimulusDimensions };
 
-            	gaussStimulusParameters.position = targetPeakLocationsForNeuralFieldPost[i][j];
-                std::shared_ptr<element::GaussStimulus> stimulus = std::make_shared<element::GaussStimulus>(commonParameters, gaussStimulusParameters);
-
-                simulation->addElement(stimulus);
-                neuralFieldPost->addInput(stimulus);
-
-                simulation->init();
-                fieldCoupling->resetWeights();
-
-                for (int k = 0; k < 100; k++)
-                    simulation->step();
-            }
+                element::GaussStimulusParameters stimulusParameters = gaussStimulusParameters;
+                stimulusParameters.position = 0.0;
+                auto stimulus = std::make_shared<element::GaussStimulus>(commonParameters, stimulusParameters);
+                targetSimulation->addElement(stimulus);
+                return stimulus;
+            };
+
+        AssociationStimuli stimuli;
+        const auto fieldPre = targetSimulation->getElement(neuralFieldPre->getUniqueName());
+        const auto fieldPost = targetSimulation->getElement(neuralFieldPost->getUniqueName());
+        for (size_t j = 0; j < numberOfPreStimuli; j++)
+            stimuli.pre.push_back(createStimulus("Input Gaussian Stimulus " + std::to_string(j + 1), fieldPre));
+        for (size_t j = 0; j < numberOfPostStimuli; j++)
+            stimuli.post.push_back(createStimulus("Output Gaussian Stimulus " + std::to_string(j + 1), fieldPost));
+        return stimuli;
+    }
 
-            // Remove gaussian stimuli from the input field
-            for (int j = 0; j < targetPeakLocationsForNeuralFieldPre[i].size(); j++)
-            {
-                std::string stimulusName = "Input Gaussian Stimulus " + std::to_string(i + 1) + std::to_string(j + 1);
-                simulation->removeElement(stimulusName);
-            }
+    void LearningWizard::simulateAssociation(const std::shared_ptr<Simulation>& targetSimulation, const AssociationStimuli& stimuli, int i, 
+        std::span<double> inputPattern, std::span<double> outputPattern) const
+    {
+        const auto fieldPre = targetSimulation->getElement(neuralFieldPre->getUniqueName());
+        const auto fieldPost = targetSimulation->getElement(neuralFieldPost->getUniqueName());
+        const auto& targetsPre = targetPeakLocationsForNeuralFieldPre[i];
+        const auto& targetsPost = targetPeakLocationsForNeuralFieldPost[i];
 
-            // Wait for the input field to settle again
-            // simulation->init();
-            for (int k = 0; k < 100; k++)
-                simulation->step();
+        // Place and connect the Gaussian stimuli of the input and output fields
+        for (size_t j = 0; j < targetsPre.size(); j++)
+        {
+            stimuli.pre[j]->setPosition(targetsPre[j]);
+            targetSimulation->createInteraction(stimuli.pre[j]->getUniqueName(), "output", fieldPre->getUniqueName());
+        }
+        for (size_t j = 0; j < targetsPost.size(); j++)
+        {
+            stimuli.post[j]->setPosition(targetsPost[j]);
+            targetSimulation->createInteraction(stimuli.post[j]->getUniqueName(), "output", fieldPost->getUniqueName());
+        }
 
+        // Let both fields settle with all stimuli present.
+        // Re-initializing after every added stimulus discarded the previous settling, so a single settle is equivalent.
+        settle(targetSimulation);
 
-            std::vector<double>* input = simulation->getComponentPtr(neuralFieldPre->getUniqueName(), "activation");
-            std::vector<double>* output = simulation->getComponentPtr(neuralFieldPost->getUniqueName(), "activation");
+        // Disconnect the gaussian stimuli from the input field
+        for (size_t j = 0; j < targetsPre.size(); j++)
+            targetSimulation->removeInteraction(stimuli.pre[j]->getUniqueName(), fieldPre->getUniqueName());
 
-            const auto inputRestingLevel = simulation->getComponentPtr(neuralFieldPre->getUniqueName(), "resting level");
-            const auto outputRestingLevel = simulation->getComponentPtr(neuralFieldPost->getUniqueName(), "resting level");
+        // Wait for the input field to settle again
+        settle(targetSimulation);
 
-            // normalize data (remove resting level and normalize between -1 and 1))
-            *input = normalizeFieldActivation(*input, (*inputRestingLevel)[0]);
-            *output = normalizeFieldActivation(*output, (*outputRestingLevel)[0]);
+        std::vector<double> input = fieldPre->getComponent("activation");
+        std::vector<double> output = fieldPost->getComponent("activation");
 
-            // save data
-            saveFieldActivation(input, pathToFieldActivationPre);
-            saveFieldActivation(output, pathToFieldActivationPost);
+        // normalize data (remove resting level and normalize between -1 and 1)) straight into the training rows
+        const auto inputRestingLevel = fieldPre->getComponent("resting level");
+        const auto outputRestingLevel = fieldPost->getComponent("resting level");
+        input = normalizeFieldActivation(input, inputRestingLevel[0]);
+        output = normalizeFieldActivation(output, outputRestingLevel[0]);
+        std::ranges::copy(input, inputPattern.begin());
+        std::ranges::copy(output, outputPattern.begin());
 
-            // Remove gaussian stimuli from the output field
-            for (int j = 0; j < targetPeakLocationsForNeuralFieldPost[i].size(); j++)
-            {
-                std::string stimulusName = "Output Gaussian Stimulus " + std::to_string(i + 1) + std::to_string(j + 1);
-                simulation->removeElement(stimulusName);
-            }
+        // Disconnect the gaussian stimuli from the output field
+        for (size_t j = 0; j < targetsPost.size(); j++)
+            targetSimulation->removeInteraction(stimuli.post[j]->getUniqueName(), fieldPost->getUniqueName());
+    }
 
-            // restart simulation
-            simulation->init();
+    void LearningWizard::settle(const std::shared_ptr<Simulation>& targetSimulation) const
+    {
+        if (useSteadyStateSolver)
+        {
+            SteadyStateSolver solver(targetSimulation, steadyStateSolverParameters);
+            if (solver.solve().converged)
+                return;
         }
+        targetSimulation->runUntilStable(settlingCriteria);
     }
 
     std::vector<double> LearningWizard::normalizeFieldActivation(std::vector<double>& vec, const double& restingLevel)
@@ -157,84 +258,115 @@ namespace dnf_composer
         return normalizedVec;
     }
 
-    void LearningWizard::saveFieldActivation(const std::vector<double>* fieldActivation, const std::string& filename)
+    void LearningWizard::trainWeights(const int iterations)
     {
-        std::ofstream file(filename, std::ios::app); // Open file in append mode
-        if (file.is_open())
+        if (trainingData.getNumberOfPatterns() == 0 && !loadTrainingData())
         {
-            for (const auto& element : (*fieldActivation))
-                file << element << " ";  // Write element to file separated by a space
-            file << '\n';
-            file.close();
+            const std::string message = "Error training the field coupling weights. There is no training data, run simulateAssociation() first.\n";
+            log(LogLevel::ERROR, message);
+            return;
         }
-        else
+
+        if (trainingData.inputSize != neuralFieldPre->getSize() || trainingData.outputSize != neuralFieldPost->getSize())
         {
-            const std::string message = "Failed to save data to " + filename + ".\n";;
+            const std::string message = "Error training the field coupling weights. The training data does not match the size of the neural fields.\n";
             log(LogLevel::ERROR, message);
+            return;
         }
-    }
-
-    std::vector<double> LearningWizard::readFieldActivation(const std::string& filename, int line)
-    {
-        std::ifstream file(filename);
-        std::vector<double> data;
 
-        if (file.is_open())
+        // update weights cycling through the in-memory patterns
+        const int numberOfPatterns = trainingData.getNumberOfPatterns();
+        std::vector<double> input = std::vector<double>(trainingData.inputSize);
+        std::vector<double> output = std::vector<double>(trainingData.outputSize);
+        for (int i = 0; i < iterations; i++)
         {
-            std::string lineData;
-            int currentLine = 0;
+            const int pattern = i % numberOfPatterns;
+            const auto inputRow = trainingData.inputPatterns.begin() + static_cast<std::ptrdiff_t>(pattern) * trainingData.inputSize;
+            const auto outputRow = trainingData.outputPatterns.begin() + static_cast<std::ptrdiff_t>(pattern) * trainingData.outputSize;
+            std::copy(inputRow, inputRow + trainingData.inputSize, input.begin());
+            std::copy(outputRow, outputRow + trainingData.outputSize, output.begin());
+            fieldCoupling->updateWeights(input, output);
+        }
 
-            // Read lines from the file until the desired line is reached
-            while (std::getline(file, lineData) && currentLine < line)
-                currentLine++;
+        // the weights are written once, after training
+        fieldCoupling->saveWeights();
+    }
 
-            if (currentLine == line)
-            {
-                std::istringstream iss(lineData);
-                double value;
-                while (iss >> value)
-                    data.push_back(value);
-            }
-            else
-            {
-                const std::string message = "Error training the field coupling weights. "
-											"Line " + std::to_string(static_cast<int>(line)) + " not found in " + filename + ".\n";
-                log(LogLevel::ERROR, message);
-            }
-            file.close();
-        }
-        else
+    const TrainingData& LearningWizard::getTrainingData() const
+    {
+        return trainingData;
+    }
+
+    bool LearningWizard::saveTrainingData() const
+    {
+        std::ofstream file(pathToTrainingData, std::ios::binary);
+        if (!file.is_open())
         {
-            const std::string message = "Failed to open file " + filename + ".\n";;
+            const std::string message = "Failed to save training data to " + pathToTrainingData + ".\n";
             log(LogLevel::ERROR, message);
+            return false;
         }
 
-        return data;
+        const int32_t header[3] = { trainingData.inputSize, trainingData.outputSize, trainingData.getNumberOfPatterns() };
+        file.write(reinterpret_cast<const char*>(header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(trainingData.inputPatterns.data()), static_cast<std::streamsize>(trainingData.inputPatterns.size() * sizeof(double)));
+        file.write(reinterpret_cast<const char*>(trainingData.outputPatterns.data()), static_cast<std::streamsize>(trainingData.outputPatterns.size() * sizeof(double)));
+        file.close();
+
+        const std::string message = "Saved training data to " + pathToTrainingData + ".\n";
+        log(LogLevel::INFO, message);
+        return true;
     }
 
-    void LearningWizard::trainWeights(const int iterations) const
+    bool LearningWizard::loadTrainingData()
     {
-        // check how much lines "temp_input.txt", and "temp_output.txt" have
-        const int numLinesInput = utilities::countNumOfLinesInFile(pathToFieldActivationPre);
-        const int numLinesOutput = utilities::countNumOfLinesInFile(pathToFieldActivationPost);
+        std::ifstream file(pathToTrainingData, std::ios::binary);
+        if (!file.is_open())
+        {
+            const std::string message = "Failed to open file " + pathToTrainingData + ".\n";
+            log(LogLevel::ERROR, message);
+            return false;
+        }
 
-        if (numLinesInput != numLinesOutput)
+        int32_t header[3] = { 0, 0, 0 };
+        file.read(reinterpret_cast<char*>(header), sizeof(header));
+        if (!file || header[0] <= 0 || header[1] <= 0 || header[2] < 0)
         {
-	        const std::string message = "Error training the field coupling weights. The files " + pathToFieldActivationPre + " and " + pathToFieldActivationPost + " have a different number of lines.\n";
+            const std::string message = "Failed to read training data from " + pathToTrainingData + ". Invalid header.\n";
             log(LogLevel::ERROR, message);
+            return false;
         }
 
-        // read data and update weights
-        int lineCount = 0;
-        std::vector<double> input = std::vector<double>(neuralFieldPre->getSize());
-        std::vector<double> output = std::vector<double>(neuralFieldPost->getSize());
-        for (int i = 0; i < iterations; i++)
+        // the patterns must fill the rest of the file exactly, before anything is allocated for them
+        const std::streamoff headerEnd = file.tellg();
+        file.seekg(0, std::ios::end);
+        const std::streamoff remainingBytes = file.tellg() - headerEnd;
+        file.seekg(headerEnd);
+        const auto bytesPerPattern = (static_cast<std::streamoff>(header[0]) + header[1]) * static_cast<std::streamoff>(sizeof(double));
+        if (!file || remainingBytes % bytesPerPattern != 0 || remainingBytes / bytesPerPattern != header[2])
         {
-            input = readFieldActivation(pathToFieldActivationPre, lineCount);
-            output = readFieldActivation(pathToFieldActivationPost, lineCount);
-            fieldCoupling->updateWeights(input, output);
-            lineCount = (lineCount + 1) % (numLinesInput);
+            const std::string message = "Failed to read training data from " + pathToTrainingData + ". The header does not match the size of the file.\n";
+            log(LogLevel::ERROR, message);
+            return false;
         }
+
+        TrainingData data;
+        data.inputSize = header[0];
+        data.outputSize = header[1];
+        data.resize(header[2]);
+        file.read(reinterpret_cast<char*>(data.inputPatterns.data()), static_cast<std::streamsize>(data.inputPatterns.size() * sizeof(double)));
+        file.read(reinterpret_cast<char*>(data.outputPatterns.data()), static_cast<std::streamsize>(data.outputPatterns.size() * sizeof(double)));
+        if (!file)
+        {
+            const std::string message = "Failed to read training data from " + pathToTrainingData + ". The file is truncated.\n";
+            log(LogLevel::ERROR, message);
+            return false;
+        }
+
+        trainingData = std::move(data);
+        const std::string message = "Read " + std::to_string(trainingData.getNumberOfPatterns()) + " training patterns from " + pathToTrainingData + ".\n";
+        log(LogLevel::INFO, message);
+        return true;
     }
 
     void LearningWizard::setFieldCoupling(const std::string& fieldCouplingUniqueId)
@@ -261,11 +393,27 @@ namespace dnf_composer
         fieldCoupling->saveWeights();
     }
 
-    void LearningWizard::clearTargetPeakLocationsFromFiles() const
+    void LearningWizard::clearTargetPeakLocationsFromFiles()
     {
-        std::ofstream file(pathToFieldActivationPre);
-        file.close();
-        file.open(pathToFieldActivationPost);
-        file.close();
+        trainingData.clear();
+        std::error_code errorCode;
+        std::filesystem::remove(pathToTrainingData, errorCode);
+    }
+
+    int TrainingData::getNumberOfPatterns() const
+    {
+        return inputSize > 0 ? static_cast<int>(inputPatterns.size() / inputSize) : 0;
+    }
+
+    void TrainingData::resize(int numberOfPatterns)
+    {
+        inputPatterns.resize(static_cast<size_t>(numberOfPatterns) * inputSize);
+        outputPatterns.resize(static_cast<size_t>(numberOfPatterns) * outputSize);
+    }
+
+    void TrainingData::clear()
+    {
+        inputPatterns.clear();
+        outputPatterns.clear();
     }
 }
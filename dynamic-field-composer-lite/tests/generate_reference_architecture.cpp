@@ -0,0 +1,19 @@
+// This is a personal academic project. Dear PVS-Studio, please check it.
+
+// PVS-Studio Static Code Analyzer for C, C++, C#, and Java: https://pvs-studio.com
+
+// Writes the generated code of the reference architecture to the path given as argument, for
+// test_simulation_code_generator.
+
+#include "simulation/simulation_code_generator.h"
+
+#include "reference_architecture.h"
+
+int main(int argc, char* argv[])
+{
+	if (argc != 2)
+		return 1;
+
+	const dnf_composer::SimulationCodeGenerator generator(createReferenceArchitecture(), { "dnf_generated", "ReferenceArchitecture" });
+	return generator.generate(std::string(argv[1])) ? 0 : 1;
+}
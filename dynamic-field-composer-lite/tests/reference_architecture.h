@@ -0,0 +1,42 @@
+#pragma once
+
+#include "simulation/simulation.h"
+#include "elements/neural_field.h"
+#include "elements/gauss_kernel.h"
+#include "elements/mexican_hat_kernel.h"
+#include "elements/gauss_stimulus.h"
+#include "elements/normal_noise.h"
+
+// Architecture shared by generate_reference_architecture and test_simulation_code_generator: the generator writes
+// its code at the state reached here, so both sides must build it and warm it up identically.
+inline std::shared_ptr<dnf_composer::Simulation> createReferenceArchitecture()
+{
+    using namespace dnf_composer::element;
+    auto simulation = std::make_shared<dnf_composer::Simulation>(1, 0, 0);
+
+    simulation->addElement(std::make_shared<GaussStimulus>(ElementCommonParameters{ "stimulus", 100 }, GaussStimulusParameters{ 3, 9, 30 }));
+    simulation->addElement(std::make_shared<NeuralField>(ElementCommonParameters{ "field u", 100 }, NeuralFieldParameters{ 25, -5, SigmoidFunction{ 0, 4 } }));
+    simulation->addElement(std::make_shared<GaussKernel>(ElementCommonParameters{ "u -> u", 100 }, GaussKernelParameters{ 3, 15, -0.5 }));
+    const auto noise = std::make_shared<NormalNoise>(ElementCommonParameters{ "noise", 100 }, NormalNoiseParameters{ 0.05 });
+    noise->setSeed(7);
+    simulation->addElement(noise);
+    const auto projection = std::make_shared<MexicanHatKernel>(ElementCommonParameters{ "u -> v", 100 }, MexicanHatKernelParameters{ 4, 20, 10, 12, -0.2 });
+    projection->setCircular(false);
+    projection->setBorderCompensation(true);
+    simulation->addElement(projection);
+    simulation->addElement(std::make_shared<NeuralField>(ElementCommonParameters{ "field v", 100 }, NeuralFieldParameters{ 10, -3, HeavisideFunction{ 0 } }));
+
+    simulation->createInteraction("stimulus", "output", "field u");
+    simulation->createInteraction("u -> u", "output", "field u");
+    simulation->createInteraction("noise", "output", "field u");
+    simulation->createInteraction("field u", "output", "u -> u");
+    simulation->createInteraction("field u", "output", "u -> v");
+    simulation->createInteraction("u -> v", "output", "field v");
+
+    simulation->init();
+    simulation->compile();
+    // leaves non-uniform activations for the initial state of the generated code
+    for (int i = 0; i < 20; i++)
+        simulation->step();
+    return simulation;
+}
@@ -76,10 +76,11 @@ TEST_CASE("Element class tests", "[element]")
         element->addInput(inputElement, "output");
 
         // Remove input
-        element->removeInput("inputElement");
+        REQUIRE(element->removeInput("inputElement"));
 
         // Check if input was removed
         REQUIRE(element->hasInput("inputElement", "output") == false);
+        REQUIRE_FALSE(element->removeInput("inputElement"));
     }
     SECTION("updateInput() getComponent() getComponentPtr() methods")
     {
@@ -107,6 +108,32 @@ TEST_CASE("Element class tests", "[element]")
         REQUIRE(actualInputPtr == expectedInput);
 
     }
+    SECTION("Weighted input connections")
+    {
+        const auto element = createSampleNeuralField("weighted", 3);
+        const auto excitatory = createSampleNeuralField("excitatory", 3);
+        const auto inhibitory = createSampleNeuralField("inhibitory", 3);
+        excitatory->getComponentPtr("output")->assign({ 1.0, 2.0, 3.0 });
+        inhibitory->getComponentPtr("output")->assign({ 0.5, 0.5, 0.5 });
+
+        element->addInput(excitatory, "output", 2.0);
+        element->addInput(inhibitory, "output", -4.0);
+
+        // connections stay in the order they were added
+        const auto& connections = element->getInputConnections();
+        REQUIRE(connections.size() == 2);
+        REQUIRE(connections[0].element == excitatory);
+        REQUIRE(connections[0].gain == 2.0);
+        REQUIRE(connections[1].element == inhibitory);
+        REQUIRE(connections[1].gain == -4.0);
+
+        element->updateInput();
+        REQUIRE(element->getComponent("input") == std::vector<double>{ 0.0, 2.0, 4.0 });
+
+        element->removeInput("excitatory");
+        element->updateInput();
+        REQUIRE(element->getComponent("input") == std::vector<double>{ -2.0, -2.0, -2.0 });
+    }
     SECTION("getUniqueIdentifier() method")
     {
         // Create a mock Element object for testing
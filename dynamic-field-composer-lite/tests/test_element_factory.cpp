@@ -70,6 +70,30 @@ TEST_CASE("ElementFactory - Creation of Normal Noise")
     REQUIRE(normalNoise->getLabel() == ElementLabel::NORMAL_NOISE);
 }
 
+TEST_CASE("ElementFactory - Creation of Memory Trace")
+{
+    ElementFactory elementFactory;
+    CompoundElementParameters params;
+    params.mtp.tauBuild = 50.0;
+
+    auto memoryTrace = elementFactory.create(ElementLabel::MEMORY_TRACE, { "memory_trace_1", 100 }, params);
+
+    REQUIRE(memoryTrace != nullptr);
+    REQUIRE(memoryTrace->getLabel() == ElementLabel::MEMORY_TRACE);
+}
+
+TEST_CASE("ElementFactory - Creation of External Input")
+{
+    ElementFactory elementFactory;
+    CompoundElementParameters params;
+    params.eip.policy = ExternalInputPolicy::INTERPOLATE;
+
+    auto externalInput = elementFactory.create(ElementLabel::EXTERNAL_INPUT, { "external_input_1", 100 }, params);
+
+    REQUIRE(externalInput != nullptr);
+    REQUIRE(externalInput->getLabel() == ElementLabel::EXTERNAL_INPUT);
+}
+
 TEST_CASE("ElementFactory - Creation of Gauss Field Coupling")
 {
     ElementFactory elementFactory;
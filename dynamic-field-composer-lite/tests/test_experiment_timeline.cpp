@@ -0,0 +1,131 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include "simulation/experiment_timeline.h"
+#include "elements/neural_field.h"
+#include "elements/gauss_kernel.h"
+#include "elements/gauss_stimulus.h"
+
+static std::shared_ptr<dnf_composer::Simulation> createProtocolSimulation()
+{
+    using namespace dnf_composer::element;
+    auto simulation = std::make_shared<dnf_composer::Simulation>(1, 0, 0);
+
+    const SigmoidFunction sigmoidFunction{ 0, 4 };
+    const auto field = std::make_shared<NeuralField>(ElementCommonParameters{ "field", 100 }, NeuralFieldParameters{ 20, -5, sigmoidFunction });
+    const auto kernel = std::make_shared<GaussKernel>(ElementCommonParameters{ "kernel", 100 }, GaussKernelParameters{ 3, 15, -0.5 });
+    const auto stimulus = std::make_shared<GaussStimulus>(ElementCommonParameters{ "stimulus", 100 }, GaussStimulusParameters{ 3, 8, 40 });
+    simulation->addElement(field);
+    simulation->addElement(kernel);
+    simulation->addElement(stimulus);
+    simulation->createInteraction("stimulus", "output", "field");
+    simulation->createInteraction("field", "output", "kernel");
+    simulation->createInteraction("kernel", "output", "field");
+    simulation->init();
+    return simulation;
+}
+
+TEST_CASE("Experiment timeline", "[experiment_timeline]")
+{
+    using namespace dnf_composer;
+
+    ExperimentTimeline timeline;
+    timeline.startRecording(0, "activation", "field", "activation")
+        .disableStimulus(10, "stimulus")
+        .setStimulusPosition(15, "stimulus", 70)
+        .enableStimulus(20, "stimulus")
+        .stopRecording(25, "activation")
+        .snapshot(30, "final", "field", "activation");
+
+    // the same protocol written as a loop
+    const auto manual = createProtocolSimulation();
+    std::vector<std::vector<double>> expectedFrames{ manual->getComponent("field", "activation") };
+    for (int step = 1; step <= 30; step++)
+    {
+        if (step == 11)
+            manual->setInteractionGain("stimulus", "field", 0.0);
+        if (step == 16)
+            std::dynamic_pointer_cast<element::GaussStimulus>(manual->getElement("stimulus"))->setPosition(70);
+        if (step == 21)
+            manual->setInteractionGain("stimulus", "field", 1.0);
+        manual->step();
+        if (step <= 25)
+            expectedFrames.push_back(manual->getComponent("field", "activation"));
+    }
+
+    for (const bool compile : { false, true })
+    {
+        const auto simulation = createProtocolSimulation();
+        if (compile)
+            simulation->compile();
+        const ExperimentResults results = simulation->run(timeline);
+        REQUIRE(results.completed);
+        REQUIRE(simulation->t == 30);
+
+        const ExperimentRecording& recording = results.recordings.at("activation");
+        REQUIRE(recording.getNumberOfFrames() == expectedFrames.size());
+        for (size_t i = 0; i < expectedFrames.size(); i++)
+        {
+            REQUIRE(recording.times[i] == static_cast<double>(i));
+            REQUIRE(std::vector<double>(recording.frame(i), recording.frame(i) + recording.frameSize) == expectedFrames[i]);
+        }
+        REQUIRE(results.snapshots.at("final") == manual->getComponent("field", "activation"));
+        REQUIRE(simulation->getElement("field")->getInputConnections().front().gain == 1.0);
+    }
+
+    SECTION("The clock holds while waiting for stability")
+    {
+        const auto simulation = createProtocolSimulation();
+        std::vector<double> actionTimes;
+        ExperimentTimeline settling;
+        settling.waitUntilStable(0)
+            .action(5, [&](Simulation& target) { actionTimes.push_back(target.t); })
+            .setDuration(10);
+        const ExperimentResults results = simulation->run(settling);
+        REQUIRE(results.completed);
+        REQUIRE(results.settlingSteps.size() == 1);
+        REQUIRE(results.settlingSteps.front() > 0);
+        REQUIRE(actionTimes == std::vector<double>{ results.settlingSteps.front() + 5.0 });
+        REQUIRE(simulation->t == results.settlingSteps.front() + 10.0);
+    }
+
+    SECTION("Events and recordings after an action follow the elements it replaced")
+    {
+        using namespace dnf_composer::element;
+        const auto simulation = createProtocolSimulation();
+        const auto oldStimulus = std::dynamic_pointer_cast<GaussStimulus>(simulation->getElement("stimulus"));
+        ExperimentTimeline replacing;
+        replacing.startRecording(0, "activation", "field", "activation")
+            .action(5, [](Simulation& target)
+                {
+                    target.resetElement("field", std::make_shared<NeuralField>(ElementCommonParameters{ "field", 100 }, NeuralFieldParameters{ 20, -5, SigmoidFunction{ 0, 4 } }));
+                    target.resetElement("stimulus", std::make_shared<GaussStimulus>(ElementCommonParameters{ "stimulus", 100 }, GaussStimulusParameters{ 3, 8, 40 }));
+                })
+            .setStimulusPosition(6, "stimulus", 70)
+            .setDuration(10);
+        const ExperimentResults results = simulation->run(replacing);
+        REQUIRE(results.completed);
+
+        const ExperimentRecording& recording = results.recordings.at("activation");
+        const size_t last = recording.getNumberOfFrames() - 1;
+        REQUIRE(std::vector<double>(recording.frame(last), recording.frame(last) + recording.frameSize) == simulation->getComponent("field", "activation"));
+        REQUIRE(std::dynamic_pointer_cast<GaussStimulus>(simulation->getElement("stimulus"))->getParameters().position == 70);
+        REQUIRE(oldStimulus->getParameters().position == 40);
+
+        // an action removing what a later event acts on stops the experiment
+        ExperimentTimeline removing;
+        removing.action(0, [](Simulation& target) { target.removeElement("stimulus"); })
+            .setStimulusAmplitude(1, "stimulus", 3);
+        REQUIRE_FALSE(createProtocolSimulation()->run(removing).completed);
+    }
+
+    SECTION("Unresolved events stop the experiment before it starts")
+    {
+        const auto simulation = createProtocolSimulation();
+        ExperimentTimeline invalid;
+        invalid.setComponent(0, "field", "resting level", -3).snapshot(5, "missing", "field", "no such component");
+        REQUIRE_FALSE(simulation->run(invalid).completed);
+        REQUIRE(simulation->t == 0);
+        REQUIRE(simulation->getComponent("field", "resting level").front() == -5);
+        REQUIRE_THROWS(ExperimentTimeline().snapshot(-1, "early", "field", "output"));
+    }
+}
@@ -0,0 +1,172 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+
+#include <thread>
+
+#include "elements/external_input.h"
+#include "simulation/simulation.h"
+
+static std::vector<double> constantFrame(int size, double value)
+{
+	return std::vector<double>(size, value);
+}
+
+TEST_CASE("ExternalInput class tests", "[ExternalInput]")
+{
+	using namespace dnf_composer::element;
+	constexpr int size = 20;
+
+	SECTION("Constructor rejects an empty queue")
+	{
+		REQUIRE_THROWS(ExternalInput({ "external input", size }, { ExternalInputPolicy::LATEST, 0 }));
+	}
+
+	SECTION("Latest frame replaces the output and older frames are dropped")
+	{
+		ExternalInput externalInput({ "external input", size }, { ExternalInputPolicy::LATEST, 4 });
+		externalInput.init();
+
+		REQUIRE(externalInput.publish(constantFrame(size, 1.0), 0.5));
+		REQUIRE(externalInput.publish(constantFrame(size, 2.0), 0.8));
+		externalInput.step(1.0, 1.0);
+
+		REQUIRE(externalInput.getComponent("output") == constantFrame(size, 2.0));
+		ExternalInputStatistics statistics = externalInput.getStatistics();
+		REQUIRE(statistics.framesReceived == 2);
+		REQUIRE(statistics.framesDropped == 1);
+		REQUIRE(statistics.age == Catch::Approx(0.2));
+		REQUIRE(statistics.queuedFrames == 0);
+
+		// without new frames the output is held and grows stale
+		externalInput.step(2.0, 1.0);
+		externalInput.step(3.0, 1.0);
+		REQUIRE(externalInput.getComponent("output") == constantFrame(size, 2.0));
+		statistics = externalInput.getStatistics();
+		REQUIRE(statistics.stepsWithoutFrame == 2);
+		REQUIRE(statistics.age == Catch::Approx(2.2));
+	}
+
+	SECTION("Hold takes one frame per step in publishing order")
+	{
+		ExternalInput externalInput({ "external input", size }, { ExternalInputPolicy::HOLD, 4 });
+		externalInput.init();
+
+		for (int k = 1; k <= 3; k++)
+			REQUIRE(externalInput.publish(constantFrame(size, k), k));
+		for (int k = 1; k <= 4; k++)
+		{
+			externalInput.step(k, 1.0);
+			REQUIRE(externalInput.getComponent("output") == constantFrame(size, std::min(k, 3)));
+		}
+		REQUIRE(externalInput.getStatistics().framesDropped == 0);
+		REQUIRE(externalInput.getStatistics().stepsWithoutFrame == 1);
+	}
+
+	SECTION("Interpolate between the frames around the step time")
+	{
+		ExternalInput externalInput({ "external input", size }, { ExternalInputPolicy::INTERPOLATE, 4 });
+		externalInput.init();
+
+		REQUIRE(externalInput.publish(constantFrame(size, 0.0), 0.0));
+		REQUIRE(externalInput.publish(constantFrame(size, 10.0), 4.0));
+		REQUIRE(externalInput.publish(constantFrame(size, 30.0), 8.0));
+
+		externalInput.step(1.0, 1.0);
+		REQUIRE(externalInput.getComponent("output")[0] == Catch::Approx(2.5));
+		// the frame at 8 is only taken once the step time passed the frame at 4
+		REQUIRE(externalInput.getStatistics().queuedFrames == 1);
+		externalInput.step(6.0, 1.0);
+		REQUIRE(externalInput.getComponent("output")[size - 1] == Catch::Approx(20.0));
+		externalInput.step(9.0, 1.0);
+		REQUIRE(externalInput.getComponent("output")[0] == Catch::Approx(30.0));
+		REQUIRE(externalInput.getStatistics().framesDropped == 0);
+	}
+
+	SECTION("Full queue rejects frames until the simulation takes them")
+	{
+		ExternalInput externalInput({ "external input", size }, { ExternalInputPolicy::HOLD, 2 });
+		externalInput.init();
+
+		REQUIRE(externalInput.acquireFrame() != nullptr);
+		externalInput.commitFrame(0.0);
+		REQUIRE(externalInput.publish(constantFrame(size, 1.0), 0.0));
+		REQUIRE(externalInput.acquireFrame() == nullptr);
+		REQUIRE_FALSE(externalInput.publish(constantFrame(size, 1.0), 0.0));
+		REQUIRE(externalInput.getStatistics().framesRejected == 2);
+
+		externalInput.step(1.0, 1.0);
+		REQUIRE(externalInput.acquireFrame() != nullptr);
+		REQUIRE_FALSE(externalInput.publish(constantFrame(size + 1, 1.0), 0.0));
+	}
+
+	SECTION("Init discards queued frames")
+	{
+		ExternalInput externalInput({ "external input", size }, { ExternalInputPolicy::LATEST, 4 });
+		REQUIRE(externalInput.publish(constantFrame(size, 1.0), 0.0));
+		externalInput.init();
+		externalInput.step(1.0, 1.0);
+
+		REQUIRE(externalInput.getComponent("output") == constantFrame(size, 0.0));
+		REQUIRE(externalInput.getStatistics().framesReceived == 0);
+	}
+
+	SECTION("Frames written in place by a producer thread arrive whole and in order")
+	{
+		constexpr int numberOfFrames = 2000;
+		const auto externalInput = std::make_shared<ExternalInput>(ElementCommonParameters{ "external input", size },
+			ExternalInputParameters{ ExternalInputPolicy::HOLD, 3 });
+		externalInput->init();
+
+		std::thread producer([&externalInput]
+		{
+			for (int k = 1; k <= numberOfFrames;)
+			{
+				double* frame = externalInput->acquireFrame();
+				if (frame == nullptr)
+				{
+					std::this_thread::yield();
+					continue;
+				}
+				std::fill_n(frame, size, static_cast<double>(k));
+				externalInput->commitFrame(k);
+				k++;
+			}
+		});
+
+		double last = 0.0;
+		for (int step = 1; last < numberOfFrames; step++)
+		{
+			externalInput->step(step, 1.0);
+			if (externalInput->getStatistics().stepsWithoutFrame > 0)
+			{
+				std::this_thread::yield();
+				continue;
+			}
+			const std::vector<double>& output = *externalInput->getComponentPtr("output");
+			REQUIRE(std::ranges::all_of(output, [&](double value) { return value == output[0]; }));
+			REQUIRE(output[0] == last + 1);
+			last = output[0];
+		}
+		producer.join();
+
+		const ExternalInputStatistics statistics = externalInput->getStatistics();
+		REQUIRE(statistics.framesReceived == numberOfFrames);
+		REQUIRE(statistics.framesDropped == 0);
+	}
+
+	SECTION("Consumers read the external input as any other output")
+	{
+		dnf_composer::Simulation simulation(1.0);
+		const auto externalInput = std::make_shared<ExternalInput>(ElementCommonParameters{ "external input", size });
+		simulation.addElement(externalInput);
+		simulation.init();
+
+		REQUIRE(externalInput->publish(constantFrame(size, 3.0), 0.5));
+		simulation.step();
+		REQUIRE(simulation.getComponent("external input", "output") == constantFrame(size, 3.0));
+
+		const std::shared_ptr<Element> clone = externalInput->clone();
+		REQUIRE(clone->getComponent("output") == constantFrame(size, 3.0));
+		REQUIRE(std::dynamic_pointer_cast<ExternalInput>(clone)->getStatistics().queuedFrames == 0);
+	}
+}
@@ -1,6 +1,11 @@
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+
+#include <filesystem>
+#include <fstream>
 
 #include "elements/field_coupling.h"
+#include "elements/gauss_stimulus.h"
 
 using namespace dnf_composer::element;
 
@@ -63,6 +68,32 @@ TEST_CASE("FieldCoupling - File I/O Operations")
         REQUIRE(fieldCoupling.getWeights()[1].size() == 3);
     }
 
+    SECTION("A weights file of other field sizes is left on disk")
+    {
+        fieldCoupling.setWeightsFilePath(std::filesystem::temp_directory_path().string());
+        const std::filesystem::path weightsFile = std::filesystem::temp_directory_path() / "field_coupling_5_weights.txt";
+        const std::string trainedWeights = "1 2 3 4 \n5 6 7 8 \n";
+        {
+            std::ofstream file(weightsFile);
+            file << trainedWeights;
+        }
+
+        fieldCoupling.init();
+        std::ifstream file(weightsFile);
+        const std::string stored{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+        file.close();
+        REQUIRE(stored == trainedWeights);
+        REQUIRE(fieldCoupling.getWeights().size() == 2);
+        REQUIRE(fieldCoupling.getWeights()[0].size() == 3);
+
+        // only a missing file is written
+        std::filesystem::remove(weightsFile);
+        fieldCoupling.init();
+        REQUIRE(std::filesystem::exists(weightsFile));
+        REQUIRE(fieldCoupling.readWeights());
+        std::filesystem::remove(weightsFile);
+    }
+
     SECTION("Invalid File Path Throws Exception")
     {
         // Set an invalid file path
@@ -72,3 +103,179 @@ TEST_CASE("FieldCoupling - File I/O Operations")
         REQUIRE_FALSE(fieldCoupling.readWeights());
     }
 }
+
+TEST_CASE("FieldCoupling - Sparse Weight Storage")
+{
+    FieldCouplingParameters params;
+    params.inputFieldSize = 20;
+    params.scalar = 1.0;
+    params.learningRate = 1.0;
+    params.learningRule = dnf_composer::LearningRule::HEBBIAN;
+
+    const auto stimulus = std::make_shared<GaussStimulus>(ElementCommonParameters{ "fc_sparse_stimulus", 20 }, GaussStimulusParameters{ 2.0, 1.0, 5.0 });
+    stimulus->init();
+
+    auto dense = std::make_shared<FieldCoupling>(ElementCommonParameters{ "fc_dense", 20 }, params);
+    params.weightStorage = dnf_composer::WeightStorage::SPARSE;
+    params.pruningThreshold = 1e-3;
+    auto sparse = std::make_shared<FieldCoupling>(ElementCommonParameters{ "fc_sparse", 20 }, params);
+
+    const std::vector<double> input = dnf_composer::mathtools::circularGauss(20, 2.0, 5.0);
+    const std::vector<double> output = dnf_composer::mathtools::circularGauss(20, 2.0, 12.0);
+    dense->updateWeights(input, output);
+    sparse->updateWeights(input, output);
+
+    SECTION("Pruning drops small weights and reports statistics")
+    {
+        const SparsityStatistics statistics = sparse->getSparsityStatistics();
+        REQUIRE(statistics.numberOfNonZeros > 0);
+        REQUIRE(statistics.density < 0.5);
+        REQUIRE(statistics.relativeError < 1e-2);
+    }
+
+    SECTION("Sparse output matches dense output")
+    {
+        dense->addInput(stimulus);
+        sparse->addInput(stimulus);
+        dense->step(1, 1);
+        sparse->step(1, 1);
+
+        const std::vector<double> denseOutput = dense->getComponent("output");
+        const std::vector<double> sparseOutput = sparse->getComponent("output");
+        for (int i = 0; i < static_cast<int>(denseOutput.size()); i++)
+            REQUIRE(sparseOutput[i] == Catch::Approx(denseOutput[i]).margin(1e-2));
+    }
+
+    SECTION("Top-k per output keeps at most k weights per row")
+    {
+        sparse->setWeightStorage(dnf_composer::WeightStorage::SPARSE, 0.0, 3);
+        const auto& sparseWeights = sparse->getSparseWeights();
+        for (int r = 0; r < sparseWeights.rows; r++)
+            REQUIRE(sparseWeights.rowOffsets[r + 1] - sparseWeights.rowOffsets[r] <= 3);
+    }
+
+    SECTION("Delta learning updates the sparse weights like the dense ones")
+    {
+        for (const auto rule : { dnf_composer::LearningRule::DELTA_WIDROW_HOFF, dnf_composer::LearningRule::DELTA_KROGH_HERTZ })
+        {
+            params.learningRule = rule;
+            params.learningRate = 0.1;
+            params.weightStorage = dnf_composer::WeightStorage::DENSE;
+            auto denseDelta = std::make_shared<FieldCoupling>(ElementCommonParameters{ "fc_dense_delta", 20 }, params);
+            params.weightStorage = dnf_composer::WeightStorage::SPARSE;
+            params.pruningThreshold = 1e-4;
+            auto sparseDelta = std::make_shared<FieldCoupling>(ElementCommonParameters{ "fc_sparse_delta", 20 }, params);
+            denseDelta->resetWeights();
+            sparseDelta->resetWeights();
+            REQUIRE(sparseDelta->getSparsityStatistics().numberOfNonZeros == 0);
+
+            for (const double position : { 3.0, 9.0, 15.0, 3.0 })
+            {
+                const std::vector<double> patternInput = dnf_composer::mathtools::circularGauss(20, 2.0, position);
+                const std::vector<double> patternOutput = dnf_composer::mathtools::circularGauss(20, 2.0, 20.0 - position);
+                denseDelta->updateWeights(patternInput, patternOutput);
+                sparseDelta->updateWeights(patternInput, patternOutput);
+            }
+
+            REQUIRE(sparseDelta->getSparsityStatistics().numberOfNonZeros > 0);
+            REQUIRE(sparseDelta->getSparsityStatistics().density < 1.0);
+            const auto denseWeights = denseDelta->getWeights();
+            const auto sparseWeights = sparseDelta->reconstructWeights();
+            for (int i = 0; i < 20; i++)
+                for (int j = 0; j < 20; j++)
+                    REQUIRE(sparseWeights[i][j] == Catch::Approx(denseWeights[i][j]).margin(1e-3));
+        }
+    }
+
+    SECTION("Switching back to dense storage restores the sparse weights")
+    {
+        const auto sparseWeights = sparse->reconstructWeights();
+        sparse->setWeightStorage(dnf_composer::WeightStorage::DENSE);
+        REQUIRE(sparse->getWeights() == sparseWeights);
+    }
+}
+
+TEST_CASE("FieldCoupling - Low Rank Weight Storage")
+{
+    FieldCouplingParameters params;
+    params.inputFieldSize = 20;
+    params.scalar = 1.0;
+    params.learningRate = 0.1;
+    params.learningRule = dnf_composer::LearningRule::DELTA_KROGH_HERTZ;
+
+    auto dense = std::make_shared<FieldCoupling>(ElementCommonParameters{ "fc_lr_dense", 20 }, params);
+    params.weightStorage = dnf_composer::WeightStorage::LOW_RANK;
+    params.maxRank = 8;
+    auto lowRank = std::make_shared<FieldCoupling>(ElementCommonParameters{ "fc_lr_low_rank", 20 }, params);
+    dense->resetWeights();
+    lowRank->resetWeights();
+
+    const std::vector<double> positions = { 3.0, 9.0, 15.0 };
+    for (const double position : positions)
+    {
+        const std::vector<double> input = dnf_composer::mathtools::circularGauss(20, 2.0, position);
+        const std::vector<double> output = dnf_composer::mathtools::circularGauss(20, 2.0, 20.0 - position);
+        dense->updateWeights(input, output);
+        lowRank->updateWeights(input, output);
+    }
+
+    SECTION("Factorized learning matches the dense learning rule")
+    {
+        REQUIRE(lowRank->getLowRankStatistics().rank <= 3);
+        const auto denseWeights = dense->getWeights();
+        const auto lowRankWeights = lowRank->reconstructWeights();
+        for (int i = 0; i < 20; i++)
+            for (int j = 0; j < 20; j++)
+                REQUIRE(lowRankWeights[i][j] == Catch::Approx(denseWeights[i][j]).margin(1e-9));
+    }
+
+    SECTION("Low rank output matches dense output")
+    {
+        const auto stimulus = std::make_shared<GaussStimulus>(ElementCommonParameters{ "fc_lr_stimulus", 20 }, GaussStimulusParameters{ 2.0, 1.0, 9.0 });
+        stimulus->init();
+        dense->addInput(stimulus);
+        lowRank->addInput(stimulus);
+        dense->step(1, 1);
+        lowRank->step(1, 1);
+
+        const std::vector<double> denseOutput = dense->getComponent("output");
+        const std::vector<double> lowRankOutput = lowRank->getComponent("output");
+        for (int i = 0; i < static_cast<int>(denseOutput.size()); i++)
+            REQUIRE(lowRankOutput[i] == Catch::Approx(denseOutput[i]).margin(1e-9));
+    }
+
+    SECTION("Truncation bounds the rank and reports the discarded energy")
+    {
+        lowRank->setMaxRank(1);
+        const LowRankStatistics statistics = lowRank->getLowRankStatistics();
+        REQUIRE(statistics.rank == 1);
+        REQUIRE(statistics.relativeError > 0.0);
+        REQUIRE(statistics.relativeError < 1.0);
+
+        // the best rank-1 approximation error equals the reported relative error
+        const auto denseWeights = dense->getWeights();
+        const auto lowRankWeights = lowRank->reconstructWeights();
+        double errorNorm = 0.0, fullNorm = 0.0;
+        for (int i = 0; i < 20; i++)
+            for (int j = 0; j < 20; j++)
+            {
+                errorNorm += std::pow(denseWeights[i][j] - lowRankWeights[i][j], 2);
+                fullNorm += std::pow(denseWeights[i][j], 2);
+            }
+        REQUIRE(std::sqrt(errorNorm / fullNorm) == Catch::Approx(statistics.relativeError).margin(1e-6));
+    }
+
+    SECTION("Factorized learning rejects patterns of different sizes")
+    {
+        const std::vector<double> input(20, 1.0), output(10, 1.0);
+        REQUIRE_THROWS_AS(dnf_composer::mathtools::hebbLearningRuleLowRank(input, output, 0.1), std::invalid_argument);
+        REQUIRE_THROWS_AS(lowRank->updateWeights(input, output), std::invalid_argument);
+    }
+
+    SECTION("Switching back to dense storage restores the weights")
+    {
+        const auto lowRankWeights = lowRank->reconstructWeights();
+        lowRank->setWeightStorage(dnf_composer::WeightStorage::DENSE);
+        REQUIRE(lowRank->getWeights() == lowRankWeights);
+    }
+}
@@ -1,6 +1,7 @@
 #include <catch2/catch_test_macros.hpp>
 
 #include "elements/gauss_kernel.h"
+#include "elements/gauss_stimulus.h"
 
 TEST_CASE("GaussKernel class tests", "[GaussKernel]")
 {
@@ -35,4 +36,97 @@ TEST_CASE("GaussKernel class tests", "[GaussKernel]")
 		kernel.setParameters(params);
 		REQUIRE(kernel.getParameters() == params);
 	}
-}
\ No newline at end of file
+}
+
+TEST_CASE("GaussKernel recursive convolution", "[GaussKernel]")
+{
+	using namespace dnf_composer::element;
+	constexpr int size = 200;
+	const auto stimulus = std::make_shared<GaussStimulus>(ElementCommonParameters{ "stimulus", size }, GaussStimulusParameters{ 2, 1, 50 });
+	stimulus->init();
+
+	GaussKernel direct({ "direct", size }, { 10, 3, 0 });
+	GaussKernel recursive({ "recursive", size }, { 10, 3, 0 });
+	recursive.setConvolutionMethod(ConvolutionMethod::RECURSIVE);
+	REQUIRE(recursive.getConvolutionMethod() == ConvolutionMethod::RECURSIVE);
+
+	for (GaussKernel* kernel : { &direct, &recursive })
+	{
+		kernel->addInput(stimulus);
+		kernel->init();
+		kernel->step(1, 1);
+	}
+
+	// the box filter cascade stays within the documented bound of the exact convolution
+	const double boundRelativeToPeak = dnf_composer::mathtools::gaussianBoxFilterKernelError(10, size);
+	REQUIRE(boundRelativeToPeak < 0.036);
+	const auto expected = direct.getComponent("output");
+	const auto approximated = recursive.getComponent("output");
+	const double peak = *std::ranges::max_element(expected);
+	for (int i = 0; i < size; i++)
+		REQUIRE(std::abs(approximated[i] - expected[i]) <= 0.036 * peak);
+}
+
+// A stimulus that is never stepped keeps whatever output it is given.
+static std::shared_ptr<dnf_composer::element::GaussStimulus> createSource(const std::vector<double>& output)
+{
+	using namespace dnf_composer::element;
+	const int size = static_cast<int>(output.size());
+	auto source = std::make_shared<GaussStimulus>(ElementCommonParameters{ "source", size }, GaussStimulusParameters{ 2, 1, 0 });
+	*source->getComponentPtr("output") = output;
+	return source;
+}
+
+TEST_CASE("GaussKernel boundary modes", "[GaussKernel]")
+{
+	using namespace dnf_composer::element;
+	constexpr int size = 60;
+	std::vector<double> input(size, 0.0);
+	for (int i = 0; i < size; i += 13)
+		input[i] = 1.0 + 0.1 * i;
+	input[size - 1] = 2.0;
+
+	GaussKernel kernel({ "kernel", size }, { 4, 3, 0 });
+	kernel.init();
+
+	SECTION("circular convolution matches the padded reference")
+	{
+		const auto range = kernel.getKernelRange();
+		const std::vector<int> extIndex = dnf_composer::mathtools::createExtendedIndex(size, range);
+		const std::vector<double> expected = dnf_composer::mathtools::conv_valid(dnf_composer::mathtools::obtainCircularVector(extIndex, input), kernel.getComponent("kernel"));
+
+		kernel.addInput(createSource(input));
+		kernel.step(1, 1);
+		REQUIRE(kernel.getComponent("input").size() == size);
+		REQUIRE(kernel.getComponent("output") == expected);
+	}
+
+	SECTION("non-circular convolution zero pads the field")
+	{
+		kernel.setCircular(false);
+		REQUIRE_FALSE(kernel.getCircular());
+		const auto range = kernel.getKernelRange();
+		const std::vector<double> full = dnf_composer::mathtools::conv(input, kernel.getComponent("kernel"));
+
+		kernel.addInput(createSource(input));
+		kernel.step(1, 1);
+		const auto output = kernel.getComponent("output");
+		for (int i = 0; i < size; i++)
+			REQUIRE(std::abs(output[i] - full[i + range[0]]) < 1e-12);
+	}
+
+	SECTION("non-circular kernels with border compensation are not attenuated at the borders")
+	{
+		kernel.setCircular(false);
+		kernel.addInput(createSource(std::vector<double>(size, 1.0)));
+		kernel.step(1, 1);
+		const double interior = kernel.getComponent("output")[size / 2];
+		REQUIRE(kernel.getComponent("output")[0] < 0.6 * interior);
+
+		kernel.setBorderCompensation(true);
+		REQUIRE(kernel.getBorderCompensation());
+		kernel.step(1, 1);
+		for (const double value : kernel.getComponent("output"))
+			REQUIRE(std::abs(value - interior) < 1e-9);
+	}
+}
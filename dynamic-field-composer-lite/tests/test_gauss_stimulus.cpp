@@ -65,6 +65,22 @@ TEST_CASE("GaussStimulus class tests", "[GaussStimulus]")
         REQUIRE(gaussStimulus.getComponent("output")[2] == Catch::Approx(newAmplitude * dnf_composer::mathtools::circularGauss(size, newSigma, newPosition)[2]));
     }
 
+    SECTION("setPosition() and setAmplitude() methods")
+    {
+        dnf_composer::element::GaussStimulus gaussStimulus({ id, size }, gsp);
+        gaussStimulus.init();
+
+        gaussStimulus.setPosition(1.5);
+        gaussStimulus.setAmplitude(3.0);
+        REQUIRE(gaussStimulus.getParameters().position == 1.5);
+        REQUIRE(gaussStimulus.getParameters().amplitude == 3.0);
+        for (int i = 0; i < size; i++)
+            REQUIRE(gaussStimulus.getComponent("output")[i] == Catch::Approx(3.0 * dnf_composer::mathtools::circularGauss(size, sigma, 1.5)[i]));
+
+        REQUIRE_THROWS_AS(gaussStimulus.setPosition(size), dnf_composer::Exception);
+        REQUIRE(gaussStimulus.getParameters().position == 1.5);
+    }
+
     SECTION("init() step() close() methods")
     {
         dnf_composer::element::GaussStimulus gaussStimulus({ id, size }, gsp);
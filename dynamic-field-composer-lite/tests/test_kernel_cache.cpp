@@ -0,0 +1,132 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <sstream>
+
+#include "elements/gauss_kernel.h"
+#include "elements/mexican_hat_kernel.h"
+
+using namespace dnf_composer::element;
+
+TEST_CASE("KernelCache shares kernel data", "[KernelCache]")
+{
+	GaussKernelParameters params;
+	params.sigma = 3.0;
+	params.amplitude = 2.5;
+
+	SECTION("kernels with equal parameters share their data")
+	{
+		GaussKernel first({ "first", 60 }, params);
+		GaussKernel second({ "second", 60 }, params);
+		first.init();
+		second.init();
+
+		REQUIRE(first.getKernelData() != nullptr);
+		REQUIRE(first.getKernelData() == second.getKernelData());
+		REQUIRE(first.getComponent("kernel") == second.getComponent("kernel"));
+	}
+
+	SECTION("different parameters, sizes or labels get their own data")
+	{
+		GaussKernel reference({ "reference", 60 }, params);
+		GaussKernelParameters wider = params;
+		wider.sigma = 4.0;
+		GaussKernel widerKernel({ "wider", 60 }, wider);
+		GaussKernel largerKernel({ "larger", 80 }, params);
+		MexicanHatKernelParameters hatParams;
+		MexicanHatKernel hatKernel({ "hat", 60 }, hatParams);
+		reference.init();
+		widerKernel.init();
+		largerKernel.init();
+		hatKernel.init();
+
+		REQUIRE(reference.getKernelData() != widerKernel.getKernelData());
+		REQUIRE(reference.getKernelData() != largerKernel.getKernelData());
+		REQUIRE(reference.getKernelData() != hatKernel.getKernelData());
+	}
+
+	SECTION("a clone shares the data of its original")
+	{
+		GaussKernel original({ "original", 60 }, params);
+		original.init();
+		const auto clone = std::dynamic_pointer_cast<GaussKernel>(original.clone());
+		REQUIRE(clone != nullptr);
+		clone->init();
+
+		REQUIRE(clone->getKernelData() == original.getKernelData());
+	}
+
+	SECTION("the kernel component is only copied from the shared data once requested")
+	{
+		GaussKernel kernel({ "kernel", 60 }, params);
+		kernel.init();
+		std::ostringstream unrequestedState;
+		kernel.writeState(unrequestedState);
+
+		const std::vector<double>* weights = kernel.getComponentPtr("kernel");
+		REQUIRE(*weights == kernel.getKernelData()->weights);
+		std::ostringstream requestedState;
+		kernel.writeState(requestedState);
+		REQUIRE(requestedState.str().size() == unrequestedState.str().size() + weights->size() * sizeof(double));
+
+		// the requested component follows the shared data when the parameters change
+		GaussKernelParameters wider = params;
+		wider.sigma = 4.0;
+		kernel.setParameters(wider);
+		REQUIRE(*weights == kernel.getKernelData()->weights);
+	}
+
+	SECTION("cached data produces the same convolution as freshly built data")
+	{
+		GaussKernel first({ "first", 60 }, params);
+		GaussKernel second({ "second", 60 }, params);
+		first.init();
+		second.init();
+		for (int i = 0; i < 60; i++)
+		{
+			first.getComponentPtr("input")->at(i) = i % 7 == 0 ? 1.0 : 0.0;
+			second.getComponentPtr("input")->at(i) = i % 7 == 0 ? 1.0 : 0.0;
+		}
+		first.step(0, 1);
+		second.step(0, 1);
+
+		REQUIRE(first.getComponent("output") == second.getComponent("output"));
+	}
+
+	SECTION("entries expire with the last kernel that uses them")
+	{
+		GaussKernelParameters unique = params;
+		unique.sigma = 7.25;
+		const size_t entriesBefore = KernelCache::getNumberOfEntries();
+		{
+			GaussKernel kernel({ "kernel", 60 }, unique);
+			kernel.init();
+			REQUIRE(KernelCache::getNumberOfEntries() == entriesBefore + 1);
+		}
+		REQUIRE(KernelCache::getNumberOfEntries() == entriesBefore);
+	}
+
+	SECTION("data is built outside the cache and the first stored wins")
+	{
+		KernelCacheKey outerKey;
+		outerKey.label = GAUSS_KERNEL;
+		outerKey.parameters = { 11.5 };
+		outerKey.size = 10;
+		KernelCacheKey innerKey = outerKey;
+		innerKey.parameters = { 12.5 };
+
+		std::shared_ptr<const KernelData> inner;
+		std::shared_ptr<const KernelData> racing;
+		const auto outer = KernelCache::get(outerKey, [&]
+		{
+			// a build that uses the cache itself, as a racing kernel on another thread would
+			inner = KernelCache::get(innerKey, [] { return KernelData{ { 1, 1 }, { 1.0 }, {} }; });
+			racing = KernelCache::get(outerKey, [] { return KernelData{ { 2, 2 }, { 2.0 }, {} }; });
+			return KernelData{ { 3, 3 }, { 3.0 }, {} };
+		});
+
+		REQUIRE(inner != nullptr);
+		REQUIRE(outer == racing);
+		REQUIRE(outer->weights == std::vector<double>{ 2.0 });
+		REQUIRE(KernelCache::get(innerKey, [] { return KernelData{}; }) == inner);
+	}
+}
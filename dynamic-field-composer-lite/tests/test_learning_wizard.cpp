@@ -1,9 +1,12 @@
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+#include <fstream>
 
 #include "wizards/learning_wizard.h"
 #include "elements/neural_field.h"
 #include "elements/gauss_stimulus.h"
 #include "elements/field_coupling.h"
+#include "elements/gauss_kernel.h"
 #include "simulation/simulation.h"
 
 using namespace dnf_composer;
@@ -52,4 +55,150 @@ TEST_CASE("LearningWizard Data Path", "[LearningWizard]") {
     //    REQUIRE(learningWizard.getPathToFieldActivationPre() == "./new_output/TestFieldCoupling_TestNeuralField_pre.txt");
     //    REQUIRE(learningWizard.getPathToFieldActivationPost() == "./new_output/TestFieldCoupling_TestNeuralField_post.txt");
     //}
-}
\ No newline at end of file
+}
+static std::shared_ptr<Simulation> createAssociationSimulation()
+{
+    auto simulation = std::make_shared<Simulation>(5, 0, 0);
+    const element::HeavisideFunction activationFunction{ 0 };
+
+    const auto fieldPre = std::make_shared<element::NeuralField>(element::ElementCommonParameters{ "wizard field pre", 40 }, element::NeuralFieldParameters{ 20, -5, activationFunction });
+    const auto fieldPost = std::make_shared<element::NeuralField>(element::ElementCommonParameters{ "wizard field post", 40 }, element::NeuralFieldParameters{ 20, -5, activationFunction });
+    const auto kernelPre = std::make_shared<element::GaussKernel>(element::ElementCommonParameters{ "wizard kernel pre", 40 }, element::GaussKernelParameters{ 3, 20, -0.5 });
+    const auto kernelPost = std::make_shared<element::GaussKernel>(element::ElementCommonParameters{ "wizard kernel post", 40 }, element::GaussKernelParameters{ 3, 10, -0.5 });
+
+    element::FieldCouplingParameters fcp{ 40, 1.0, 0.01, LearningRule::DELTA_WIDROW_HOFF };
+    const auto coupling = std::make_shared<element::FieldCoupling>(element::ElementCommonParameters{ "wizard coupling", 40 }, fcp);
+
+    simulation->addElement(fieldPre);
+    simulation->addElement(fieldPost);
+    simulation->addElement(kernelPre);
+    simulation->addElement(kernelPost);
+    simulation->addElement(coupling);
+
+    fieldPre->addInput(kernelPre);
+    kernelPre->addInput(fieldPre);
+    fieldPost->addInput(kernelPost);
+    kernelPost->addInput(fieldPost);
+    coupling->addInput(fieldPre, "activation");
+    fieldPost->addInput(coupling);
+
+    return simulation;
+}
+
+TEST_CASE("LearningWizard Training Data", "[LearningWizard]") {
+    const auto simulation = createAssociationSimulation();
+    LearningWizard learningWizard(simulation, "wizard coupling");
+    learningWizard.clearTargetPeakLocationsFromFiles();
+
+    learningWizard.setGaussStimulusParameters({ 2, 10, 0 });
+    learningWizard.setTargetPeakLocationsForNeuralFieldPre({ { 10 }, { 30 } });
+    learningWizard.setTargetPeakLocationsForNeuralFieldPost({ { 8 }, { 22 } });
+    learningWizard.simulateAssociation();
+
+    const TrainingData& trainingData = learningWizard.getTrainingData();
+
+    SECTION("Patterns are stored contiguously, one row per target pair")
+    {
+        REQUIRE(trainingData.getNumberOfPatterns() == 2);
+        REQUIRE(trainingData.inputSize == 40);
+        REQUIRE(trainingData.outputSize == 40);
+        REQUIRE(trainingData.inputPatterns.size() == 2 * 40);
+        REQUIRE(trainingData.outputPatterns.size() == 2 * 40);
+
+        // the input field holds a self-sustained peak after its stimulus is removed
+        const auto firstInput = trainingData.inputPatterns.begin();
+        REQUIRE(*std::max_element(firstInput, firstInput + 40) > 0.0);
+
+        // the output pattern of the first pair peaks around its target
+        const auto firstOutput = trainingData.outputPatterns.begin();
+        const auto peak = std::max_element(firstOutput, firstOutput + 40) - firstOutput;
+        REQUIRE(std::abs(static_cast<int>(peak) + 1 - 8) <= 2);
+    }
+
+    SECTION("Training data survives a binary round trip")
+    {
+        const TrainingData saved = trainingData;
+        REQUIRE(learningWizard.saveTrainingData());
+        REQUIRE(learningWizard.loadTrainingData());
+        REQUIRE(learningWizard.getTrainingData().getNumberOfPatterns() == saved.getNumberOfPatterns());
+        REQUIRE(learningWizard.getTrainingData().inputPatterns == saved.inputPatterns);
+        REQUIRE(learningWizard.getTrainingData().outputPatterns == saved.outputPatterns);
+    }
+
+    SECTION("Training data whose header does not match the file is rejected")
+    {
+        const TrainingData saved = trainingData;
+        learningWizard.setDataFilePath(std::string(OUTPUT_DIRECTORY));
+        REQUIRE(learningWizard.saveTrainingData());
+        const std::string path = std::string(OUTPUT_DIRECTORY) + "/wizard coupling_wizard field pre_wizard field post_training_data.bin";
+
+        // claims far more patterns than the file holds
+        {
+            std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+            const int32_t numberOfPatterns = 1 << 30;
+            file.seekp(2 * sizeof(int32_t));
+            file.write(reinterpret_cast<const char*>(&numberOfPatterns), sizeof(numberOfPatterns));
+        }
+        REQUIRE_FALSE(learningWizard.loadTrainingData());
+        REQUIRE(learningWizard.getTrainingData().inputPatterns == saved.inputPatterns);
+
+        // holds a pattern more than the header claims
+        REQUIRE(learningWizard.saveTrainingData());
+        {
+            std::ofstream file(path, std::ios::binary | std::ios::app);
+            const std::vector<double> extraPattern(80, 0.0);
+            file.write(reinterpret_cast<const char*>(extraPattern.data()), static_cast<std::streamsize>(extraPattern.size() * sizeof(double)));
+        }
+        REQUIRE_FALSE(learningWizard.loadTrainingData());
+        REQUIRE(learningWizard.getTrainingData().getNumberOfPatterns() == saved.getNumberOfPatterns());
+    }
+
+    SECTION("Training reads the patterns from memory")
+    {
+        learningWizard.trainWeights(20);
+        const auto fieldCoupling = std::dynamic_pointer_cast<element::FieldCoupling>(simulation->getElement("wizard coupling"));
+        double sum = 0.0;
+        for (const auto& row : fieldCoupling->getWeights())
+            for (const double value : row)
+                sum += std::abs(value);
+        REQUIRE(sum > 0.0);
+    }
+
+    learningWizard.clearTargetPeakLocationsFromFiles();
+}
+
+TEST_CASE("LearningWizard Steady State Settling", "[LearningWizard]") {
+    const auto simulation = createAssociationSimulation();
+    LearningWizard learningWizard(simulation, "wizard coupling");
+    learningWizard.clearTargetPeakLocationsFromFiles();
+
+    learningWizard.setGaussStimulusParameters({ 2, 10, 0 });
+    learningWizard.setTargetPeakLocationsForNeuralFieldPre({ { 10 }, { 30 } });
+    learningWizard.setTargetPeakLocationsForNeuralFieldPost({ { 8 }, { 22 } });
+    learningWizard.simulateAssociation();
+    const TrainingData stepped = learningWizard.getTrainingData();
+
+    learningWizard.setSteadyStateSolver(true);
+    learningWizard.simulateAssociation();
+    const TrainingData solved = learningWizard.getTrainingData();
+
+    // the second run appends its patterns, both settling methods end in the same attractors
+    // (with a Heaviside output the fixed points only agree up to the cells at the edge of a peak)
+    REQUIRE(solved.getNumberOfPatterns() == 2 * stepped.getNumberOfPatterns());
+    for (size_t pattern = 0; pattern < stepped.getNumberOfPatterns(); pattern++)
+    {
+        const auto steppedInput = stepped.inputPatterns.begin() + pattern * 40;
+        const auto solvedInput = solved.inputPatterns.begin() + (pattern + 2) * 40;
+        const auto steppedOutput = stepped.outputPatterns.begin() + pattern * 40;
+        const auto solvedOutput = solved.outputPatterns.begin() + (pattern + 2) * 40;
+        REQUIRE(std::max_element(solvedInput, solvedInput + 40) - solvedInput == std::max_element(steppedInput, steppedInput + 40) - steppedInput);
+        REQUIRE(std::max_element(solvedOutput, solvedOutput + 40) - solvedOutput == std::max_element(steppedOutput, steppedOutput + 40) - steppedOutput);
+        for (int i = 0; i < 40; i++)
+        {
+            REQUIRE(solvedInput[i] == Catch::Approx(steppedInput[i]).margin(0.2));
+            REQUIRE(solvedOutput[i] == Catch::Approx(steppedOutput[i]).margin(0.2));
+        }
+    }
+
+    learningWizard.clearTargetPeakLocationsFromFiles();
+}
@@ -0,0 +1,130 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "logging/logger.h"
+
+using namespace dnf_composer;
+
+// Redirects the console output of the sink thread while alive, flushing so no earlier message ends up in it.
+class ConsoleCapture
+{
+private:
+    std::ostringstream stream;
+    std::streambuf* previousBuffer;
+public:
+    ConsoleCapture()
+    {
+        Logger::flush();
+        previousBuffer = std::cout.rdbuf(stream.rdbuf());
+    }
+
+    ConsoleCapture(const ConsoleCapture&) = delete;
+    ConsoleCapture& operator=(const ConsoleCapture&) = delete;
+
+    std::string text() const
+    {
+        return stream.str();
+    }
+
+    ~ConsoleCapture()
+    {
+        Logger::flush();
+        std::cout.rdbuf(previousBuffer);
+    }
+};
+
+TEST_CASE("Logger", "[Logger]")
+{
+    SECTION("Messages of several producers are all written, each producer in order")
+    {
+        constexpr int numberOfProducers = 4;
+        constexpr int messagesPerProducer = 2000;
+        ConsoleCapture capture;
+
+        std::vector<std::thread> producers;
+        for (int p = 0; p < numberOfProducers; p++)
+            producers.emplace_back([p]
+                {
+                    for (int i = 0; i < messagesPerProducer; i++)
+                        Logger::log(LogLevel::INFO, "producer " + std::to_string(p) + " message " + std::to_string(i) + "\n", LogOutputMode::CONSOLE);
+                });
+        for (auto& producer : producers)
+            producer.join();
+        Logger::flush();
+
+        std::vector<int> nextMessage(numberOfProducers, 0);
+        int messagesOutOfOrder = 0;
+        std::istringstream lines(capture.text());
+        std::string line;
+        while (std::getline(lines, line))
+        {
+            const size_t start = line.find("producer ");
+            if (start == std::string::npos)
+                continue;
+            int p = -1;
+            int i = -1;
+            std::istringstream fields(line.substr(start + 9));
+            std::string word;
+            fields >> p >> word >> i;
+            if (p < 0 || p >= numberOfProducers || i != nextMessage[p])
+                messagesOutOfOrder++;
+            else
+                nextMessage[p]++;
+        }
+        REQUIRE(messagesOutOfOrder == 0);
+        REQUIRE(nextMessage == std::vector<int>(numberOfProducers, messagesPerProducer));
+    }
+
+    SECTION("flush() returns once every earlier message is written")
+    {
+        ConsoleCapture capture;
+        for (int i = 0; i < 100; i++)
+            Logger::log(LogLevel::INFO, "flushed message " + std::to_string(i) + "\n", LogOutputMode::CONSOLE);
+        Logger::flush();
+        REQUIRE(capture.text().find("flushed message 99") != std::string::npos);
+    }
+
+    SECTION("Repetitions of a message are collapsed into one summary line")
+    {
+        constexpr int repetitions = 50;
+        ConsoleCapture capture;
+        for (int i = 0; i < repetitions; i++)
+            Logger::log(LogLevel::INFO, "repeated message\n", LogOutputMode::CONSOLE);
+        Logger::log(LogLevel::INFO, "different message\n", LogOutputMode::CONSOLE);
+        Logger::flush();
+
+        const std::string text = capture.text();
+        size_t written = 0;
+        for (size_t start = text.find("repeated message"); start != std::string::npos; start = text.find("repeated message", start + 1))
+            written++;
+        REQUIRE(written == 1);
+        const size_t summary = text.find("Previous message repeated " + std::to_string(repetitions - 1) + " times.");
+        REQUIRE(summary != std::string::npos);
+        REQUIRE(summary < text.find("different message"));
+    }
+
+    SECTION("Messages below the minimum level are not written")
+    {
+        const LogLevel previousLevel = Logger::getMinimumLevel();
+        Logger::setMinimumLevel(LogLevel::WARNING);
+        REQUIRE(Logger::getMinimumLevel() == LogLevel::WARNING);
+        REQUIRE_FALSE(isLogLevelEnabled(LogLevel::INFO));
+        REQUIRE(isLogLevelEnabled(LogLevel::ERROR));
+
+        std::string text;
+        {
+            ConsoleCapture capture;
+            log(LogLevel::INFO, "filtered message\n", LogOutputMode::CONSOLE);
+            log(LogLevel::WARNING, "kept message\n", LogOutputMode::CONSOLE);
+            Logger::flush();
+            text = capture.text();
+        }
+        Logger::setMinimumLevel(previousLevel);
+
+        REQUIRE(text.find("filtered message") == std::string::npos);
+        REQUIRE(text.find("kept message") != std::string::npos);
+    }
+}
@@ -0,0 +1,77 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+
+#include "mathtools/mathtools.h"
+
+TEST_CASE("Mathtools expressions", "[mathtools]")
+{
+    using namespace dnf_composer::mathtools;
+
+    SECTION("Functions match the elementwise loops they replace")
+    {
+        std::vector<int> rangeX(41);
+        std::iota(rangeX.begin(), rangeX.end(), -20);
+        const std::vector<double> g = gauss(rangeX, 1.5, 4.0);
+        const std::vector<double> normalized = gaussNorm(rangeX, 1.5, 4.0);
+        const double sumOfG = std::reduce(g.begin(), g.end());
+        REQUIRE(g.size() == rangeX.size());
+        for (size_t i = 0; i < rangeX.size(); i++)
+        {
+            REQUIRE(g[i] == exp(-0.5 * pow((rangeX[i] - 1.5), 2) / pow(4.0, 2)));
+            REQUIRE(normalized[i] == g[i] / sumOfG);
+        }
+
+        constexpr uint32_t size = 50;
+        const std::vector<double> circular = circularGauss(size, 3.0, 47.5);
+        REQUIRE(circular.size() == size);
+        for (uint32_t i = 0; i < size; i++)
+        {
+            const double d = std::abs((i + 1.0) - 47.5);
+            REQUIRE(circular[i] == std::exp(-0.5 * std::pow(std::min(d, -1 * (d - size)), 2) / std::pow(3.0, 2)));
+        }
+        // the peak wraps around the ring
+        REQUIRE(circular[0] > circular[40]);
+
+        const std::vector<double> s = sigmoid(circular, 4.0, 0.5);
+        const std::vector<double> h = heaviside(circular, 0.5);
+        const std::vector<double> sum = sumGauss(circular, s);
+        for (uint32_t i = 0; i < size; i++)
+        {
+            REQUIRE(s[i] == 1 / (1 + exp(-4.0 * (circular[i] - 0.5))));
+            REQUIRE(h[i] == (circular[i] > 0.5 ? 1.0 : 0.0));
+            REQUIRE(sum[i] == circular[i] + s[i]);
+            // the pointwise forms used by the fused field steps agree with the vector forms
+            REQUIRE(SigmoidActivation<double>{ 4.0, 0.5 }(circular[i]) == s[i]);
+            REQUIRE(HeavisideActivation<double>{ 0.5 }(circular[i]) == h[i]);
+        }
+    }
+
+    SECTION("Compositions are evaluated lazily in a single pass")
+    {
+        using namespace expressions;
+        const std::vector<double> a = { 1.0, -2.0, 3.0, -4.0 };
+        const std::vector<double> b = { 0.5, 0.25, 2.0, 8.0 };
+
+        int calls = 0;
+        const auto counted = apply(view(a), [&calls](double x) { calls++; return x; });
+        const auto expression = 2.0 * abs(counted) - view(b) / 2.0 + 1.0;
+        REQUIRE(calls == 0);
+        REQUIRE(expression.size() == a.size());
+
+        std::vector<double> output;
+        evaluate(expression, output);
+        REQUIRE(calls == 4);
+        REQUIRE(output == std::vector<double>{ 2.75, 4.875, 6.0, 5.0 });
+        REQUIRE(sum<double>(expression) == Catch::Approx(18.625));
+
+        // the output can be one of the operands
+        std::vector<double> values = a;
+        evaluate(-view(values) * view(values), values);
+        REQUIRE(values == std::vector<double>{ -1.0, -4.0, -9.0, -16.0 });
+        // also when the output gets the size of an expression over a part of it
+        evaluate(View<double>{ {}, values.data(), 2 } * 2.0, values);
+        REQUIRE(values == std::vector<double>{ -2.0, -8.0 });
+        REQUIRE(materialize<double>(min(indices(0.0, 4), 2.5)) == std::vector<double>{ 0.0, 1.0, 2.0, 2.5 });
+        REQUIRE(materialize<double>(pow(indices(1.0, 3), 2)) == std::vector<double>{ 1.0, 4.0, 9.0 });
+    }
+}
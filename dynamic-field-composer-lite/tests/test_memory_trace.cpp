@@ -0,0 +1,103 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+
+#include <sstream>
+#include <limits>
+
+#include "elements/memory_trace.h"
+#include "elements/gauss_stimulus.h"
+
+// Dense form of the memory trace step, every bin updated
+static void referenceStep(std::vector<double>& trace, const std::vector<double>& input, const dnf_composer::element::MemoryTraceParameters& parameters, double deltaT)
+{
+	if (std::ranges::none_of(input, [&](double value) { return value > parameters.threshold; }))
+		return;
+	for (size_t i = 0; i < trace.size(); i++)
+	{
+		if (input[i] > parameters.threshold)
+			trace[i] += deltaT / parameters.tauBuild * (1.0 - trace[i]);
+		else if (trace[i] != 0.0)
+		{
+			trace[i] -= deltaT / parameters.tauDecay * trace[i];
+			if (std::abs(trace[i]) < 1e-9)
+				trace[i] = 0.0;
+		}
+	}
+}
+
+TEST_CASE("MemoryTrace class tests", "[MemoryTrace]")
+{
+	using namespace dnf_composer::element;
+	constexpr int size = 100;
+	const MemoryTraceParameters params{ 10.0, 50.0, 0.5 };
+
+	SECTION("MemoryTrace constructor and getParameters method")
+	{
+		MemoryTrace trace({ "trace", size }, params);
+		REQUIRE(trace.getLabel() == ElementLabel::MEMORY_TRACE);
+		REQUIRE(trace.getSize() == size);
+		REQUIRE(trace.getParameters() == params);
+		REQUIRE_THROWS(MemoryTrace({ "invalid", size }, MemoryTraceParameters{ 0.0, 50.0, 0.5 }));
+		REQUIRE_THROWS(MemoryTrace({ "invalid", size }, MemoryTraceParameters{ 10.0, 50.0, std::nan("") }));
+
+		// rejected the same way after construction, the previous parameters are kept
+		trace.setParameters({ 10.0, 50.0, std::numeric_limits<double>::infinity() });
+		REQUIRE(trace.getParameters() == params);
+	}
+
+	SECTION("Builds up where the input is active and decays elsewhere")
+	{
+		const auto stimulus = std::make_shared<GaussStimulus>(ElementCommonParameters{ "stimulus", size }, GaussStimulusParameters{ 3, 1, 30 });
+		const auto trace = std::make_shared<MemoryTrace>(ElementCommonParameters{ "trace", size }, params);
+		trace->addInput(stimulus);
+		stimulus->init();
+		trace->init();
+
+		std::vector<double> expected(size, 0.0);
+		for (int step = 0; step < 200; step++)
+		{
+			// the stimulus jumps between two positions, so the first trace decays while the second builds
+			if (step == 100)
+				stimulus->setParameters({ 3, 1, 70 });
+			trace->step(step, 1.0);
+			referenceStep(expected, stimulus->getComponent("output"), params, 1.0);
+			REQUIRE(trace->getComponent("output") == expected);
+		}
+		REQUIRE(trace->getComponent("output")[30] > 0.0);
+		REQUIRE(trace->getComponent("output")[30] < trace->getComponent("output")[70]);
+		// only the bins that were ever active carry a trace
+		REQUIRE(trace->getNumberOfTraceBins() == std::ranges::count_if(expected, [](double value) { return value != 0.0; }));
+		REQUIRE(trace->getNumberOfTraceBins() < size / 4);
+
+		// without active bins the trace is kept
+		stimulus->setParameters({ 3, 0.1, 70 });
+		const std::vector<double> kept = trace->getComponent("output");
+		trace->step(200, 1.0);
+		REQUIRE(trace->getComponent("output") == kept);
+	}
+
+	SECTION("Checkpoint restores the sparse trace")
+	{
+		const auto stimulus = std::make_shared<GaussStimulus>(ElementCommonParameters{ "stimulus", size }, GaussStimulusParameters{ 3, 1, 30 });
+		const auto trace = std::make_shared<MemoryTrace>(ElementCommonParameters{ "trace", size }, params);
+		trace->addInput(stimulus);
+		stimulus->init();
+		trace->init();
+		for (int step = 0; step < 20; step++)
+			trace->step(step, 1.0);
+
+		std::stringstream state;
+		trace->writeState(state);
+		const auto restored = std::make_shared<MemoryTrace>(ElementCommonParameters{ "restored", size }, MemoryTraceParameters{});
+		restored->readState(state);
+		REQUIRE(state.good());
+		REQUIRE(restored->getParameters() == params);
+		REQUIRE(restored->getNumberOfTraceBins() == trace->getNumberOfTraceBins());
+
+		restored->addInput(stimulus);
+		stimulus->setParameters({ 3, 1, 60 });
+		trace->step(20, 1.0);
+		restored->step(20, 1.0);
+		REQUIRE(restored->getComponent("output") == trace->getComponent("output"));
+	}
+}
@@ -1,6 +1,7 @@
 #include <catch2/catch_test_macros.hpp>
 
 #include "elements/mexican_hat_kernel.h"
+#include "elements/gauss_stimulus.h"
 
 TEST_CASE("MexicanHatKernel class tests", "[MexicanHatKernel]")
 {
@@ -41,4 +42,33 @@ TEST_CASE("MexicanHatKernel class tests", "[MexicanHatKernel]")
 		kernel.setParameters(params);
 		REQUIRE(kernel.getParameters() == params);
     }
-}
\ No newline at end of file
+}
+
+TEST_CASE("MexicanHatKernel recursive convolution", "[MexicanHatKernel]")
+{
+    using namespace dnf_composer::element;
+    constexpr int size = 300;
+    const auto stimulus = std::make_shared<GaussStimulus>(ElementCommonParameters{ "stimulus", size }, GaussStimulusParameters{ 3, 1, 100 });
+    stimulus->init();
+
+    const MexicanHatKernelParameters params{ 5, 10, 20, 5, 0 };
+    MexicanHatKernel direct({ "direct", size }, params);
+    MexicanHatKernel recursive({ "recursive", size }, params);
+    recursive.setConvolutionMethod(ConvolutionMethod::RECURSIVE);
+
+    for (MexicanHatKernel* kernel : { &direct, &recursive })
+    {
+        kernel->addInput(stimulus);
+        kernel->init();
+        kernel->step(1, 1);
+    }
+
+    // the truncated kernel spans the range of the widest Gaussian
+    REQUIRE(direct.getComponent("kernel").size() == 2 * 100 + 1);
+
+    const auto expected = direct.getComponent("output");
+    const auto approximated = recursive.getComponent("output");
+    const double peak = *std::ranges::max_element(expected);
+    for (int i = 0; i < size; i++)
+        REQUIRE(std::abs(approximated[i] - expected[i]) <= 0.036 * peak);
+}
@@ -0,0 +1,144 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+
+#include <numeric>
+
+#include "elements/moving_gauss_stimulus.h"
+#include "simulation/simulation.h"
+#include "mathtools/mathtools.h"
+
+// Largest difference between the stimulus output and amplitude * circularGauss at its current parameters
+static double maxDeviation(dnf_composer::element::MovingGaussStimulus& stimulus, int size)
+{
+	const std::vector<double> expected = dnf_composer::mathtools::circularGauss(size, stimulus.getSigma(), stimulus.getPosition());
+	const std::vector<double>& output = *stimulus.getComponentPtr("output");
+	double deviation = 0.0;
+	for (int i = 0; i < size; i++)
+		deviation = std::max(deviation, std::abs(output[i] - stimulus.getAmplitude() * expected[i]));
+	return deviation;
+}
+
+TEST_CASE("Trajectory class tests", "[Trajectory]")
+{
+	using namespace dnf_composer::element;
+
+	REQUIRE(Trajectory::constant(3.0).valueAt(100.0) == 3.0);
+	REQUIRE(Trajectory::constant(3.0).isConstant());
+
+	const Trajectory linear = Trajectory::piecewiseLinear({ { 0.0, 10.0 }, { 10.0, 30.0 }, { 20.0, 0.0 } });
+	REQUIRE(linear.valueAt(-5.0) == 10.0);
+	REQUIRE(linear.valueAt(5.0) == Catch::Approx(20.0));
+	REQUIRE(linear.valueAt(15.0) == Catch::Approx(15.0));
+	REQUIRE(linear.valueAt(25.0) == 0.0);
+	REQUIRE_FALSE(linear.isConstant());
+
+	const Trajectory sinusoidal = Trajectory::sinusoidal(50.0, 10.0, 40.0);
+	REQUIRE(sinusoidal.valueAt(0.0) == Catch::Approx(50.0));
+	REQUIRE(sinusoidal.valueAt(10.0) == Catch::Approx(60.0));
+	REQUIRE(sinusoidal.valueAt(30.0) == Catch::Approx(40.0));
+
+	const Trajectory sampled = Trajectory::sampled({ 1.0, 3.0, 2.0 }, 2.0, 10.0);
+	REQUIRE(sampled.valueAt(0.0) == 1.0);
+	REQUIRE(sampled.valueAt(11.0) == Catch::Approx(2.0));
+	REQUIRE(sampled.valueAt(13.0) == Catch::Approx(2.5));
+	REQUIRE(sampled.valueAt(20.0) == 2.0);
+
+	REQUIRE_THROWS(Trajectory::piecewiseLinear({ { 1.0, 0.0 }, { 1.0, 2.0 } }));
+	REQUIRE_THROWS(Trajectory::sinusoidal(0.0, 1.0, 0.0));
+	REQUIRE_THROWS(Trajectory::sampled({}, 1.0));
+}
+
+TEST_CASE("MovingGaussStimulus class tests", "[MovingGaussStimulus]")
+{
+	using namespace dnf_composer::element;
+	constexpr int size = 100;
+	constexpr double amplitude = 8.0;
+
+	SECTION("Follows its position with a cached profile")
+	{
+		// crosses the border of the circular field on the way
+		const MovingGaussStimulusParameters params{ Trajectory::piecewiseLinear({ { 0.0, 60.0 }, { 100.0, 140.0 } }),
+			Trajectory::constant(amplitude), Trajectory::constant(3.0) };
+		MovingGaussStimulus stimulus({ "stimulus", size }, params);
+		REQUIRE(stimulus.getLabel() == ElementLabel::MOVING_GAUSS_STIMULUS);
+		stimulus.init();
+		REQUIRE(stimulus.getPosition() == 60.0);
+		REQUIRE(maxDeviation(stimulus, size) < 1e-5 * amplitude);
+
+		for (int step = 1; step <= 100; step++)
+		{
+			stimulus.step(step, 1.0);
+			REQUIRE(stimulus.getPosition() == Catch::Approx(60.0 + 0.8 * step));
+			REQUIRE(maxDeviation(stimulus, size) < 1e-5 * amplitude);
+			// only the support window is written
+			const std::vector<double> output = stimulus.getComponent("output");
+			REQUIRE(std::ranges::count_if(output, [](double value) { return value != 0.0; }) <= 2 * 15 + 2);
+		}
+	}
+
+	SECTION("Evaluates a varying sigma directly")
+	{
+		const MovingGaussStimulusParameters params{ Trajectory::sinusoidal(50.0, 30.0, 50.0),
+			Trajectory::sampled({ 2.0, 8.0, 4.0 }, 20.0), Trajectory::piecewiseLinear({ { 0.0, 2.0 }, { 40.0, 6.0 } }) };
+		MovingGaussStimulus stimulus({ "stimulus", size }, params);
+		stimulus.init();
+		for (int step = 1; step <= 50; step++)
+		{
+			stimulus.step(step, 1.0);
+			REQUIRE(maxDeviation(stimulus, size) < 1e-5 * stimulus.getAmplitude());
+		}
+	}
+
+	SECTION("A support wider than the field covers the whole field")
+	{
+		constexpr int smallSize = 20;
+		const MovingGaussStimulusParameters params{ Trajectory::constant(4.5), Trajectory::constant(amplitude), Trajectory::constant(5.0) };
+		MovingGaussStimulus stimulus({ "stimulus", smallSize }, params);
+		stimulus.init();
+		REQUIRE(maxDeviation(stimulus, smallSize) < 1e-12);
+	}
+
+	SECTION("Non-circular stimuli are clipped at the borders")
+	{
+		const MovingGaussStimulusParameters params{ Trajectory::constant(2.25), Trajectory::constant(amplitude), Trajectory::constant(3.0), false };
+		MovingGaussStimulus stimulus({ "stimulus", size }, params);
+		stimulus.init();
+		std::vector<int> rangeX(size);
+		std::iota(rangeX.begin(), rangeX.end(), 1);
+		const std::vector<double> expected = dnf_composer::mathtools::gauss(rangeX, 2.25, 3.0);
+		const std::vector<double> output = stimulus.getComponent("output");
+		for (int i = 0; i < size; i++)
+			REQUIRE(output[i] == Catch::Approx(amplitude * expected[i]).margin(1e-5 * amplitude));
+		REQUIRE(output[size - 1] == 0.0);
+	}
+
+	SECTION("setParameters() re-renders at the last step")
+	{
+		MovingGaussStimulusParameters params{ Trajectory::constant(30.0), Trajectory::constant(amplitude), Trajectory::constant(3.0) };
+		MovingGaussStimulus stimulus({ "stimulus", size }, params);
+		stimulus.init();
+		stimulus.step(5.0, 1.0);
+		params.position = Trajectory::constant(70.0);
+		stimulus.setParameters(params);
+		REQUIRE(stimulus.getPosition() == 70.0);
+		REQUIRE(stimulus.getComponent("output")[29] == 0.0);
+		REQUIRE(maxDeviation(stimulus, size) < 1e-5 * amplitude);
+	}
+
+	SECTION("Renders at the time of the simulation it is initialized in")
+	{
+		const MovingGaussStimulusParameters params{ Trajectory::piecewiseLinear({ { 0.0, 20.0 }, { 100.0, 80.0 } }),
+			Trajectory::constant(amplitude), Trajectory::constant(3.0) };
+		const auto stimulus = std::make_shared<MovingGaussStimulus>(ElementCommonParameters{ "stimulus", size }, params);
+		dnf_composer::Simulation simulation(1.0, 10.0, 50.0);
+
+		// added to a running simulation, at its current time
+		simulation.addElement(stimulus);
+		REQUIRE(stimulus->getPosition() == Catch::Approx(50.0));
+		REQUIRE(maxDeviation(*stimulus, size) < 1e-5 * amplitude);
+
+		simulation.init();
+		REQUIRE(stimulus->getPosition() == Catch::Approx(26.0));
+		REQUIRE(maxDeviation(*stimulus, size) < 1e-5 * amplitude);
+	}
+}
@@ -3,6 +3,7 @@
 
 #include "elements/neural_field.h"
 #include "elements/activation_function.h"
+#include "elements/gauss_stimulus.h"
 
 TEST_CASE("NeuralField class tests", "[neural_field]")
 {
@@ -75,4 +76,71 @@ TEST_CASE("NeuralField class tests", "[neural_field]")
 
     }
 
-}
\ No newline at end of file
+}
+
+// Steps a fused and an unfused copy of the same field, driven by two stimuli, and checks that they stay identical.
+static void requireFusedStepMatches(const dnf_composer::element::ActivationFunction& activationFunction, double position)
+{
+    using namespace dnf_composer::element;
+    constexpr int size = 101;
+    const auto first = std::make_shared<GaussStimulus>(ElementCommonParameters{ "first", size }, GaussStimulusParameters{ 4, 9, position });
+    const auto second = std::make_shared<GaussStimulus>(ElementCommonParameters{ "second", size }, GaussStimulusParameters{ 2, 3, 50 });
+    first->init();
+    second->init();
+
+    NeuralField fused({ "fused", size }, { 10, -5, activationFunction });
+    NeuralField separate({ "separate", size }, { 10, -5, activationFunction });
+    separate.setFusedStep(false);
+    REQUIRE(fused.getFusedStep());
+    REQUIRE_FALSE(separate.getFusedStep());
+    for (NeuralField* field : { &fused, &separate })
+    {
+        field->addInput(first);
+        field->addInput(second);
+        field->init();
+    }
+
+    for (int i = 0; i < 40; i++)
+    {
+        fused.step(i, 1);
+        separate.step(i, 1);
+        REQUIRE(fused.getComponent("input") == separate.getComponent("input"));
+        REQUIRE(fused.getComponent("activation") == separate.getComponent("activation"));
+        REQUIRE(fused.getComponent("output") == separate.getComponent("output"));
+        REQUIRE(fused.getCentroid() == separate.getCentroid());
+        REQUIRE(fused.getMaxActivationChange() == separate.getMaxActivationChange());
+    }
+}
+
+struct ShiftedLinearFunction : public dnf_composer::element::ActivationFunction
+{
+    std::vector<double> operator()(const std::vector<double>& input) override
+    {
+        std::vector<double> output(input.size());
+        for (size_t i = 0; i < input.size(); i++)
+            output[i] = 0.5 * input[i] + 1.0;
+        return output;
+    }
+    std::unique_ptr<dnf_composer::element::ActivationFunction> clone() const override
+    {
+        return std::make_unique<ShiftedLinearFunction>(*this);
+    }
+};
+
+TEST_CASE("NeuralField fused step", "[neural_field]")
+{
+    SECTION("sigmoid field with a peak in the middle")
+    {
+        requireFusedStepMatches(dnf_composer::element::SigmoidFunction{ 0, 4 }, 30);
+    }
+
+    SECTION("heaviside field with a peak across the field limits")
+    {
+        requireFusedStepMatches(dnf_composer::element::HeavisideFunction{ 0 }, 1);
+    }
+
+    SECTION("custom activation functions take the separate passes")
+    {
+        requireFusedStepMatches(ShiftedLinearFunction{}, 70);
+    }
+}
@@ -0,0 +1,210 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include "simulation/shared_memory_publisher.h"
+#include "simulation/shared_memory_reader.h"
+#include "elements/external_input.h"
+
+// Simulation of two external inputs, stepping k sets every value of the first to k and of the second to -k.
+static std::shared_ptr<dnf_composer::Simulation> countingSimulation(int size)
+{
+	using namespace dnf_composer::element;
+	auto simulation = std::make_shared<dnf_composer::Simulation>(1.0);
+	simulation->addElement(std::make_shared<ExternalInput>(ElementCommonParameters{ "positive", size }, ExternalInputParameters{ ExternalInputPolicy::HOLD, 2 }));
+	simulation->addElement(std::make_shared<ExternalInput>(ElementCommonParameters{ "negative", size * 2 }, ExternalInputParameters{ ExternalInputPolicy::HOLD, 2 }));
+	simulation->init();
+	return simulation;
+}
+
+static void countingStep(const std::shared_ptr<dnf_composer::Simulation>& simulation, int k)
+{
+	for (const auto& [id, sign] : { std::pair{ "positive", 1.0 }, std::pair{ "negative", -1.0 } })
+	{
+		const auto externalInput = std::dynamic_pointer_cast<dnf_composer::element::ExternalInput>(simulation->getElement(id));
+		externalInput->publish(std::vector<double>(externalInput->getSize(), sign * k), k);
+	}
+	simulation->step();
+}
+
+static bool isConstant(const std::vector<double>& values, double value)
+{
+	return std::ranges::all_of(values, [value](double v) { return v == value; });
+}
+
+TEST_CASE("Shared memory publisher and reader", "[SharedMemoryPublisher]")
+{
+	using namespace dnf_composer;
+	constexpr int size = 50;
+	const std::string segmentName = "dnf_composer_test_" + std::to_string(
+#ifdef _WIN32
+		0
+#else
+		getpid()
+#endif
+	);
+	const auto simulation = countingSimulation(size);
+
+	SECTION("Only existing components are published")
+	{
+		SharedMemoryPublisher publisher(simulation, segmentName);
+		REQUIRE_FALSE(publisher.addComponent("missing", "output"));
+		REQUIRE_FALSE(publisher.addComponent("positive", "missing"));
+		REQUIRE_FALSE(publisher.open());
+		REQUIRE(publisher.addComponent("positive", "output"));
+		REQUIRE(publisher.open());
+		REQUIRE_FALSE(publisher.addComponent("negative", "output"));
+		REQUIRE_THROWS(SharedMemoryPublisher(simulation, ""));
+	}
+
+	SECTION("A segment in use is only replaced on request")
+	{
+		SharedMemoryPublisher first(simulation, segmentName);
+		REQUIRE(first.addComponent("positive", "output"));
+		REQUIRE(first.open());
+
+		SharedMemoryPublisher second(simulation, segmentName);
+		REQUIRE(second.addComponent("negative", "output"));
+		REQUIRE_FALSE(second.open());
+		REQUIRE(first.isOpen());
+		SharedMemoryReader reader;
+		REQUIRE(reader.open(segmentName));
+		REQUIRE(reader.getElementId(0) == "positive");
+
+#ifndef _WIN32
+		REQUIRE(second.open(true));
+		REQUIRE(reader.open(segmentName));
+		REQUIRE(reader.getElementId(0) == "negative");
+#endif
+	}
+
+	SECTION("A component that no longer fits its slot closes the segment")
+	{
+		SharedMemoryPublisher publisher(simulation, segmentName);
+		REQUIRE(publisher.addComponent("positive", "output"));
+		REQUIRE(publisher.open());
+		SharedMemoryReader reader;
+		REQUIRE(reader.open(segmentName));
+
+		countingStep(simulation, 1);
+		publisher.publish();
+		simulation->getComponentPtr("positive", "output")->resize(size * 2, 2.0);
+		publisher.publish();
+		REQUIRE_FALSE(publisher.isOpen());
+		REQUIRE_FALSE(reader.isPublisherOpen());
+
+		SharedMemoryFrame frame;
+		REQUIRE(reader.read(frame));
+		REQUIRE(frame.number == 1);
+		REQUIRE(frame.values[0].size() == size);
+		REQUIRE(isConstant(frame.values[0], 1.0));
+	}
+
+	SECTION("Removing or resetting a published element closes the segment")
+	{
+		for (const bool reset : { false, true })
+		{
+			const auto target = countingSimulation(size);
+			SharedMemoryPublisher publisher(target, segmentName);
+			REQUIRE(publisher.addComponent("positive", "output"));
+			REQUIRE(publisher.open());
+			if (reset)
+				target->resetElement("positive", std::make_shared<element::ExternalInput>(element::ElementCommonParameters{ "positive", size }, element::ExternalInputParameters{ element::ExternalInputPolicy::HOLD, 2 }));
+			else
+				target->removeElement("positive");
+			publisher.publish();
+			REQUIRE_FALSE(publisher.isOpen());
+		}
+	}
+
+	SECTION("Reader maps the published slots and follows the frames")
+	{
+		SharedMemoryReader reader;
+		REQUIRE_FALSE(reader.open(segmentName));
+
+		SharedMemoryPublisher publisher(simulation, segmentName);
+		REQUIRE(publisher.addComponent("positive", "output"));
+		REQUIRE(publisher.addComponent("negative", "output"));
+		REQUIRE(publisher.open());
+
+		REQUIRE(reader.open(segmentName));
+		REQUIRE(reader.isPublisherOpen());
+		REQUIRE(reader.getNumberOfComponents() == 2);
+		REQUIRE(reader.findComponent("negative", "output") == 1);
+		REQUIRE(reader.findComponent("negative", "input") == -1);
+		REQUIRE(reader.getElementId(0) == "positive");
+		REQUIRE(reader.getComponentSize(1) == size * 2);
+
+		SharedMemoryFrame frame;
+		REQUIRE_FALSE(reader.readNext(frame));
+		for (int k = 1; k <= 3; k++)
+		{
+			countingStep(simulation, k);
+			publisher.publish();
+		}
+		REQUIRE(reader.getPublishedFrames() == 3);
+		REQUIRE(reader.readNext(frame));
+		REQUIRE(frame.number == 3);
+		REQUIRE(frame.time == Catch::Approx(3.0));
+		REQUIRE(isConstant(frame.values[0], 3.0));
+		REQUIRE(isConstant(frame.values[1], -3.0));
+		REQUIRE(frame.values[1].size() == size * 2);
+		REQUIRE_FALSE(reader.readNext(frame));
+
+		publisher.close();
+		REQUIRE_FALSE(reader.isPublisherOpen());
+		REQUIRE(reader.read(frame));
+		REQUIRE(isConstant(frame.values[0], 3.0));
+	}
+
+#ifndef _WIN32
+	SECTION("Reader in another process never sees a partially written frame")
+	{
+		// large frames, so the reader often runs into one being written
+		constexpr int numberOfFrames = 5000;
+		const auto largeSimulation = countingSimulation(20000);
+		SharedMemoryPublisher publisher(largeSimulation, segmentName);
+		REQUIRE(publisher.addComponent("positive", "output"));
+		REQUIRE(publisher.addComponent("negative", "output"));
+		REQUIRE(publisher.open());
+
+		const pid_t child = fork();
+		REQUIRE(child >= 0);
+		if (child == 0)
+		{
+			// exit codes: 0 consistent frames up to the last one, 1 no segment, 2 torn frame, 3 frames out of order
+			SharedMemoryReader reader;
+			if (!reader.open(segmentName))
+				_exit(1);
+			SharedMemoryFrame frame;
+			uint64_t last = 0;
+			while (last < numberOfFrames && reader.isPublisherOpen())
+			{
+				if (!reader.readNext(frame))
+					continue;
+				const auto k = static_cast<double>(frame.number);
+				if (!isConstant(frame.values[0], k) || !isConstant(frame.values[1], -k) || frame.time != k)
+					_exit(2);
+				if (frame.number < last)
+					_exit(3);
+				last = frame.number;
+			}
+			_exit(reader.read(frame) && frame.number == numberOfFrames && isConstant(frame.values[0], numberOfFrames) ? 0 : 3);
+		}
+
+		for (int k = 1; k <= numberOfFrames; k++)
+		{
+			countingStep(largeSimulation, k);
+			publisher.publish();
+		}
+		int status = -1;
+		REQUIRE(waitpid(child, &status, 0) == child);
+		REQUIRE(WIFEXITED(status));
+		REQUIRE(WEXITSTATUS(status) == 0);
+	}
+#endif
+}
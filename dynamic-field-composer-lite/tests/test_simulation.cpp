@@ -4,6 +4,10 @@
 #include "elements/element.h"
 #include "simulation/simulation.h"
 #include "elements/neural_field.h"
+#include "elements/gauss_kernel.h"
+#include "elements/mexican_hat_kernel.h"
+#include "elements/gauss_stimulus.h"
+#include "elements/normal_noise.h"
 
 
 // Helper function to create a sample Element object for testing
@@ -254,3 +258,512 @@ TEST_CASE("Simulation class tests", "[simulation]")
         REQUIRE(sim.isInitialized() == true);
     }
 }
+
+static std::shared_ptr<dnf_composer::Simulation> createSettlingSimulation()
+{
+    using namespace dnf_composer::element;
+    auto simulation = std::make_shared<dnf_composer::Simulation>(1, 0, 0);
+
+    const auto field = createSampleElement("field");
+    const auto kernel = std::make_shared<GaussKernel>(ElementCommonParameters{ "kernel", 100 }, GaussKernelParameters{ 3, 15, -0.5 });
+    const auto stimulus = std::make_shared<GaussStimulus>(ElementCommonParameters{ "stimulus", 100 }, GaussStimulusParameters{ 3, 8, 40 });
+    const auto noise = std::make_shared<NormalNoise>(ElementCommonParameters{ "noise", 100 }, NormalNoiseParameters{ 0.2 });
+    noise->setSeed(7);
+
+    simulation->addElement(field);
+    simulation->addElement(kernel);
+    simulation->addElement(stimulus);
+    simulation->addElement(noise);
+    field->addInput(kernel);
+    field->addInput(stimulus);
+    field->addInput(noise);
+    kernel->addInput(field);
+    return simulation;
+}
+
+TEST_CASE("Simulation clone and checkpoint", "[simulation]")
+{
+    const auto simulation = createSettlingSimulation();
+    simulation->init();
+    for (int i = 0; i < 10; i++)
+        simulation->step();
+
+    SECTION("Clone is independent and evolves identically")
+    {
+        const auto clone = simulation->clone();
+        REQUIRE(clone != nullptr);
+        REQUIRE(clone->getNumberOfElements() == simulation->getNumberOfElements());
+        REQUIRE(clone->getElement("field") != simulation->getElement("field"));
+        REQUIRE(clone->getElement("field")->getInputs().size() == 3);
+        for (const auto& input : clone->getElement("field")->getInputs())
+            REQUIRE(input == clone->getElement(input->getUniqueName()));
+
+        for (int i = 0; i < 20; i++)
+        {
+            simulation->step();
+            clone->step();
+        }
+        REQUIRE(clone->t == Catch::Approx(simulation->t));
+        // inputs are summed in hash order, which may differ between the original and the clone
+        const auto cloneActivation = clone->getComponent("field", "activation");
+        const auto originalActivation = simulation->getComponent("field", "activation");
+        for (size_t i = 0; i < originalActivation.size(); i++)
+            REQUIRE(cloneActivation[i] == Catch::Approx(originalActivation[i]).margin(1e-9));
+
+        // stepping the clone leaves the original untouched
+        const auto activation = simulation->getComponent("field", "activation");
+        clone->step();
+        REQUIRE(simulation->getComponent("field", "activation") == activation);
+    }
+
+    SECTION("Checkpoint restores time, state and random sequence")
+    {
+        std::stringstream checkpoint;
+        REQUIRE(simulation->saveCheckpoint(checkpoint));
+        const double checkpointTime = simulation->t;
+
+        for (int i = 0; i < 20; i++)
+            simulation->step();
+        const auto activation = simulation->getComponent("field", "activation");
+
+        REQUIRE(simulation->loadCheckpoint(checkpoint));
+        REQUIRE(simulation->t == Catch::Approx(checkpointTime));
+        for (int i = 0; i < 20; i++)
+            simulation->step();
+        REQUIRE(simulation->getComponent("field", "activation") == activation);
+    }
+
+    SECTION("Checkpoint of a different architecture is rejected")
+    {
+        std::stringstream checkpoint;
+        REQUIRE(simulation->saveCheckpoint(checkpoint));
+
+        dnf_composer::Simulation other(1, 0, 0);
+        other.addElement(createSampleElement("another field"));
+        REQUIRE_FALSE(other.loadCheckpoint(checkpoint));
+    }
+}
+
+TEST_CASE("Simulation interaction edits", "[simulation]")
+{
+    const auto simulation = createSettlingSimulation();
+    const auto secondStimulus = std::make_shared<dnf_composer::element::GaussStimulus>(
+        dnf_composer::element::ElementCommonParameters{ "second stimulus", 100 }, dnf_composer::element::GaussStimulusParameters{ 3, 8, 70 });
+    simulation->addElement(secondStimulus);
+    simulation->init();
+
+    const auto field = simulation->getElement("field");
+    REQUIRE(field->hasInput("stimulus", "output"));
+
+    simulation->removeInteraction("stimulus", "field");
+    REQUIRE_FALSE(field->hasInput("stimulus", "output"));
+
+    simulation->createInteraction("stimulus", "output", "field");
+    simulation->retargetInteraction("stimulus", "output", "field", "kernel");
+    REQUIRE_FALSE(field->hasInput("stimulus", "output"));
+    REQUIRE(simulation->getElement("kernel")->hasInput("stimulus", "output"));
+
+    // editing interactions keeps the simulation state
+    simulation->step();
+    const double t = simulation->t;
+    simulation->createInteraction("second stimulus", "output", "field");
+    REQUIRE(simulation->t == t);
+    REQUIRE(simulation->isInitialized());
+
+    // the gain of an interaction survives retargeting
+    simulation->createInteraction("second stimulus", "output", "kernel", 0.5);
+    simulation->retargetInteraction("second stimulus", "output", "kernel", "stimulus");
+    const auto& connections = simulation->getElement("stimulus")->getInputConnections();
+    REQUIRE(connections.size() == 1);
+    REQUIRE(connections.front().gain == 0.5);
+}
+
+TEST_CASE("Simulation element registry", "[simulation]")
+{
+    dnf_composer::Simulation simulation(1, 0, 0);
+    const auto source = createSampleElement("source");
+    const auto first = createSampleElement("first");
+    const auto second = createSampleElement("second");
+    const auto third = createSampleElement("third");
+
+    const dnf_composer::ElementHandle sourceHandle = simulation.addElement(source);
+    simulation.addElement(first);
+    const dnf_composer::ElementHandle secondHandle = simulation.addElement(second);
+    simulation.addElement(third);
+    REQUIRE(sourceHandle.isValid());
+    REQUIRE_FALSE(simulation.addElement(createSampleElement("source")).isValid());
+    REQUIRE(simulation.getElementHandle("second") == secondHandle);
+    REQUIRE(simulation.getElement(secondHandle) == second);
+
+    third->addInput(source);
+    first->addInput(source);
+    const auto consumers = simulation.getElementsThatHaveSpecifiedElementAsInput("source");
+    REQUIRE(consumers.size() == 2);
+    REQUIRE(consumers[0] == first);
+    REQUIRE(consumers[1] == third);
+
+    SECTION("Removing an element invalidates its handle and disconnects its consumers")
+    {
+        simulation.removeElement(sourceHandle);
+        REQUIRE_FALSE(simulation.isValid(sourceHandle));
+        REQUIRE_THROWS_AS(simulation.getElement(sourceHandle), dnf_composer::Exception);
+        REQUIRE_THROWS_AS(simulation.getElement("source"), dnf_composer::Exception);
+        REQUIRE(first->getInputs().empty());
+        REQUIRE(third->getInputs().empty());
+        REQUIRE(source->getConsumers().empty());
+
+        // order of the remaining elements is kept
+        REQUIRE(simulation.getNumberOfElements() == 3);
+        REQUIRE(simulation.getElement(0) == first);
+        REQUIRE(simulation.getElement(2) == third);
+
+        // a reused slot does not revive the stale handle
+        const dnf_composer::ElementHandle newHandle = simulation.addElement(createSampleElement("source"));
+        REQUIRE(newHandle.slot == sourceHandle.slot);
+        REQUIRE_FALSE(simulation.isValid(sourceHandle));
+        REQUIRE(simulation.getElement(3)->getUniqueName() == "source");
+    }
+
+    SECTION("Indices skip the tombstones of removed elements")
+    {
+        simulation.removeElement("third");
+        simulation.removeElement("first");
+        REQUIRE(simulation.getNumberOfElements() == 2);
+        REQUIRE(simulation.getElement(0) == source);
+        REQUIRE(simulation.getElement(1) == second);
+        REQUIRE_THROWS_AS(simulation.getElement(2), dnf_composer::Exception);
+        REQUIRE_THROWS_AS(simulation.getElement(-1), dnf_composer::Exception);
+    }
+
+    SECTION("Resetting an element keeps its position")
+    {
+        const auto replacement = createSampleElement("replacement");
+        simulation.resetElement("second", replacement);
+        REQUIRE_FALSE(simulation.isValid(secondHandle));
+        REQUIRE(simulation.getElement(2) == replacement);
+        REQUIRE(simulation.getElement("replacement") == replacement);
+        REQUIRE_THROWS_AS(simulation.getElement("second"), dnf_composer::Exception);
+    }
+
+    SECTION("Removing and resetting by name free the slot of the element")
+    {
+        // the names resolve to the handles stored in the registry, which releasing the slot erases
+        simulation.resetElement("second", createSampleElement("replacement"));
+        REQUIRE(simulation.getElementHandle("replacement").slot == secondHandle.slot);
+        simulation.removeElement("source");
+        const dnf_composer::ElementHandle newHandle = simulation.addElement(createSampleElement("added"));
+        REQUIRE(newHandle.slot == sourceHandle.slot);
+        REQUIRE(newHandle.generation == sourceHandle.generation + 1);
+        REQUIRE(simulation.getElement(newHandle)->getUniqueName() == "added");
+    }
+}
+
+TEST_CASE("Simulation run until stable", "[simulation]")
+{
+    const auto simulation = createSettlingSimulation();
+    simulation->removeElement("noise");
+    simulation->init();
+
+    dnf_composer::StabilityCriteria criteria;
+    criteria.fields = { { "field", dnf_composer::StabilityMeasure::ACTIVATION_CHANGE, 1e-4 } };
+    criteria.consecutiveSteps = 5;
+    criteria.maxSteps = 2000;
+
+    const int steps = simulation->runUntilStable(criteria);
+    REQUIRE(steps > criteria.consecutiveSteps);
+    REQUIRE(steps < criteria.maxSteps);
+    REQUIRE(simulation->t == Catch::Approx(steps));
+
+    const auto field = std::dynamic_pointer_cast<dnf_composer::element::NeuralField>(simulation->getElement("field"));
+    REQUIRE(field->getMaxActivationChange() <= 1e-4);
+    const auto activation = field->getComponent("activation");
+    simulation->step();
+    for (size_t i = 0; i < activation.size(); i++)
+        REQUIRE(field->getComponent("activation")[i] == Catch::Approx(activation[i]).margin(1e-4));
+
+    // an already stable simulation only needs the confirmation steps
+    criteria.fields = { { "field", dnf_composer::StabilityMeasure::CENTROID_CHANGE, 1e-3 } };
+    REQUIRE(simulation->runUntilStable(criteria) == criteria.consecutiveSteps);
+
+    // a criterion that cannot be met stops at maxSteps
+    criteria.fields = { { "field", dnf_composer::StabilityMeasure::ACTIVATION_CHANGE, -1.0 } };
+    criteria.maxSteps = 20;
+    REQUIRE(simulation->runUntilStable(criteria) == 20);
+
+    REQUIRE_THROWS_AS(simulation->runUntilStable({ {}, 1e-3, 0, 10 }), dnf_composer::Exception);
+}
+
+// A bank of fields, each with its own lateral kernel. With fieldsFirst all fields precede all kernels in the
+// step order, otherwise every field is directly followed by its kernel.
+static std::shared_ptr<dnf_composer::Simulation> createFieldBank(int numberOfFields, bool fieldsFirst)
+{
+    using namespace dnf_composer::element;
+    auto simulation = std::make_shared<dnf_composer::Simulation>(1, 0, 0);
+
+    std::vector<std::shared_ptr<NeuralField>> fields;
+    std::vector<std::shared_ptr<Kernel>> kernels;
+    for (int i = 0; i < numberOfFields; i++)
+    {
+        fields.push_back(createSampleElement("field " + std::to_string(i)));
+        if (i % 2 == 0)
+            kernels.push_back(std::make_shared<GaussKernel>(ElementCommonParameters{ "kernel " + std::to_string(i), 100 }, GaussKernelParameters{ 3, 15, -0.5 }));
+        else
+            kernels.push_back(std::make_shared<MexicanHatKernel>(ElementCommonParameters{ "kernel " + std::to_string(i), 100 }, MexicanHatKernelParameters{ 4, 20, 10, 12, -0.2 }));
+    }
+    for (int i = 0; i < numberOfFields; i++)
+    {
+        simulation->addElement(fields[i]);
+        if (!fieldsFirst)
+            simulation->addElement(kernels[i]);
+    }
+    if (fieldsFirst)
+        for (const auto& kernel : kernels)
+            simulation->addElement(kernel);
+
+    for (int i = 0; i < numberOfFields; i++)
+    {
+        const std::string stimulusId = "stimulus " + std::to_string(i);
+        simulation->addElement(std::make_shared<GaussStimulus>(ElementCommonParameters{ stimulusId, 100 }, GaussStimulusParameters{ 3, 8, 10.0 + 9.0 * i }));
+        simulation->createInteraction(stimulusId, "output", fields[i]->getUniqueName());
+        simulation->createInteraction(fields[i]->getUniqueName(), "output", kernels[i]->getUniqueName());
+        simulation->createInteraction(kernels[i]->getUniqueName(), "output", fields[i]->getUniqueName());
+    }
+    return simulation;
+}
+
+TEST_CASE("Simulation kernel batching", "[simulation]")
+{
+    constexpr int numberOfFields = 8;
+
+    SECTION("Kernels with equal parameters are batched and give the same results")
+    {
+        const auto batched = createFieldBank(numberOfFields, true);
+        const auto unbatched = createFieldBank(numberOfFields, true);
+        unbatched->setKernelBatching(false);
+        batched->init();
+        unbatched->init();
+
+        // one batch of Gauss kernels and one of Mexican hat kernels
+        REQUIRE(batched->getNumberOfKernelBatches() == 2);
+        REQUIRE(unbatched->getNumberOfKernelBatches() == 0);
+
+        for (int i = 0; i < 50; i++)
+        {
+            batched->step();
+            unbatched->step();
+        }
+        for (int i = 0; i < numberOfFields; i++)
+        {
+            REQUIRE(batched->getComponent("field " + std::to_string(i), "activation") == unbatched->getComponent("field " + std::to_string(i), "activation"));
+            REQUIRE(batched->getComponent("kernel " + std::to_string(i), "output") == unbatched->getComponent("kernel " + std::to_string(i), "output"));
+        }
+    }
+
+    SECTION("Batches of non-circular and border compensated kernels give the same results")
+    {
+        const auto batched = createFieldBank(numberOfFields, true);
+        const auto unbatched = createFieldBank(numberOfFields, true);
+        unbatched->setKernelBatching(false);
+        for (const auto& simulation : { batched, unbatched })
+            for (int i = 0; i < numberOfFields; i++)
+            {
+                const auto kernel = std::dynamic_pointer_cast<dnf_composer::element::Kernel>(simulation->getElement("kernel " + std::to_string(i)));
+                kernel->setCircular(false);
+                kernel->setBorderCompensation(i < numberOfFields / 2);
+            }
+        batched->init();
+        unbatched->init();
+        REQUIRE(batched->getNumberOfKernelBatches() == 4);
+
+        for (int i = 0; i < 50; i++)
+        {
+            batched->step();
+            unbatched->step();
+        }
+        for (int i = 0; i < numberOfFields; i++)
+            REQUIRE(batched->getComponent("kernel " + std::to_string(i), "output") == unbatched->getComponent("kernel " + std::to_string(i), "output"));
+    }
+
+    SECTION("Kernels are not batched across elements they depend on")
+    {
+        const auto interleaved = createFieldBank(numberOfFields, false);
+        interleaved->init();
+        REQUIRE(interleaved->getNumberOfKernelBatches() == 0);
+    }
+
+    SECTION("Batches follow parameter and topology changes")
+    {
+        const auto simulation = createFieldBank(numberOfFields, true);
+        simulation->init();
+        REQUIRE(simulation->getNumberOfKernelBatches() == 2);
+
+        // kernel 0 gets its own data, the remaining three Gauss kernels still form a batch
+        const auto kernel = std::dynamic_pointer_cast<dnf_composer::element::GaussKernel>(simulation->getElement("kernel 0"));
+        kernel->setParameters({ 5, 15, -0.5 });
+        simulation->step();
+        REQUIRE(simulation->getNumberOfKernelBatches() == 2);
+
+        simulation->removeElement("kernel 2");
+        simulation->removeElement("kernel 4");
+        REQUIRE(simulation->getNumberOfKernelBatches() == 1);
+
+        kernel->setConvolutionMethod(dnf_composer::element::ConvolutionMethod::RECURSIVE);
+        simulation->removeElement("kernel 1");
+        simulation->removeElement("kernel 3");
+        simulation->removeElement("kernel 5");
+        REQUIRE(simulation->getNumberOfKernelBatches() == 0);
+        simulation->step();
+    }
+}
+
+TEST_CASE("Simulation compiled execution", "[simulation]")
+{
+    using namespace dnf_composer;
+    constexpr int numberOfFields = 6;
+    const auto compiled = createFieldBank(numberOfFields, true);
+    const auto interpreted = createFieldBank(numberOfFields, true);
+    // a noise source exercises the fallback to Element::step, its gain the weighted input sum
+    for (const auto& simulation : { compiled, interpreted })
+    {
+        const auto noise = std::make_shared<element::NormalNoise>(element::ElementCommonParameters{ "noise", 100 }, element::NormalNoiseParameters{ 0.1 });
+        noise->setSeed(11);
+        simulation->addElement(noise);
+        simulation->createInteraction("noise", "output", "field 0", 0.5);
+        simulation->init();
+    }
+
+    REQUIRE_FALSE(compiled->isCompiled());
+    REQUIRE(compiled->getExecutionPlan() == nullptr);
+    compiled->compile();
+    REQUIRE(compiled->isCompiled());
+
+    // six fields, two kernel batches, six stimuli and the noise
+    const ExecutionPlan* plan = compiled->getExecutionPlan();
+    REQUIRE(plan != nullptr);
+    REQUIRE(plan->getOperations().size() == 15);
+    REQUIRE(std::ranges::count_if(plan->getOperations(), [](const auto& operation) { return operation.kind == ExecutionPlan::OperationKind::NEURAL_FIELD; }) == numberOfFields);
+    REQUIRE(std::ranges::count_if(plan->getOperations(), [](const auto& operation) { return operation.kind == ExecutionPlan::OperationKind::KERNEL_BATCH; }) == 2);
+
+    const auto requireSameState = [&]()
+        {
+            for (int i = 0; i < numberOfFields; i++)
+            {
+                const auto expected = interpreted->getComponent("field " + std::to_string(i), "activation");
+                const auto actual = compiled->getComponent("field " + std::to_string(i), "activation");
+                // inputs are summed in the same order, so the plan computes the same values
+                REQUIRE(actual == expected);
+            }
+        };
+
+    for (int i = 0; i < 30; i++)
+    {
+        compiled->step();
+        interpreted->step();
+    }
+    requireSameState();
+
+    // edits through the simulation rebuild the plan before the next step
+    for (const auto& simulation : { compiled, interpreted })
+    {
+        simulation->removeElement("kernel 2");
+        simulation->removeInteraction("stimulus 1", "field 1");
+    }
+    for (int i = 0; i < 30; i++)
+    {
+        compiled->step();
+        interpreted->step();
+    }
+    // kernel 0 and kernel 4 still form a batch
+    REQUIRE(compiled->getExecutionPlan()->getOperations().size() == 15);
+    requireSameState();
+
+    // so do connections and gains changed directly on the elements
+    for (const auto& simulation : { compiled, interpreted })
+    {
+        const auto field = simulation->getElement("field 3");
+        field->addInput(simulation->getElement("stimulus 1"));
+        REQUIRE(field->setInputGain("stimulus 3", 2.0));
+    }
+    for (int i = 0; i < 30; i++)
+    {
+        compiled->step();
+        interpreted->step();
+    }
+    requireSameState();
+    for (const auto& simulation : { compiled, interpreted })
+        REQUIRE(simulation->getElement("field 4")->setInputGain("stimulus 4", 0.5));
+    compiled->step();
+    interpreted->step();
+    requireSameState();
+
+    compiled->decompile();
+    REQUIRE(compiled->getExecutionPlan() == nullptr);
+    compiled->step();
+}
+
+TEST_CASE("Simulation delayed interactions", "[simulation]")
+{
+    using namespace dnf_composer;
+    constexpr int delay = 3;
+    for (const bool compile : { false, true })
+    {
+        const auto simulation = createSettlingSimulation();
+        simulation->addElement(createSampleElement("delayed"));
+        simulation->createInteraction("field", "output", "delayed", 2.0, delay);
+        simulation->init();
+        if (compile)
+            simulation->compile();
+
+        // the delayed field reads the output of the field as it was at the end of the step delay steps back,
+        // the initial output before that
+        std::vector<std::vector<double>> history{ simulation->getComponent("field", "output") };
+        for (int step = 1; step <= 10; step++)
+        {
+            simulation->step();
+            history.push_back(simulation->getComponent("field", "output"));
+            const std::vector<double>& source = history[std::max(0, step - delay)];
+            const std::vector<double> input = simulation->getComponent("delayed", "input");
+            for (size_t i = 0; i < input.size(); i++)
+                REQUIRE(input[i] == 2.0 * source[i]);
+        }
+    }
+
+    SECTION("Delays break the dependencies between operations")
+    {
+        const auto simulation = std::make_shared<Simulation>(1, 0, 0);
+        simulation->addElement(createSampleElement("a"));
+        simulation->addElement(createSampleElement("b"));
+        simulation->createInteraction("a", "output", "b");
+        simulation->createInteraction("b", "output", "a");
+        simulation->init();
+        simulation->compile();
+        REQUIRE(simulation->getExecutionPlan()->getNumberOfStages() == 2);
+
+        simulation->removeInteraction("a", "b");
+        simulation->removeInteraction("b", "a");
+        simulation->createInteraction("a", "output", "b", 1.0, 1);
+        simulation->createInteraction("b", "output", "a", 1.0, 2);
+        simulation->step();
+        REQUIRE(simulation->getExecutionPlan()->getNumberOfStages() == 1);
+    }
+
+    SECTION("Removing delayed interactions releases the delay line")
+    {
+        const auto simulation = std::make_shared<Simulation>(1, 0, 0);
+        simulation->addElement(createSampleElement("a"));
+        simulation->addElement(createSampleElement("b"));
+        simulation->addElement(createSampleElement("c"));
+        simulation->createInteraction("a", "output", "b", 1.0, 3);
+        simulation->createInteraction("a", "output", "c", 1.0, 1);
+        simulation->init();
+        const auto a = simulation->getElement("a");
+        REQUIRE(a->getDelayLine("output")->getMaxDelay() == 3);
+
+        simulation->removeInteraction("a", "b");
+        REQUIRE(a->getDelayLine("output")->getMaxDelay() == 1);
+        simulation->step();
+        simulation->removeInteraction("a", "c");
+        REQUIRE(a->getDelayLine("output") == nullptr);
+        REQUIRE_FALSE(a->hasDelayLines());
+    }
+}
@@ -0,0 +1,96 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+
+#include <sstream>
+
+#include "simulation/simulation_code_generator.h"
+#include "elements/field_coupling.h"
+
+#include "reference_architecture.h"
+// written by generate_reference_architecture at build time
+#include "generated_reference_architecture.h"
+
+TEST_CASE("SimulationCodeGenerator", "[simulation_code_generator]")
+{
+    using namespace dnf_composer;
+    const std::vector<std::pair<std::string, std::string>> components = {
+        { "field u", "activation" }, { "field u", "output" }, { "u -> u", "output" },
+        { "noise", "output" }, { "u -> v", "output" }, { "field v", "activation" }, { "field v", "input" }
+    };
+
+    SECTION("Generated code follows the compiled simulation exactly")
+    {
+        const auto simulation = createReferenceArchitecture();
+        dnf_generated::ReferenceArchitecture architecture;
+        REQUIRE(architecture.time() == simulation->t);
+        REQUIRE(architecture.read("missing", "output").empty());
+        REQUIRE(architecture.centroid("stimulus") == -1.0);
+
+        for (int i = 0; i < 100; i++)
+        {
+            simulation->step();
+            architecture.step();
+            for (const auto& [element, component] : components)
+            {
+                const std::vector<double> expected = simulation->getComponent(element, component);
+                const std::span<const double> actual = architecture.read(element, component);
+                REQUIRE(actual.size() == expected.size());
+                REQUIRE(std::equal(actual.begin(), actual.end(), expected.begin()));
+            }
+        }
+        REQUIRE(architecture.time() == simulation->t);
+        const auto field = std::dynamic_pointer_cast<element::NeuralField>(simulation->getElement("field u"));
+        REQUIRE(field->getCentroid() > 0.0);
+        REQUIRE(architecture.centroid("field u") == field->getCentroid());
+    }
+
+    SECTION("Generated code follows the interpreted simulation")
+    {
+        const auto simulation = createReferenceArchitecture();
+        simulation->decompile();
+        dnf_generated::ReferenceArchitecture architecture;
+        for (int i = 0; i < 100; i++)
+        {
+            simulation->step();
+            architecture.step();
+        }
+        for (const auto& [element, component] : components)
+        {
+            const std::vector<double> expected = simulation->getComponent(element, component);
+            const std::span<const double> actual = architecture.read(element, component);
+            for (size_t j = 0; j < expected.size(); j++)
+                REQUIRE(actual[j] == Catch::Approx(expected[j]).margin(1e-9));
+        }
+    }
+
+    SECTION("Reset returns to the state at generation time")
+    {
+        dnf_generated::ReferenceArchitecture architecture;
+        const std::vector<double> initial(architecture.read("field u", "activation").begin(), architecture.read("field u", "activation").end());
+        for (int i = 0; i < 10; i++)
+            architecture.step();
+        REQUIRE_FALSE(std::ranges::equal(initial, architecture.read("field u", "activation")));
+        architecture.reset();
+        REQUIRE(std::ranges::equal(initial, architecture.read("field u", "activation")));
+        REQUIRE(architecture.time() == 20.0);
+    }
+
+    SECTION("Generated code is deterministic")
+    {
+        std::ostringstream first, second;
+        REQUIRE(SimulationCodeGenerator(createReferenceArchitecture()).generate(first));
+        REQUIRE(SimulationCodeGenerator(createReferenceArchitecture()).generate(second));
+        REQUIRE(first.str() == second.str());
+        REQUIRE(first.str().find("class Architecture") != std::string::npos);
+    }
+
+    SECTION("Unsupported elements are rejected")
+    {
+        const auto simulation = createReferenceArchitecture();
+        simulation->addElement(std::make_shared<element::FieldCoupling>(element::ElementCommonParameters{ "coupling", 100 },
+            element::FieldCouplingParameters{ 100, 1.0, 0.1, LearningRule::HEBBIAN }));
+        std::ostringstream code;
+        REQUIRE_FALSE(SimulationCodeGenerator(simulation).generate(code));
+        REQUIRE_THROWS_AS(SimulationCodeGenerator(nullptr), Exception);
+    }
+}
@@ -0,0 +1,135 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+
+#include "simulation/simulation.h"
+#include "elements/static_neural_field.h"
+#include "elements/static_gauss_kernel.h"
+#include "elements/gauss_stimulus.h"
+#include "elements/field_coupling.h"
+
+static constexpr int staticFieldSize = 30;
+
+// A field with a self-excitation kernel, read by a second field through a dynamic kernel.
+static std::shared_ptr<dnf_composer::Simulation> createSmallArchitecture(bool useStaticElements)
+{
+    using namespace dnf_composer::element;
+    auto simulation = std::make_shared<dnf_composer::Simulation>(1, 0, 0);
+    const NeuralFieldParameters fieldParameters{ 10, -4, SigmoidFunction{ 0, 4 } };
+    const GaussKernelParameters kernelParameters{ 2, 6, -0.3 };
+    if (useStaticElements)
+    {
+        simulation->addElement(std::make_shared<StaticNeuralField<staticFieldSize>>(ElementCommonParameters{ "field", staticFieldSize }, fieldParameters));
+        simulation->addElement(std::make_shared<StaticGaussKernel<staticFieldSize, 12>>(ElementCommonParameters{ "self", staticFieldSize }, kernelParameters));
+    }
+    else
+    {
+        simulation->addElement(std::make_shared<NeuralField>(ElementCommonParameters{ "field", staticFieldSize }, fieldParameters));
+        simulation->addElement(std::make_shared<GaussKernel>(ElementCommonParameters{ "self", staticFieldSize }, kernelParameters));
+    }
+    simulation->addElement(std::make_shared<GaussStimulus>(ElementCommonParameters{ "stimulus", staticFieldSize }, GaussStimulusParameters{ 2, 7, 27 }));
+    simulation->addElement(std::make_shared<GaussKernel>(ElementCommonParameters{ "projection", staticFieldSize }, GaussKernelParameters{ 3, 4, 0 }));
+    simulation->addElement(std::make_shared<NeuralField>(ElementCommonParameters{ "readout", staticFieldSize }, NeuralFieldParameters{ 5, -2, HeavisideFunction{ 0 } }));
+
+    simulation->createInteraction("stimulus", "output", "field");
+    simulation->createInteraction("self", "output", "field");
+    simulation->createInteraction("field", "output", "self");
+    simulation->createInteraction("field", "output", "projection");
+    simulation->createInteraction("projection", "output", "readout");
+    simulation->init();
+    return simulation;
+}
+
+TEST_CASE("Static elements", "[static_elements]")
+{
+    using namespace dnf_composer;
+
+    SECTION("Static elements follow their dynamic counterparts exactly")
+    {
+        for (const bool compiled : { false, true })
+        {
+            const auto reference = createSmallArchitecture(false);
+            const auto simulation = createSmallArchitecture(true);
+            if (compiled)
+            {
+                simulation->compile();
+                // the static field is a neural field to the plan as well, and takes its fused update
+                const auto& operations = simulation->getExecutionPlan()->getOperations();
+                REQUIRE(std::ranges::count_if(operations, [](const auto& operation) { return operation.kind == ExecutionPlan::OperationKind::NEURAL_FIELD; }) == 2);
+            }
+
+            REQUIRE(simulation->getComponent("self", "kernel") == reference->getComponent("self", "kernel"));
+            for (int i = 0; i < 100; i++)
+            {
+                reference->step();
+                simulation->step();
+                for (const std::string element : { "field", "self", "projection", "readout" })
+                    REQUIRE(simulation->getComponent(element, "output") == reference->getComponent(element, "output"));
+                REQUIRE(simulation->getComponent("field", "activation") == reference->getComponent("field", "activation"));
+            }
+            const auto field = std::dynamic_pointer_cast<element::NeuralField>(simulation->getElement("field"));
+            REQUIRE(field->getCentroid() > 0.0);
+            REQUIRE(field->getCentroid() == std::dynamic_pointer_cast<element::NeuralField>(reference->getElement("field"))->getCentroid());
+        }
+    }
+
+    SECTION("Inputs can change between steps")
+    {
+        const auto reference = createSmallArchitecture(false);
+        const auto simulation = createSmallArchitecture(true);
+        for (const auto& architecture : { reference, simulation })
+        {
+            architecture->step();
+            architecture->removeInteraction("stimulus", "field");
+            architecture->step();
+            architecture->createInteraction("stimulus", "output", "self");
+            architecture->step();
+        }
+        REQUIRE(simulation->getComponent("field", "activation") == reference->getComponent("field", "activation"));
+        REQUIRE(simulation->getComponent("self", "output") == reference->getComponent("self", "output"));
+    }
+
+    SECTION("Clones step on their own buffers")
+    {
+        const auto simulation = createSmallArchitecture(true);
+        const auto original = simulation->getElement("field");
+        original->step(0, 1);
+        const auto clone = original->clone();
+        REQUIRE(std::dynamic_pointer_cast<element::StaticNeuralField<staticFieldSize>>(clone) != nullptr);
+        REQUIRE(clone->getComponent("activation") == original->getComponent("activation"));
+        const std::vector<double> activation = original->getComponent("activation");
+        clone->step(1, 1);
+        REQUIRE(original->getComponent("activation") == activation);
+        REQUIRE(clone->getComponent("activation") != activation);
+    }
+
+    SECTION("Sizes and radii are checked")
+    {
+        using namespace element;
+        const NeuralFieldParameters fieldParameters{ 10, -4, SigmoidFunction{ 0, 4 } };
+        REQUIRE_THROWS_AS((StaticNeuralField<10>(ElementCommonParameters{ "field", 20 }, fieldParameters)), Exception);
+        REQUIRE_THROWS_AS((StaticGaussKernel<10, 4>(ElementCommonParameters{ "kernel", 20 }, GaussKernelParameters{ 1, 1, 0 })), Exception);
+        // sigma 1 needs a radius of 5 on a large enough field
+        REQUIRE_THROWS_AS((StaticGaussKernel<20, 4>(ElementCommonParameters{ "kernel", 20 }, GaussKernelParameters{ 1, 1, 0 })), Exception);
+
+        StaticGaussKernel<20, 5> kernel(ElementCommonParameters{ "kernel", 20 }, GaussKernelParameters{ 1, 1, 0 });
+        kernel.init();
+        REQUIRE(kernel.getKernelRange() == std::array<int, 2>{ 5, 5 });
+        kernel.setParameters({ 2, 1, 0 });
+        REQUIRE(kernel.getParameters().sigma == 1);
+        kernel.setParameters({ 0.8, 1, 0 });
+        REQUIRE(kernel.getKernelRange() == std::array<int, 2>{ 4, 4 });
+
+        // an input of another size is reported by init() and the kernel is not stepped
+        const auto coupling = std::make_shared<FieldCoupling>(ElementCommonParameters{ "coupling", 20 }, FieldCouplingParameters{ 30, 1.0, 0.01, LearningRule::HEBBIAN });
+        const auto stimulus = std::make_shared<GaussStimulus>(ElementCommonParameters{ "stimulus", 20 }, GaussStimulusParameters{ 2, 5, 10 });
+        stimulus->init();
+        kernel.addInput(stimulus);
+        kernel.addInput(coupling, "input");
+        kernel.init();
+        kernel.step(0, 1);
+        REQUIRE(kernel.getComponent("output") == std::vector<double>(20, 0.0));
+        kernel.removeInput("coupling");
+        kernel.step(0, 1);
+        REQUIRE(kernel.getComponent("output") != std::vector<double>(20, 0.0));
+    }
+}
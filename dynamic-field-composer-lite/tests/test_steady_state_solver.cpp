@@ -0,0 +1,133 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+
+#include "simulation/steady_state_solver.h"
+#include "elements/gauss_kernel.h"
+#include "elements/gauss_stimulus.h"
+#include "elements/normal_noise.h"
+#include "elements/memory_trace.h"
+
+using namespace dnf_composer;
+
+static std::shared_ptr<Simulation> createSteadyStateSimulation(int kernelDelay = 0)
+{
+    using namespace dnf_composer::element;
+    auto simulation = std::make_shared<Simulation>(1, 0, 0);
+
+    const SigmoidFunction activationFunction{ 0, 4 };
+    const auto field = std::make_shared<NeuralField>(ElementCommonParameters{ "field", 100 }, NeuralFieldParameters{ 20, -5, activationFunction });
+    const auto kernel = std::make_shared<GaussKernel>(ElementCommonParameters{ "kernel", 100 }, GaussKernelParameters{ 3, 8, -0.2 });
+    const auto stimulus = std::make_shared<GaussStimulus>(ElementCommonParameters{ "stimulus", 100 }, GaussStimulusParameters{ 3, 8, 40 });
+    const auto noise = std::make_shared<NormalNoise>(ElementCommonParameters{ "noise", 100 }, NormalNoiseParameters{ 0.01 });
+
+    simulation->addElement(field);
+    simulation->addElement(kernel);
+    simulation->addElement(stimulus);
+    simulation->addElement(noise);
+    field->addInput(kernel);
+    field->addInput(stimulus);
+    field->addInput(noise);
+    kernel->addInput(field, "output", 1.0, kernelDelay);
+    simulation->init();
+    return simulation;
+}
+
+TEST_CASE("SteadyStateSolver", "[SteadyStateSolver]")
+{
+    SECTION("Invalid parameters")
+    {
+        REQUIRE_THROWS_AS(SteadyStateSolver(nullptr), Exception);
+        REQUIRE_THROWS_AS(SteadyStateSolver(createSteadyStateSimulation(), { 1e-6, 100, 0.0, 5 }), Exception);
+        REQUIRE_THROWS_AS(SteadyStateSolver(createSteadyStateSimulation(), { 1e-6, 0, 0.5, 5 }), Exception);
+
+        // rejected the same way after construction, the previous parameters are kept
+        SteadyStateSolver solver(createSteadyStateSimulation(), { 1e-6, 100, 0.5, 5 });
+        solver.setParameters({ 1e-6, 100, 0.0, 5 });
+        solver.setParameters({ 1e-6, 0, 0.5, 5 });
+        REQUIRE(solver.getParameters().damping == 0.5);
+        REQUIRE(solver.getParameters().maxIterations == 100);
+        solver.setParameters({ 1e-8, 200, 1.0, 0 });
+        REQUIRE(solver.getParameters().maxIterations == 200);
+    }
+
+    SECTION("Fixed point matches the settled Euler integration")
+    {
+        const auto integrated = createSteadyStateSimulation();
+        integrated->removeElement("noise");
+        for (int i = 0; i < 3000; i++)
+            integrated->step();
+
+        const auto solved = createSteadyStateSimulation();
+        SteadyStateSolver solver(solved, { 1e-9, 500, 0.5, 5 });
+        const SteadyStateResult result = solver.solve();
+        REQUIRE(result.converged);
+        REQUIRE(result.residual <= 1e-9);
+        REQUIRE(result.iterations < 500);
+        REQUIRE(solved->t == Catch::Approx(0.0));
+
+        const auto expected = integrated->getComponent("field", "activation");
+        const auto activation = solved->getComponent("field", "activation");
+        for (size_t i = 0; i < expected.size(); i++)
+            REQUIRE(activation[i] == Catch::Approx(expected[i]).margin(1e-6));
+
+        // the fixed point is a steady state of the time stepping
+        const auto field = std::dynamic_pointer_cast<element::NeuralField>(solved->getElement("field"));
+        solved->removeElement("noise");
+        solved->step();
+        REQUIRE(field->getMaxActivationChange() < 1e-6);
+    }
+
+    SECTION("Delayed connections reach the fixed point of the undelayed ones")
+    {
+        const auto undelayed = createSteadyStateSimulation();
+        REQUIRE(SteadyStateSolver(undelayed, { 1e-9, 500, 0.5, 5 }).solve().converged);
+
+        const auto delayed = createSteadyStateSimulation(1);
+        REQUIRE(SteadyStateSolver(delayed, { 1e-9, 500, 0.5, 5 }).solve().converged);
+
+        const auto expected = undelayed->getComponent("field", "activation");
+        const auto activation = delayed->getComponent("field", "activation");
+        for (size_t i = 0; i < expected.size(); i++)
+            REQUIRE(activation[i] == Catch::Approx(expected[i]).margin(1e-6));
+
+        // the delay lines hold the fixed point, so stepping on stays there
+        delayed->removeElement("noise");
+        delayed->step();
+        const auto field = std::dynamic_pointer_cast<element::NeuralField>(delayed->getElement("field"));
+        REQUIRE(field->getMaxActivationChange() < 1e-6);
+    }
+
+    SECTION("Elements with a state of their own are not stepped")
+    {
+        using namespace dnf_composer::element;
+        const auto simulation = createSteadyStateSimulation();
+        const auto trace = std::make_shared<MemoryTrace>(ElementCommonParameters{ "trace", 100 }, MemoryTraceParameters{ 10.0, 50.0, 0.5 });
+        simulation->addElement(trace);
+        simulation->createInteraction("field", "output", "trace");
+        simulation->createInteraction("trace", "output", "field");
+        simulation->init();
+
+        // the stimulus drives the field above the threshold of the trace, stepping it would build a trace
+        REQUIRE(SteadyStateSolver(simulation, { 1e-9, 500, 0.5, 5 }).solve().converged);
+        REQUIRE(simulation->getComponent("field", "output")[40] > 0.5);
+        REQUIRE(trace->getNumberOfTraceBins() == 0);
+        REQUIRE(std::ranges::all_of(trace->getComponent("output"), [](double value) { return value == 0.0; }));
+    }
+
+    SECTION("Acceleration needs fewer iterations than damped iteration")
+    {
+        const SteadyStateResult damped = SteadyStateSolver(createSteadyStateSimulation(), { 1e-8, 2000, 0.5, 0 }).solve();
+        const SteadyStateResult accelerated = SteadyStateSolver(createSteadyStateSimulation(), { 1e-8, 2000, 0.5, 5 }).solve();
+        REQUIRE(damped.converged);
+        REQUIRE(accelerated.converged);
+        REQUIRE(accelerated.iterations < damped.iterations);
+    }
+
+    SECTION("Failure to converge is reported")
+    {
+        const SteadyStateResult result = SteadyStateSolver(createSteadyStateSimulation(), { 1e-12, 2, 0.5, 5 }).solve();
+        REQUIRE_FALSE(result.converged);
+        REQUIRE(result.iterations == 2);
+        REQUIRE(result.residual > 1e-12);
+    }
+}